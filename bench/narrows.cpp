@@ -0,0 +1,375 @@
+// Throughput and round trip latency of every channel backend, run through the same harness and
+// written to stdout as JSON.
+//
+//     narrows_bench [--quick] [--messages N] [--samples N] [--filter backend]
+//
+// Throughput runs cover SPSC, MPSC, SPMC and MPMC over every payload size and capacity below.
+// Latency runs bounce one value at a time between two threads over a pair of channels. Threads
+// are pinned to cores where the platform allows it, thread i to core i modulo the core count.
+
+#include "narrows/bounded.hpp"
+#include "narrows/single_bounded.hpp"
+#include "narrows/unbounded.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+constexpr std::array<std::size_t, 2> capacities{ 64U, 1024U };
+constexpr std::array<std::size_t, 2> thread_counts{ 2U, 4U };
+
+// a value of N bytes, the first 8 carry a sequence number the receivers add up
+template<std::size_t N>
+struct payload
+{
+    static_assert(N >= sizeof(std::uint64_t), "A payload carries at least its sequence number");
+
+    std::uint64_t sequence{ 0U };
+    std::array<std::byte, N - sizeof(std::uint64_t)> data{};
+};
+
+// Backends only differ in how a channel is made and whether more than one thread may use an end
+struct bounded_backend
+{
+    constexpr static std::string_view name = "bounded_channel";
+    constexpr static bool shared = true;
+
+    template<typename T>
+    static auto make(const std::size_t capacity)
+    {
+        return nrws::bounded<T, nrws::bounded_channel>(capacity);
+    }
+};
+
+struct array_backend
+{
+    constexpr static std::string_view name = "array_channel";
+    constexpr static bool shared = true;
+
+    template<typename T>
+    static auto make(const std::size_t capacity)
+    {
+        return nrws::bounded<T, nrws::array_channel>(capacity);
+    }
+};
+
+struct striped_backend
+{
+    constexpr static std::string_view name = "striped_channel";
+    constexpr static bool shared = true;
+
+    template<typename T>
+    static auto make(const std::size_t capacity)
+    {
+        return nrws::bounded<T, nrws::striped_channel>(capacity);
+    }
+};
+
+// unbounded, the capacity is ignored
+struct list_backend
+{
+    constexpr static std::string_view name = "channel";
+    constexpr static bool shared = true;
+
+    template<typename T>
+    static auto make(const std::size_t /*capacity*/)
+    {
+        return nrws::unbounded<T, nrws::channel>();
+    }
+};
+
+// single producer/single consumer only
+struct spsc_backend
+{
+    constexpr static std::string_view name = "single::bounded";
+    constexpr static bool shared = false;
+
+    template<typename T>
+    static auto make(const std::size_t capacity)
+    {
+        return nrws::single::bounded<T>(capacity);
+    }
+};
+
+using backends = std::tuple<bounded_backend, list_backend, array_backend, striped_backend, spsc_backend>;
+
+struct options
+{
+    std::size_t messages{ 200'000U };
+    std::size_t samples{ 20'000U };
+    std::string filter;
+};
+
+struct throughput_result
+{
+    std::string_view backend;
+    std::string_view topology;
+    std::size_t producers;
+    std::size_t consumers;
+    std::size_t payload;
+    std::size_t capacity;
+    std::size_t messages;
+    double seconds;
+};
+
+struct latency_result
+{
+    std::string_view backend;
+    std::size_t payload;
+    std::size_t capacity;
+    std::size_t samples;
+    double p50;
+    double p99;
+    double p999;
+};
+
+// pins a thread to a core, false where that isn't supported
+auto pin(std::thread &thread, const std::size_t index) -> bool
+{
+#if defined(__linux__)
+    const auto cores = std::max(std::thread::hardware_concurrency(), 1U);
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(index % cores, &set);
+    return pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) == 0;
+#else
+    static_cast<void>(thread);
+    static_cast<void>(index);
+    return false;
+#endif
+}
+
+auto seconds_since(const std::chrono::steady_clock::time_point start) -> double
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+auto topology(const std::size_t producers, const std::size_t consumers) -> std::string_view
+{
+    if (producers == 1U) { return consumers == 1U ? "spsc" : "spmc"; }
+    return consumers == 1U ? "mpsc" : "mpmc";
+}
+
+// every producer sends its share of messages, the consumers receive until the channel is closed.
+// The clock starts once every thread is running.
+template<typename Backend, std::size_t N>
+auto throughput(const std::size_t producers,
+    const std::size_t consumers,
+    const std::size_t capacity,
+    const std::size_t messages,
+    bool &pinned) -> throughput_result
+{
+    auto [s, r] = Backend::template make<payload<N>>(capacity);
+    const auto share = messages / producers;
+
+    std::atomic<std::size_t> ready{ 0U };
+    std::atomic<bool> go{ false };
+    std::atomic<std::uint64_t> received{ 0U };
+    std::atomic<std::uint64_t> checksum{ 0U };
+    const auto wait_for_start = [&]() {
+        ready++;
+        while (!go.load(std::memory_order_acquire)) { std::this_thread::yield(); }
+    };
+
+    // the ends are shared by reference, only the channel behind them is touched concurrently
+    std::vector<std::thread> consumer_threads;
+    for (std::size_t c = 0U; c < consumers; c++) {
+        consumer_threads.emplace_back([&]() {
+            wait_for_start();
+            std::uint64_t count = 0U;
+            std::uint64_t sum = 0U;
+            while (auto value = r.receive()) {
+                sum += value->sequence;
+                count++;
+            }
+            received += count;
+            checksum += sum;
+        });
+        pinned &= pin(consumer_threads.back(), c);
+    }
+
+    std::vector<std::thread> producer_threads;
+    for (std::size_t p = 0U; p < producers; p++) {
+        producer_threads.emplace_back([&]() {
+            wait_for_start();
+            payload<N> value;
+            for (std::size_t i = 0U; i < share; i++) {
+                value.sequence = i + 1U;
+                static_cast<void>(s.send(value));
+            }
+        });
+        pinned &= pin(producer_threads.back(), consumers + p);
+    }
+
+    while (ready.load() != producers + consumers) { std::this_thread::yield(); }
+    const auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+
+    for (auto &thread : producer_threads) { thread.join(); }
+    s.close();
+    for (auto &thread : consumer_threads) { thread.join(); }
+    const auto elapsed = seconds_since(start);
+
+    // every producer sends the sequence numbers 1 to share
+    const auto sent = share * producers;
+    if (received.load() != sent || checksum.load() != producers * share * (share + 1U) / 2U) {
+        std::fprintf(stderr, "%s lost or mixed up values: sent %zu, received %llu\n", Backend::name.data(), sent,
+            static_cast<unsigned long long>(received.load()));
+    }
+
+    return { Backend::name, topology(producers, consumers), producers, consumers, N, capacity, sent, elapsed };
+}
+
+// one value in flight, bounced off an echo thread
+template<typename Backend, std::size_t N>
+auto latency(const std::size_t capacity, const std::size_t samples, bool &pinned) -> latency_result
+{
+    auto [ping_s, ping_r] = Backend::template make<payload<N>>(capacity);
+    auto [pong_s, pong_r] = Backend::template make<payload<N>>(capacity);
+
+    std::thread echo([&]() {
+        while (auto value = ping_r.receive()) { static_cast<void>(pong_s.send(std::move(*value))); }
+        pong_s.close();
+    });
+    pinned &= pin(echo, 1U);
+
+    std::vector<double> round_trips;
+    round_trips.reserve(samples);
+
+    // the first tenth warms up caches and lets the threads settle
+    const auto warmup = samples / 10U;
+    payload<N> value;
+    for (std::size_t i = 0U; i < warmup + samples; i++) {
+        value.sequence = i;
+        const auto start = std::chrono::steady_clock::now();
+        static_cast<void>(ping_s.send(value));
+        static_cast<void>(pong_r.receive());
+        const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+        if (i >= warmup) { round_trips.push_back(elapsed.count()); }
+    }
+
+    ping_s.close();
+    echo.join();
+
+    std::ranges::sort(round_trips);
+    const auto percentile = [&](const double p) {
+        const auto index = static_cast<std::size_t>(p * static_cast<double>(round_trips.size() - 1U));
+        return round_trips[index];
+    };
+    return { Backend::name, N, capacity, samples, percentile(0.5), percentile(0.99), percentile(0.999) };
+}
+
+template<typename Backend>
+auto run_backend(const options &opts,
+    std::vector<throughput_result> &throughputs,
+    std::vector<latency_result> &latencies,
+    bool &pinned) -> void
+{
+    if (!opts.filter.empty() && Backend::name.find(opts.filter) == std::string_view::npos) { return; }
+
+    const auto run_payload = [&]<std::size_t N>() {
+        for (const auto capacity : capacities) {
+            throughputs.push_back(throughput<Backend, N>(1U, 1U, capacity, opts.messages, pinned));
+            if constexpr (Backend::shared) {
+                for (const auto threads : thread_counts) {
+                    throughputs.push_back(throughput<Backend, N>(threads, 1U, capacity, opts.messages, pinned));
+                    throughputs.push_back(throughput<Backend, N>(1U, threads, capacity, opts.messages, pinned));
+                    throughputs.push_back(throughput<Backend, N>(threads, threads, capacity, opts.messages, pinned));
+                }
+            }
+            latencies.push_back(latency<Backend, N>(capacity, opts.samples, pinned));
+        }
+    };
+
+    run_payload.template operator()<8U>();
+    run_payload.template operator()<64U>();
+    run_payload.template operator()<512U>();
+    run_payload.template operator()<4096U>();
+}
+
+auto print_json(const options &opts,
+    const std::vector<throughput_result> &throughputs,
+    const std::vector<latency_result> &latencies,
+    const bool pinned) -> void
+{
+    std::printf("{\n");
+    std::printf("  \"hardware_concurrency\": %u,\n", std::thread::hardware_concurrency());
+    std::printf("  \"pinned\": %s,\n", pinned ? "true" : "false");
+    std::printf("  \"messages\": %zu,\n", opts.messages);
+
+    std::printf("  \"throughput\": [\n");
+    for (std::size_t i = 0U; i < throughputs.size(); i++) {
+        const auto &t = throughputs[i];
+        const auto per_second = static_cast<double>(t.messages) / t.seconds;
+        std::printf("    {\"backend\": \"%s\", \"topology\": \"%s\", \"producers\": %zu, \"consumers\": %zu, "
+                    "\"payload_bytes\": %zu, \"capacity\": %zu, \"messages_per_second\": %.0f, "
+                    "\"bytes_per_second\": %.0f}%s\n",
+            t.backend.data(), t.topology.data(), t.producers, t.consumers, t.payload, t.capacity, per_second,
+            per_second * static_cast<double>(t.payload), i + 1U < throughputs.size() ? "," : "");
+    }
+    std::printf("  ],\n");
+
+    std::printf("  \"latency\": [\n");
+    for (std::size_t i = 0U; i < latencies.size(); i++) {
+        const auto &l = latencies[i];
+        std::printf("    {\"backend\": \"%s\", \"payload_bytes\": %zu, \"capacity\": %zu, \"samples\": %zu, "
+                    "\"p50_ns\": %.0f, \"p99_ns\": %.0f, \"p999_ns\": %.0f}%s\n",
+            l.backend.data(), l.payload, l.capacity, l.samples, l.p50, l.p99, l.p999,
+            i + 1U < latencies.size() ? "," : "");
+    }
+    std::printf("  ]\n");
+    std::printf("}\n");
+}
+
+}// namespace
+
+auto main(int argc, char **argv) -> int
+{
+    options opts;
+    for (int i = 1; i < argc; i++) {
+        const std::string_view arg = argv[i];
+        const auto has_value = i + 1 < argc;
+        if (arg == "--quick") {
+            opts.messages = 20'000U;
+            opts.samples = 2'000U;
+        } else if (arg == "--messages" && has_value) {
+            opts.messages = std::stoul(argv[++i]);
+        } else if (arg == "--samples" && has_value) {
+            opts.samples = std::stoul(argv[++i]);
+        } else if (arg == "--filter" && has_value) {
+            opts.filter = argv[++i];
+        } else {
+            std::fprintf(stderr, "usage: %s [--quick] [--messages N] [--samples N] [--filter backend]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::vector<throughput_result> throughputs;
+    std::vector<latency_result> latencies;
+    bool pinned = true;
+
+    std::apply([&]<typename... Backend>(
+                   Backend...) { (run_backend<Backend>(opts, throughputs, latencies, pinned), ...); },
+        backends{});
+
+    print_json(opts, throughputs, latencies, pinned);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,90 @@
+// Per-task dispatch cost of a worker_pool against several threads iterating one Receiver.
+//
+//     worker_pool_bench [tasks] [max threads]
+
+#include "narrows/bounded.hpp"
+#include "narrows/single_bounded.hpp"
+#include "narrows/worker_pool.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// a tiny task, so the dispatch cost dominates
+inline auto work(std::uint64_t value) -> std::uint64_t
+{
+    for (int i = 0; i < 16; i++) { value = value * 6364136223846793005ULL + 1442695040888963407ULL; }
+    return value;
+}
+
+template<typename F>
+auto time_ns(F &&run) -> double
+{
+    const auto start = std::chrono::steady_clock::now();
+    run();
+    const auto stop = std::chrono::steady_clock::now();
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count());
+}
+
+// every worker pops the shared channel one value at a time
+auto iterate(const std::size_t tasks, const std::size_t threads) -> double
+{
+    std::atomic<std::uint64_t> sink{ 0U };
+
+    return time_ns([&]() {
+        auto [s, r] = nrws::bounded<std::uint64_t>(1024);
+
+        std::vector<std::thread> workers;
+        for (std::size_t t = 0U; t < threads; t++) {
+            workers.emplace_back([&sink, r]() mutable {
+                std::uint64_t local = 0U;
+                for (const auto value : r) { local += work(value); }
+                sink += local;
+            });
+        }
+
+        for (std::size_t i = 0U; i < tasks; i++) { static_cast<void>(s.send(i)); }
+        s.close();
+        for (auto &worker : workers) { worker.join(); }
+    });
+}
+
+auto pool(const std::size_t tasks, const std::size_t threads) -> double
+{
+    std::atomic<std::uint64_t> sink{ 0U };
+
+    return time_ns([&]() {
+        nrws::worker_pool<std::uint64_t> workers(
+            [&sink](std::uint64_t &&value) { sink.fetch_add(work(value), std::memory_order_relaxed); },
+            threads,
+            1024U);
+
+        for (std::size_t i = 0U; i < tasks; i++) { static_cast<void>(workers.submit(i)); }
+    });
+}
+
+}// namespace
+
+auto main(int argc, char **argv) -> int
+{
+    const std::size_t tasks = argc > 1 ? std::stoul(argv[1]) : 1'000'000U;
+    const std::size_t max_threads = argc > 2 ? std::stoul(argv[2]) : std::thread::hardware_concurrency();
+
+    std::printf("%8s %18s %18s\n", "threads", "iterator ns/task", "pool ns/task");
+    for (std::size_t threads = 1U; threads <= max_threads; threads *= 2U) {
+        const auto per_task = static_cast<double>(tasks);
+        const auto iterated = iterate(tasks, threads) / per_task;
+        const auto pooled = pool(tasks, threads) / per_task;
+        std::printf("%8zu %18.1f %18.1f\n", threads, iterated, pooled);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+
+namespace nrws {
+
+// Size used to keep independently written atomics from sharing a cache line. We don't use
+// std::hardware_destructive_interference_size since its value is allowed to change between
+// compiler versions, which would silently change the layout of every channel.
+inline constexpr std::size_t _cache_line_size = 64U;
+
+// Hint to the processor that we are in a spin loop
+inline auto _cpu_relax() noexcept -> void
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+// Smallest power of two that is greater than or equal to value
+[[nodiscard]] constexpr auto _next_power_of_two(std::size_t value) noexcept -> std::size_t
+{
+    std::size_t result = 1U;
+    while (result < value) { result <<= 1U; }
+    return result;
+}
+
+}// namespace nrws
@@ -0,0 +1,392 @@
+#pragma once
+
+#include "narrows/_internal/_arch.hpp"
+#include "narrows/_internal/_channel_ops.hpp"
+#include "narrows/wait.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace nrws {
+
+template<typename T, typename Order, typename Wait, typename Allocator>
+class _striped_channel;
+
+// Lock-free bounded multi producer/multi consumer queue.
+//
+// This is Dmitry Vyukov's bounded MPMC queue, also used by crossbeam's ArrayQueue. Positions
+// only ever grow, position `pos` lives in slot `pos % capacity` during lap `pos / capacity`. Every
+// slot carries a stamp that says which lap it is ready for: `2 * lap` once it is free to be
+// written and `2 * lap + 1` once it holds a value. A producer claims a free slot, writes it and
+// publishes it by bumping the stamp, a consumer claims a written slot, reads it and frees it for
+// the next lap. Producers and consumers only ever contend on their own index, and only wait, using
+// the Wait policy, when the queue is actually full or empty. Since every stamp starts at 0, the
+// slots need no initialization.
+//
+// With a static Extent the slots are stored inline and the capacity is a constant, so for a power
+// of two Extent finding a slot is a mask. Such a channel can be embedded in another object, and is
+// constexpr constructible when the waiter sets of its Wait policy are.
+template<typename T,
+    typename Wait = park_wait,
+    typename Allocator = std::allocator<std::decay_t<T>>,
+    std::size_t Extent = std::dynamic_extent>
+class _array_channel : public _channel_ops<_array_channel<T, Wait, Allocator, Extent>, T, Wait>
+{
+    using _base = _channel_ops<_array_channel<T, Wait, Allocator, Extent>, T, Wait>;
+    friend _base;
+
+    // uses array channels as its stripes
+    template<typename, typename, typename, typename>
+    friend class _striped_channel;
+
+  public:
+    using value_type = std::decay_t<T>;
+    using size_type = std::size_t;
+    using allocator_type = Allocator;
+
+    constexpr static size_type extent = Extent;
+
+    explicit _array_channel(const size_type capacity, const Allocator &alloc = Allocator())
+        requires(Extent == std::dynamic_extent);
+    constexpr _array_channel()
+        requires(Extent != std::dynamic_extent)
+    = default;
+    ~_array_channel();
+
+    _array_channel(const _array_channel &) = delete;
+    _array_channel &operator=(const _array_channel &) = delete;
+
+    // Channel status
+    [[nodiscard]] inline auto size() const noexcept -> size_type;
+    [[nodiscard]] inline auto empty() const noexcept -> bool;
+    [[nodiscard]] inline auto full() const noexcept -> bool;
+    [[nodiscard]] constexpr auto capacity() const noexcept -> size_type;
+
+  private:
+    struct _slot
+    {
+        std::atomic<size_type> stamp{ 0U };
+        [[no_unique_address]] typename _base::_entry_time_type entered{};
+        alignas(value_type) std::byte data[sizeof(value_type)];
+    };
+
+    // where a position lives
+    struct _place
+    {
+        _slot *slot;
+        size_type free;// stamp of the slot while it is free during this lap, +1 once written
+    };
+
+    struct _handle
+    {
+        value_type *value;
+        _slot *slot;
+        size_type free;
+    };
+
+    constexpr static bool _inline = Extent != std::dynamic_extent;
+
+    using _slot_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<_slot>;
+    using _slot_traits = std::allocator_traits<_slot_allocator>;
+    using _storage = std::conditional_t<_inline, std::array<_slot, _inline ? Extent : 1U>, _slot *>;
+
+    constexpr static bool _bounded = true;
+
+    template<typename... Args>
+    inline auto _try_reserve(Args &&...args) -> std::optional<_handle>;
+    inline auto _commit(_handle &&handle) -> void;
+    inline auto _try_acquire() -> std::optional<_handle>;
+    inline auto _release(_handle &&handle) -> void;
+
+    template<typename It, typename S>
+    inline auto _try_push_many(It &first, const S &last) -> size_type;
+    template<typename Out>
+    inline auto _try_pop_many(Out &out, const size_type max) -> size_type;
+
+    // the index of the slot holding the value at the front, if there is one. Only a hint when
+    // there are several consumers, one of them may take it right after.
+    [[nodiscard]] inline auto _front() const noexcept -> std::optional<size_type>;
+    [[nodiscard]] inline auto _index(const _slot &slot) const noexcept -> size_type
+    {
+        return static_cast<size_type>(&slot - &slots_[0]);
+    }
+
+    [[nodiscard]] inline auto _locate(const size_type position) const noexcept -> _place;
+    [[nodiscard]] static inline auto _value_at(_slot &slot) noexcept -> value_type *;
+
+    // read only after construction
+    [[no_unique_address]] _slot_allocator alloc_{};
+    size_type capacity_{ _inline ? Extent : 0U };
+    size_type shift_{ 0U };// non-zero only when a dynamic capacity_ is a power of two
+    mutable _storage slots_{};
+
+    // producer side
+    alignas(_cache_line_size) std::atomic<size_type> head_{ 0U };
+
+    // consumer side
+    alignas(_cache_line_size) std::atomic<size_type> tail_{ 0U };
+};
+
+template<typename T, typename Wait, typename Allocator, std::size_t Extent>
+_array_channel<T, Wait, Allocator, Extent>::_array_channel(const size_type capacity, const Allocator &alloc)
+    requires(Extent == std::dynamic_extent)
+    : alloc_(alloc), capacity_(std::max(capacity, size_type{ 1U })),
+      shift_(std::has_single_bit(capacity_) ? static_cast<size_type>(std::countr_zero(capacity_)) : 0U),
+      slots_(_slot_traits::allocate(alloc_, capacity_))
+{
+    // the value storage is left uninitialized, only the stamps need a starting value
+    for (size_type i = 0U; i < capacity_; i++) { std::construct_at(&slots_[i].stamp, 0U); }
+}
+
+template<typename T, typename Wait, typename Allocator, std::size_t Extent>
+_array_channel<T, Wait, Allocator, Extent>::~_array_channel()
+{
+    // destroy anything that was never received
+    const auto head = head_.load(std::memory_order_acquire);
+    for (auto position = tail_.load(std::memory_order_acquire); position != head; position++) {
+        std::destroy_at(_value_at(*_locate(position).slot));
+    }
+
+    if constexpr (!_inline) {
+        for (size_type i = 0U; i < capacity_; i++) { std::destroy_at(&slots_[i].stamp); }
+        _slot_traits::deallocate(alloc_, slots_, capacity_);
+    }
+}
+
+template<typename T, typename Wait, typename Allocator, std::size_t Extent>
+[[nodiscard]] inline auto _array_channel<T, Wait, Allocator, Extent>::size() const noexcept -> size_type
+{
+    // load tail first, it can never pass head. Producers that have claimed a position but
+    // haven't finished writing yet are counted as well.
+    const auto tail = tail_.load(std::memory_order_acquire);
+    const auto head = head_.load(std::memory_order_acquire);
+    return std::min(head - tail, capacity());
+}
+
+template<typename T, typename Wait, typename Allocator, std::size_t Extent>
+[[nodiscard]] inline auto _array_channel<T, Wait, Allocator, Extent>::empty() const noexcept -> bool
+{
+    // decided by the front slot rather than the positions, so a slot held by reserve() reads as
+    // empty and receivers park on it instead of spinning
+    const auto place = _locate(tail_.load(std::memory_order_acquire));
+    return place.slot->stamp.load(std::memory_order_acquire) < place.free + 1U;
+}
+
+template<typename T, typename Wait, typename Allocator, std::size_t Extent>
+[[nodiscard]] inline auto _array_channel<T, Wait, Allocator, Extent>::full() const noexcept -> bool
+{
+    // same for the back slot, which stays in use while pop_ref() holds it
+    const auto place = _locate(head_.load(std::memory_order_acquire));
+    return place.slot->stamp.load(std::memory_order_acquire) < place.free;
+}
+
+template<typename T, typename Wait, typename Allocator, std::size_t Extent>
+[[nodiscard]] constexpr auto _array_channel<T, Wait, Allocator, Extent>::capacity() const noexcept -> size_type
+{
+    if constexpr (_inline) {
+        return Extent;
+    } else {
+        return capacity_;
+    }
+}
+
+template<typename T, typename Wait, typename Allocator, std::size_t Extent>
+template<typename... Args>
+inline auto _array_channel<T, Wait, Allocator, Extent>::_try_reserve(Args &&...args) -> std::optional<_handle>
+{
+    auto position = head_.load(std::memory_order_relaxed);
+
+    while (true) {
+        const auto place = _locate(position);
+        const auto stamp = place.slot->stamp.load(std::memory_order_acquire);
+
+        if (stamp == place.free) {
+            // the slot is free for this lap, try to claim it
+            if (head_.compare_exchange_weak(position, position + 1U, std::memory_order_relaxed)) {
+                auto *value = std::construct_at(_value_at(*place.slot), std::forward<Args>(args)...);
+                return _handle{ value, place.slot, place.free };
+            }
+            this->_contended();
+        } else if (stamp < place.free) {
+            // the slot is still in use from the previous lap, so the queue is full
+            return std::nullopt;
+        } else {
+            // another producer claimed this position first
+            position = head_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template<typename T, typename Wait, typename Allocator, std::size_t Extent>
+inline auto _array_channel<T, Wait, Allocator, Extent>::_commit(_handle &&handle) -> void
+{
+    this->_enter(handle.slot->entered);
+    handle.slot->stamp.store(handle.free + 1U, std::memory_order_release);
+}
+
+template<typename T, typename Wait, typename Allocator, std::size_t Extent>
+inline auto _array_channel<T, Wait, Allocator, Extent>::_try_acquire() -> std::optional<_handle>
+{
+    auto position = tail_.load(std::memory_order_relaxed);
+
+    while (true) {
+        const auto place = _locate(position);
+        const auto stamp = place.slot->stamp.load(std::memory_order_acquire);
+
+        if (stamp == place.free + 1U) {
+            // the slot holds a value for this lap, try to claim it
+            if (tail_.compare_exchange_weak(position, position + 1U, std::memory_order_relaxed)) {
+                return _handle{ _value_at(*place.slot), place.slot, place.free };
+            }
+            this->_contended();
+        } else if (stamp < place.free + 1U) {
+            // the slot hasn't been written for this lap yet, so the queue is empty
+            return std::nullopt;
+        } else {
+            // another consumer claimed this position first
+            position = tail_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template<typename T, typename Wait, typename Allocator, std::size_t Extent>
+inline auto _array_channel<T, Wait, Allocator, Extent>::_release(_handle &&handle) -> void
+{
+    // frees the slot for the next lap
+    this->_leave(handle.slot->entered);
+    std::destroy_at(handle.value);
+    handle.slot->stamp.store(handle.free + 2U, std::memory_order_release);
+}
+
+template<typename T, typename Wait, typename Allocator, std::size_t Extent>
+template<typename It, typename S>
+inline auto _array_channel<T, Wait, Allocator, Extent>::_try_push_many(It &first, const S &last) -> size_type
+{
+    // without knowing how many values are left, slots can only be claimed one at a time
+    if constexpr (!std::sized_sentinel_for<S, It>) {
+        size_type pushed = 0U;
+        while (first != last) {
+            auto handle = _try_reserve(*first);
+            if (!handle) { break; }
+
+            _commit(std::move(*handle));
+            ++first;
+            pushed++;
+        }
+        return pushed;
+    } else {
+        const auto wanted = std::min(static_cast<size_type>(last - first), capacity());
+        auto position = head_.load(std::memory_order_relaxed);
+
+        while (true) {
+            // every slot that is free for this lap can be claimed together with a single CAS
+            size_type count = 0U;
+            while (count < wanted) {
+                const auto place = _locate(position + count);
+                if (place.slot->stamp.load(std::memory_order_acquire) != place.free) { break; }
+                count++;
+            }
+
+            if (count == 0U) {
+                // the first slot is either in use from the previous lap (full) or already claimed
+                const auto place = _locate(position);
+                if (place.slot->stamp.load(std::memory_order_acquire) < place.free) { return 0U; }
+                position = head_.load(std::memory_order_relaxed);
+                continue;
+            }
+
+            if (head_.compare_exchange_weak(position, position + count, std::memory_order_relaxed)) {
+                for (size_type i = 0U; i < count; i++, ++first) {
+                    const auto place = _locate(position + i);
+                    std::construct_at(_value_at(*place.slot), *first);
+                    this->_enter(place.slot->entered);
+                    place.slot->stamp.store(place.free + 1U, std::memory_order_release);
+                }
+                return count;
+            }
+            this->_contended();
+        }
+    }
+}
+
+template<typename T, typename Wait, typename Allocator, std::size_t Extent>
+template<typename Out>
+inline auto _array_channel<T, Wait, Allocator, Extent>::_try_pop_many(Out &out, const size_type max) -> size_type
+{
+    const auto wanted = std::min(max, capacity());
+    auto position = tail_.load(std::memory_order_relaxed);
+
+    while (true) {
+        // every slot that holds a value for this lap can be claimed together with a single CAS
+        size_type count = 0U;
+        while (count < wanted) {
+            const auto place = _locate(position + count);
+            if (place.slot->stamp.load(std::memory_order_acquire) != place.free + 1U) { break; }
+            count++;
+        }
+
+        if (count == 0U) {
+            // the first slot is either not written yet (empty) or already claimed
+            const auto place = _locate(position);
+            if (place.slot->stamp.load(std::memory_order_acquire) < place.free + 1U) { return 0U; }
+            position = tail_.load(std::memory_order_relaxed);
+            continue;
+        }
+
+        if (tail_.compare_exchange_weak(position, position + count, std::memory_order_relaxed)) {
+            for (size_type i = 0U; i < count; i++) {
+                const auto place = _locate(position + i);
+                auto *ptr = _value_at(*place.slot);
+                *out = std::move(*ptr);
+                ++out;
+                std::destroy_at(ptr);
+                this->_leave(place.slot->entered);
+                place.slot->stamp.store(place.free + 2U, std::memory_order_release);
+            }
+            return count;
+        }
+        this->_contended();
+    }
+}
+
+template<typename T, typename Wait, typename Allocator, std::size_t Extent>
+[[nodiscard]] inline auto _array_channel<T, Wait, Allocator, Extent>::_front() const noexcept
+    -> std::optional<size_type>
+{
+    const auto place = _locate(tail_.load(std::memory_order_relaxed));
+    if (place.slot->stamp.load(std::memory_order_acquire) != place.free + 1U) { return std::nullopt; }
+    return _index(*place.slot);
+}
+
+template<typename T, typename Wait, typename Allocator, std::size_t Extent>
+[[nodiscard]] inline auto _array_channel<T, Wait, Allocator, Extent>::_locate(const size_type position) const noexcept
+    -> _place
+{
+    // a constant capacity turns both into a mask and a shift (power of two) or a multiplication
+    if constexpr (_inline) {
+        return { &slots_[position % Extent], 2U * (position / Extent) };
+    } else {
+        if (shift_ != 0U || capacity_ == 1U) {
+            return { &slots_[position & (capacity_ - 1U)], 2U * (position >> shift_) };
+        }
+        return { &slots_[position % capacity_], 2U * (position / capacity_) };
+    }
+}
+
+template<typename T, typename Wait, typename Allocator, std::size_t Extent>
+[[nodiscard]] inline auto _array_channel<T, Wait, Allocator, Extent>::_value_at(_slot &slot) noexcept -> value_type *
+{
+    return std::launder(reinterpret_cast<value_type *>(slot.data));
+}
+
+}// namespace nrws
@@ -0,0 +1,194 @@
+#pragma once
+
+#include "narrows/_internal/_select.hpp"
+
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+namespace nrws {
+
+// Suspends a coroutine until an operation on a channel endpoint can complete.
+//
+// A suspended coroutine links a node into the channel's observer list, so it costs no thread. When
+// the channel changes, the coroutine is not resumed on the notifying thread: an attempt at the
+// operation is posted to the executor instead, and the coroutine is only resumed once that
+// attempt went through. Until then it stays linked and waits for the next change.
+//
+// Only one attempt runs at a time. A change that arrives while an attempt is running marks it
+// dirty, and the attempt tries again instead of going back to sleep, so no change is ever lost.
+// A channel only posts attempts for as many idle coroutines as values (or slots) became available,
+// so thousands of suspended coroutines cost a send no more than the ones it actually wakes. A
+// woken attempt that goes through passes the change on, in case another woken attempt found the
+// value behind a slot that was still held and went back to sleep.
+//
+// A coroutine whose frame is destroyed while it is suspended unlinks itself from the channel. Its
+// executor must not still hold an attempt posted for it, so destroy it after the executor has
+// drained or been torn down.
+//
+// Derived implements _try() -> bool, which attempts the operation once and keeps its result.
+template<typename Derived, typename Endpoint, typename Executor>
+class _awaitable
+{
+  public:
+    _awaitable(Endpoint &endpoint, Executor &executor) : endpoint_(&endpoint), executor_(&executor) {}
+
+    _awaitable(const _awaitable &) = delete;
+    _awaitable &operator=(const _awaitable &) = delete;
+
+    [[nodiscard]] inline auto await_ready() -> bool { return _derived()._try(); }
+    inline auto await_suspend(std::coroutine_handle<> handle) -> bool;
+
+  protected:
+    ~_awaitable();
+
+    Endpoint *endpoint_;
+
+  private:
+    enum class _state : uint8_t {
+        running,// an attempt is in progress
+        dirty,  // an attempt is in progress and the channel changed since it started
+        idle,   // suspended, the next change posts an attempt
+        done,   // the operation went through
+    };
+
+    [[nodiscard]] inline auto _derived() noexcept -> Derived & { return static_cast<Derived &>(*this); }
+
+    // true once the operation went through and the coroutine may continue
+    inline auto _attempt(bool woken) -> bool;
+    static inline auto _wake(void *context) noexcept -> bool;
+
+    Executor *executor_;
+    std::coroutine_handle<> handle_{};
+    std::atomic<_state> state_{ _state::running };
+    _observer_list::node node_;
+};
+
+// co_await receiver.async_receive(executor) yields the Receiver's result_type
+template<typename R, typename Executor>
+class _receive_awaitable : public _awaitable<_receive_awaitable<R, Executor>, R, Executor>
+{
+    using _base = _awaitable<_receive_awaitable<R, Executor>, R, Executor>;
+    friend _base;
+
+  public:
+    _receive_awaitable(R &receiver, Executor &executor) : _base(receiver, executor) {}
+
+    [[nodiscard]] inline auto await_resume() -> typename R::result_type { return std::move(*result_); }
+
+  private:
+    inline auto _try() -> bool;
+
+    std::optional<typename R::result_type> result_;
+};
+
+// co_await sender.async_send(value, executor) yields the Sender's result_type
+template<typename S, typename Executor>
+class _send_awaitable : public _awaitable<_send_awaitable<S, Executor>, S, Executor>
+{
+    using _base = _awaitable<_send_awaitable<S, Executor>, S, Executor>;
+    friend _base;
+
+  public:
+    _send_awaitable(S &sender, typename S::value_type value, Executor &executor)
+        : _base(sender, executor), value_(std::move(value))
+    {}
+
+    [[nodiscard]] inline auto await_resume() -> typename S::result_type { return std::move(*result_); }
+
+  private:
+    inline auto _try() -> bool;
+
+    typename S::value_type value_;
+    std::optional<typename S::result_type> result_;
+};
+
+template<typename Derived, typename Endpoint, typename Executor>
+_awaitable<Derived, Endpoint, Executor>::~_awaitable()
+{
+    // only a coroutine that was suspended and never resumed is still linked
+    if (handle_ && state_.load(std::memory_order_acquire) != _state::done) { endpoint_->_unwatch(node_); }
+}
+
+template<typename Derived, typename Endpoint, typename Executor>
+inline auto _awaitable<Derived, Endpoint, Executor>::await_suspend(std::coroutine_handle<> handle) -> bool
+{
+    handle_ = handle;
+    node_.wake = &_wake;
+    node_.context = this;
+
+    // watching is ordered before the attempt, so a change after it posts another one
+    state_.store(_state::running, std::memory_order_relaxed);
+    endpoint_->_watch(node_);
+
+    return !_attempt(false);
+}
+
+template<typename Derived, typename Endpoint, typename Executor>
+inline auto _awaitable<Derived, Endpoint, Executor>::_attempt(const bool woken) -> bool
+{
+    while (true) {
+        if (_derived()._try()) {
+            state_.store(_state::done, std::memory_order_release);
+            // waits for a notifier that is still looking at this node
+            endpoint_->_unwatch(node_);
+            if (woken) { endpoint_->_pass_on(); }
+            return true;
+        }
+
+        auto expected = _state::running;
+        if (state_.compare_exchange_strong(expected, _state::idle, std::memory_order_acq_rel)) { return false; }
+
+        // the channel changed while we were trying, try again
+        state_.store(_state::running, std::memory_order_relaxed);
+    }
+}
+
+template<typename Derived, typename Endpoint, typename Executor>
+inline auto _awaitable<Derived, Endpoint, Executor>::_wake(void *context) noexcept -> bool
+{
+    auto *self = static_cast<_awaitable *>(context);
+
+    // only a fresh attempt takes the change, one that is already running may use it up on
+    // something that was there before, so the channel goes on to wake another coroutine
+    auto state = self->state_.load(std::memory_order_acquire);
+    while (true) {
+        if (state == _state::idle) {
+            if (self->state_.compare_exchange_weak(state, _state::running, std::memory_order_acq_rel)) {
+                self->executor_->post([self]() {
+                    if (self->_attempt(true)) { self->handle_.resume(); }
+                });
+                return true;
+            }
+        } else if (state == _state::running) {
+            if (self->state_.compare_exchange_weak(state, _state::dirty, std::memory_order_acq_rel)) { return false; }
+        } else {
+            return false;
+        }
+    }
+}
+
+template<typename R, typename Executor>
+inline auto _receive_awaitable<R, Executor>::_try() -> bool
+{
+    auto received = this->endpoint_->try_receive();
+    if (!received.has_value() && received.error() == R::error_type::ChannelEmpty) { return false; }
+
+    result_.emplace(std::move(received));
+    return true;
+}
+
+template<typename S, typename Executor>
+inline auto _send_awaitable<S, Executor>::_try() -> bool
+{
+    // try_send only moves the value out when it was sent
+    auto sent = this->endpoint_->try_send(std::move(value_));
+    if (!sent.has_value() && sent.error() == S::error_type::ChannelFull) { return false; }
+
+    result_.emplace(std::move(sent));
+    return true;
+}
+
+}// namespace nrws
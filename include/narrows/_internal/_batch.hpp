@@ -0,0 +1,55 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+namespace nrws {
+
+// Batches of trivially copyable values are moved with a single memcpy whenever both ends of the
+// copy are contiguous
+template<typename It, typename S, typename T>
+concept _memcpy_source = std::is_trivially_copyable_v<T> && std::contiguous_iterator<It> && std::sized_sentinel_for<S, It>
+                         && std::same_as<std::iter_value_t<It>, T>;
+
+template<typename Out, typename T>
+concept _memcpy_destination =
+    std::is_trivially_copyable_v<T> && std::contiguous_iterator<Out> && std::same_as<std::iter_value_t<Out>, T>;
+
+// Constructs up to max values from [first, last) in the uninitialized storage starting at dest,
+// advances first past the values that were taken and returns how many there were
+template<typename It, typename S, typename T>
+inline auto _construct_segment(It &first, const S &last, T *dest, const std::size_t max) -> std::size_t
+{
+    if constexpr (_memcpy_source<It, S, T>) {
+        const auto count = std::min(max, static_cast<std::size_t>(last - first));
+        if (count != 0U) { std::memcpy(dest, std::to_address(first), count * sizeof(T)); }
+        first += static_cast<std::iter_difference_t<It>>(count);
+        return count;
+    } else {
+        std::size_t count = 0U;
+        for (; count < max && first != last; ++count, ++first) { std::construct_at(dest + count, *first); }
+        return count;
+    }
+}
+
+// Moves count values starting at src to out and advances out. The moved-from values are left
+// for the caller to destroy or overwrite.
+template<typename T, typename Out>
+inline auto _move_segment_out(T *src, const std::size_t count, Out &out) -> void
+{
+    if constexpr (_memcpy_destination<Out, T>) {
+        if (count != 0U) { std::memcpy(std::to_address(out), src, count * sizeof(T)); }
+        out += static_cast<std::iter_difference_t<Out>>(count);
+    } else {
+        for (std::size_t i = 0U; i < count; i++) {
+            *out = std::move(src[i]);
+            ++out;
+        }
+    }
+}
+
+}// namespace nrws
@@ -0,0 +1,407 @@
+#pragma once
+
+#include "narrows/_internal/_arch.hpp"
+#include "narrows/_internal/_errors.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace nrws {
+
+// What a broadcast channel does when its slowest subscriber is a whole ring behind
+enum class lag_policy : uint8_t {
+    block,// the producer waits for the subscriber
+    drop, // the subscriber is dropped and gets Lagged, the producer carries on
+};
+
+// Ring that hands every value to every subscriber.
+//
+// Producers claim sequence numbers with a single fetch_add, construct the value in the slot and
+// publish it by storing sequence + 1 as the slot's stamp. Each subscriber owns a cursor on its
+// own cache line and reads by copying out of the slot once the stamp matches, so a value is
+// written once no matter how many subscribers read it.
+//
+// A producer may only reuse a slot once every subscriber's cursor moved past it. The minimum over
+// all cursors is cached in gate_ and only recomputed (under the registry mutex) when a producer
+// runs into it, which happens about once per lap when subscribers keep up. Cursors only ever move
+// forward and new subscribers start at the head, so a stale gate_ is always a safe lower bound.
+//
+// With lag_policy::drop, a read marks the cursor busy while it copies the value, and a producer
+// drops a lagging subscriber by swapping its idle cursor for _dropped. A busy subscriber is
+// waited for, so a slot is never overwritten while it is being read.
+template<typename T, typename Wait, lag_policy Policy>
+class _broadcast_channel
+{
+  public:
+    using value_type = std::decay_t<T>;
+    using size_type = std::size_t;
+
+    // A subscriber's position, the next sequence it reads
+    struct _cursor
+    {
+        alignas(_cache_line_size) std::atomic<std::uint64_t> position{ 0U };
+    };
+
+    // The capacity is rounded up to a power of two
+    explicit _broadcast_channel(size_type capacity);
+    ~_broadcast_channel();
+
+    _broadcast_channel(const _broadcast_channel &) = delete;
+    _broadcast_channel &operator=(const _broadcast_channel &) = delete;
+
+    template<typename V>
+    inline auto push(V &&value) -> bool;
+    template<typename V>
+    inline auto try_push(V &&value) -> channel_status;
+    template<typename V, typename Clock, typename Duration>
+    inline auto push_until(V &&value, const std::chrono::time_point<Clock, Duration> &deadline) -> channel_status;
+
+    // Registers a cursor at the head, it sees everything sent from now on
+    [[nodiscard]] inline auto subscribe() -> std::unique_ptr<_cursor>;
+    inline auto unsubscribe(_cursor &cursor) -> void;
+
+    // success, empty, closed (after everything was read) or timeout; full means the cursor was dropped
+    [[nodiscard]] inline auto try_pop(_cursor &cursor) -> std::expected<value_type, channel_status>;
+    [[nodiscard]] inline auto pop(_cursor &cursor) -> std::expected<value_type, channel_status>;
+    template<typename Clock, typename Duration>
+    [[nodiscard]] inline auto pop_until(_cursor &cursor, const std::chrono::time_point<Clock, Duration> &deadline)
+        -> std::expected<value_type, channel_status>;
+
+    inline auto close() -> void;
+    [[nodiscard]] inline auto closed() const noexcept -> bool { return closed_.load(std::memory_order_acquire); }
+    [[nodiscard]] inline auto capacity() const noexcept -> size_type { return capacity_; }
+    [[nodiscard]] inline auto subscribers() -> size_type;
+
+  private:
+    constexpr static std::uint64_t _dropped = std::uint64_t{ 1U } << 63U;
+    constexpr static std::uint64_t _busy = std::uint64_t{ 1U } << 62U;
+
+    struct _slot
+    {
+        // sequence + 1 of the value in storage, 0 while the slot was never written
+        std::atomic<std::uint64_t> stamp{ 0U };
+        alignas(value_type) std::byte storage[sizeof(value_type)];
+
+        [[nodiscard]] inline auto get() noexcept -> value_type *
+        {
+            return std::launder(reinterpret_cast<value_type *>(storage));
+        }
+    };
+
+    [[nodiscard]] inline auto _slot_of(const std::uint64_t sequence) noexcept -> _slot &
+    {
+        return slots_[sequence & mask_];
+    }
+
+    // true once sequence can be written without overwriting anything a subscriber still needs
+    [[nodiscard]] inline auto _has_room(std::uint64_t sequence) -> bool;
+    // recomputes gate_, dropping lagging subscribers first if that's the policy
+    inline auto _refresh_gate(std::uint64_t sequence) -> void;
+
+    // claims the next sequence only if it has room
+    [[nodiscard]] inline auto _try_claim() -> std::optional<std::uint64_t>;
+    template<typename Clock, typename Duration>
+    [[nodiscard]] inline auto _wait_room(std::uint64_t sequence, const std::chrono::time_point<Clock, Duration> *deadline)
+        -> channel_status;
+    template<typename V>
+    inline auto _publish(std::uint64_t sequence, V &&value) -> void;
+
+    [[nodiscard]] inline auto _ready(const _cursor &cursor) noexcept -> bool;
+    [[nodiscard]] inline auto _read(_cursor &cursor) -> std::expected<value_type, channel_status>;
+
+    size_type capacity_;
+    std::uint64_t mask_;
+    std::unique_ptr<_slot[]> slots_;
+
+    alignas(_cache_line_size) std::atomic<std::uint64_t> head_{ 0U };
+    alignas(_cache_line_size) std::atomic<std::uint64_t> gate_{ 0U };
+    alignas(_cache_line_size) std::atomic<bool> closed_{ false };
+
+    std::mutex registry_mutex_;
+    std::vector<_cursor *> cursors_;
+
+    typename Wait::waiter_set not_full_;
+    typename Wait::waiter_set not_empty_;
+};
+
+template<typename T, typename Wait, lag_policy Policy>
+_broadcast_channel<T, Wait, Policy>::_broadcast_channel(const size_type capacity)
+    : capacity_(_next_power_of_two(std::max(capacity, size_type{ 1U }))), mask_(capacity_ - 1U),
+      slots_(std::make_unique<_slot[]>(capacity_))
+{}
+
+template<typename T, typename Wait, lag_policy Policy>
+_broadcast_channel<T, Wait, Policy>::~_broadcast_channel()
+{
+    for (size_type i = 0U; i < capacity_; i++) {
+        if (slots_[i].stamp.load(std::memory_order_relaxed) != 0U) { std::destroy_at(slots_[i].get()); }
+    }
+}
+
+template<typename T, typename Wait, lag_policy Policy>
+template<typename V>
+inline auto _broadcast_channel<T, Wait, Policy>::push(V &&value) -> bool
+{
+    if (closed()) { return false; }
+
+    const auto sequence = head_.fetch_add(1U, std::memory_order_relaxed);
+    if (_wait_room(sequence, static_cast<const std::chrono::steady_clock::time_point *>(nullptr))
+        != channel_status::success) {
+        return false;
+    }
+
+    _publish(sequence, std::forward<V>(value));
+    return true;
+}
+
+template<typename T, typename Wait, lag_policy Policy>
+template<typename V>
+inline auto _broadcast_channel<T, Wait, Policy>::try_push(V &&value) -> channel_status
+{
+    if (closed()) { return channel_status::closed; }
+
+    const auto sequence = _try_claim();
+    if (!sequence.has_value()) { return channel_status::full; }
+
+    _publish(*sequence, std::forward<V>(value));
+    return channel_status::success;
+}
+
+template<typename T, typename Wait, lag_policy Policy>
+template<typename V, typename Clock, typename Duration>
+inline auto _broadcast_channel<T, Wait, Policy>::push_until(
+    V &&value, const std::chrono::time_point<Clock, Duration> &deadline) -> channel_status
+{
+    while (true) {
+        if (closed()) { return channel_status::closed; }
+
+        // only claim a sequence once it has room, a claimed sequence can't be given back
+        if (const auto sequence = _try_claim()) {
+            _publish(*sequence, std::forward<V>(value));
+            return channel_status::success;
+        }
+
+        const auto head = head_.load(std::memory_order_relaxed);
+        if (!not_full_.wait_until([this, head]() { return _has_room(head) || closed(); }, deadline)) {
+            return channel_status::timeout;
+        }
+    }
+}
+
+template<typename T, typename Wait, lag_policy Policy>
+[[nodiscard]] inline auto _broadcast_channel<T, Wait, Policy>::subscribe() -> std::unique_ptr<_cursor>
+{
+    auto cursor = std::make_unique<_cursor>();
+
+    std::lock_guard lock{ registry_mutex_ };
+    // every sequence below head_ is already claimed and was gated without this cursor
+    cursor->position.store(head_.load(std::memory_order_acquire), std::memory_order_relaxed);
+    cursors_.push_back(cursor.get());
+    return cursor;
+}
+
+template<typename T, typename Wait, lag_policy Policy>
+inline auto _broadcast_channel<T, Wait, Policy>::unsubscribe(_cursor &cursor) -> void
+{
+    {
+        std::lock_guard lock{ registry_mutex_ };
+        std::erase(cursors_, &cursor);
+    }
+
+    // the leaving subscriber may have been the one holding producers back
+    not_full_.notify_all();
+}
+
+template<typename T, typename Wait, lag_policy Policy>
+[[nodiscard]] inline auto _broadcast_channel<T, Wait, Policy>::subscribers() -> size_type
+{
+    std::lock_guard lock{ registry_mutex_ };
+    return cursors_.size();
+}
+
+template<typename T, typename Wait, lag_policy Policy>
+[[nodiscard]] inline auto _broadcast_channel<T, Wait, Policy>::try_pop(_cursor &cursor)
+    -> std::expected<value_type, channel_status>
+{
+    if (_ready(cursor)) { return _read(cursor); }
+    if (closed()) {
+        // a value may have been published right before the close
+        if (_ready(cursor)) { return _read(cursor); }
+        return std::unexpected(channel_status::closed);
+    }
+    return std::unexpected(channel_status::empty);
+}
+
+template<typename T, typename Wait, lag_policy Policy>
+[[nodiscard]] inline auto _broadcast_channel<T, Wait, Policy>::pop(_cursor &cursor)
+    -> std::expected<value_type, channel_status>
+{
+    while (true) {
+        auto received = try_pop(cursor);
+        if (received.has_value() || received.error() != channel_status::empty) { return received; }
+
+        not_empty_.wait([this, &cursor]() { return _ready(cursor) || closed(); });
+    }
+}
+
+template<typename T, typename Wait, lag_policy Policy>
+template<typename Clock, typename Duration>
+[[nodiscard]] inline auto _broadcast_channel<T, Wait, Policy>::pop_until(
+    _cursor &cursor, const std::chrono::time_point<Clock, Duration> &deadline)
+    -> std::expected<value_type, channel_status>
+{
+    while (true) {
+        auto received = try_pop(cursor);
+        if (received.has_value() || received.error() != channel_status::empty) { return received; }
+
+        if (!not_empty_.wait_until([this, &cursor]() { return _ready(cursor) || closed(); }, deadline)) {
+            return std::unexpected(channel_status::timeout);
+        }
+    }
+}
+
+template<typename T, typename Wait, lag_policy Policy>
+inline auto _broadcast_channel<T, Wait, Policy>::close() -> void
+{
+    closed_.store(true, std::memory_order_seq_cst);
+    not_full_.notify_all();
+    not_empty_.notify_all();
+}
+
+template<typename T, typename Wait, lag_policy Policy>
+[[nodiscard]] inline auto _broadcast_channel<T, Wait, Policy>::_has_room(const std::uint64_t sequence) -> bool
+{
+    if (sequence < gate_.load(std::memory_order_acquire) + capacity_) { return true; }
+
+    _refresh_gate(sequence);
+    return sequence < gate_.load(std::memory_order_acquire) + capacity_;
+}
+
+template<typename T, typename Wait, lag_policy Policy>
+inline auto _broadcast_channel<T, Wait, Policy>::_refresh_gate(const std::uint64_t sequence) -> void
+{
+    std::lock_guard lock{ registry_mutex_ };
+
+    if constexpr (Policy == lag_policy::drop) {
+        std::erase_if(cursors_, [this, sequence](_cursor *cursor) {
+            auto position = cursor->position.load(std::memory_order_acquire);
+            // a busy cursor lags by the position it is reading, without the flag
+            while ((position & ~_busy) + capacity_ <= sequence) {
+                if ((position & _busy) != 0U) {
+                    // the read in progress copies out of the slot sequence overwrites, wait for it
+                    // to finish, it may catch up
+                    std::this_thread::yield();
+                    position = cursor->position.load(std::memory_order_acquire);
+                    continue;
+                }
+                if (cursor->position.compare_exchange_weak(position, _dropped, std::memory_order_acq_rel)) {
+                    return true;
+                }
+            }
+            return false;
+        });
+    }
+
+    // without subscribers nothing holds the producers back
+    auto gate = head_.load(std::memory_order_acquire);
+    for (const auto *cursor : cursors_) {
+        gate = std::min(gate, cursor->position.load(std::memory_order_acquire) & ~_busy);
+    }
+    gate_.store(std::max(gate, gate_.load(std::memory_order_relaxed)), std::memory_order_release);
+}
+
+template<typename T, typename Wait, lag_policy Policy>
+[[nodiscard]] inline auto _broadcast_channel<T, Wait, Policy>::_try_claim() -> std::optional<std::uint64_t>
+{
+    auto head = head_.load(std::memory_order_relaxed);
+    while (true) {
+        if constexpr (Policy == lag_policy::block) {
+            if (!_has_room(head)) { return std::nullopt; }
+        } else {
+            // lagging subscribers are dropped, there is always room
+            static_cast<void>(_has_room(head));
+        }
+
+        if (head_.compare_exchange_weak(head, head + 1U, std::memory_order_relaxed)) { return head; }
+    }
+}
+
+template<typename T, typename Wait, lag_policy Policy>
+template<typename Clock, typename Duration>
+[[nodiscard]] inline auto _broadcast_channel<T, Wait, Policy>::_wait_room(
+    const std::uint64_t sequence, const std::chrono::time_point<Clock, Duration> *deadline) -> channel_status
+{
+    if constexpr (Policy == lag_policy::drop) {
+        static_cast<void>(_has_room(sequence));
+        return channel_status::success;
+    }
+
+    const auto room = [this, sequence]() { return _has_room(sequence) || closed(); };
+    if (deadline == nullptr) {
+        not_full_.wait(room);
+    } else if (!not_full_.wait_until(room, *deadline)) {
+        return channel_status::timeout;
+    }
+
+    return _has_room(sequence) ? channel_status::success : channel_status::closed;
+}
+
+template<typename T, typename Wait, lag_policy Policy>
+template<typename V>
+inline auto _broadcast_channel<T, Wait, Policy>::_publish(const std::uint64_t sequence, V &&value) -> void
+{
+    auto &slot = _slot_of(sequence);
+
+    // the producer a lap ahead of us may still be writing this slot
+    const auto previous = sequence < capacity_ ? 0U : sequence - capacity_ + 1U;
+    while (slot.stamp.load(std::memory_order_acquire) != previous) { std::this_thread::yield(); }
+
+    if (previous != 0U) { std::destroy_at(slot.get()); }
+    std::construct_at(slot.get(), std::forward<V>(value));
+    slot.stamp.store(sequence + 1U, std::memory_order_release);
+
+    not_empty_.notify_all();
+}
+
+template<typename T, typename Wait, lag_policy Policy>
+[[nodiscard]] inline auto _broadcast_channel<T, Wait, Policy>::_ready(const _cursor &cursor) noexcept -> bool
+{
+    const auto position = cursor.position.load(std::memory_order_relaxed);
+    // a dropped cursor reads once more to find out
+    if ((position & _dropped) != 0U) { return true; }
+    return slots_[position & mask_].stamp.load(std::memory_order_acquire) > position;
+}
+
+template<typename T, typename Wait, lag_policy Policy>
+[[nodiscard]] inline auto _broadcast_channel<T, Wait, Policy>::_read(_cursor &cursor)
+    -> std::expected<value_type, channel_status>
+{
+    auto position = cursor.position.load(std::memory_order_relaxed);
+
+    if constexpr (Policy == lag_policy::drop) {
+        // keeps producers from overwriting the slot while we copy out of it
+        if ((position & _dropped) != 0U
+            || !cursor.position.compare_exchange_strong(position, position | _busy, std::memory_order_acq_rel)) {
+            return std::unexpected(channel_status::full);
+        }
+    }
+
+    std::expected<value_type, channel_status> received{ *_slot_of(position).get() };
+    cursor.position.store(position + 1U, std::memory_order_release);
+
+    if constexpr (Policy == lag_policy::block) { not_full_.notify_all(); }
+    return received;
+}
+
+}// namespace nrws
@@ -1,13 +1,20 @@
 #pragma once
 
 #include <chrono>
+#include <cstddef>
 #include <expected>
+#include <iterator>
+#include <memory>
+#include <optional>
 #include <type_traits>
+#include <utility>
 
 #include "narrows/_internal/_errors.hpp"
 
 namespace nrws::single {
 
+// A sender and receiver own their end of the channel outright, so they can only be moved. When
+// either end is destroyed the channel is closed, which lets the other side know it is alone.
 template<typename T, template<typename> typename S>
 class sender
 {
@@ -18,20 +25,40 @@ class sender
     template<typename Rep, typename Period>
     using duration = std::chrono::duration<Rep, Period>;
 
+    explicit sender(std::shared_ptr<container_type> channel) : channel_(std::move(channel)) {}
+    ~sender();
+
     sender() = delete;
     sender(const sender &) = delete;
     sender &operator=(const sender &) = delete;
+    sender(sender &&) noexcept = default;
+    sender &operator=(sender &&) noexcept;
 
     [[nodiscard]] auto send(const value_type &value) -> error_type;
     [[nodiscard]] auto send(value_type &&value) -> error_type;
 
+    // channel_full if there is no room right now, or none came up before the timeout
+    [[nodiscard]] auto try_send(const value_type &value) -> error_type;
+    [[nodiscard]] auto try_send(value_type &&value) -> error_type;
+
     template<typename Rep, typename Period>
     [[nodiscard]] auto send_timeout(const value_type &value, const duration<Rep, Period> &timeout) -> error_type;
     template<typename Rep, typename Period>
     [[nodiscard]] auto send_timeout(value_type &&value, const duration<Rep, Period> &timeout) -> error_type;
 
-private:
-    
+    auto close() -> void;
+
+    // Statistics of an instrumented channel, see nrws::instrumented
+    [[nodiscard]] auto stats() const noexcept
+        requires requires(const container_type &channel) { channel.stats(); }
+    {
+        return channel_->stats();
+    }
+
+  private:
+    [[nodiscard]] static auto _to_error(channel_status status) -> error_type;
+
+    std::shared_ptr<container_type> channel_;
 };
 
 template<typename T, template<typename> typename S>
@@ -40,10 +67,194 @@ class receiver
   public:
     using value_type = std::decay_t<T>;
     using container_type = S<value_type>;
+    using error_type = std::expected<value_type, error_id>;
+    template<typename Rep, typename Period>
+    using duration = std::chrono::duration<Rep, Period>;
+
+    explicit receiver(std::shared_ptr<container_type> channel) : channel_(std::move(channel)) {}
+    ~receiver();
 
     receiver() = delete;
     receiver(const receiver &) = delete;
     receiver &operator=(const receiver &) = delete;
+    receiver(receiver &&) noexcept = default;
+    receiver &operator=(receiver &&) noexcept;
+
+    [[nodiscard]] auto receive() -> error_type;
+
+    // channel_empty if no value is ready right now, or none arrived before the timeout
+    [[nodiscard]] auto try_receive() -> error_type;
+    template<typename Rep, typename Period>
+    [[nodiscard]] auto receive_timeout(const duration<Rep, Period> &timeout) -> error_type;
+
+    auto close() -> void;
+
+    // Statistics of an instrumented channel, see nrws::instrumented
+    [[nodiscard]] auto stats() const noexcept
+        requires requires(const container_type &channel) { channel.stats(); }
+    {
+        return channel_->stats();
+    }
+
+    // Iterator type, receives until the channel is closed and drained
+    class _iter
+    {
+      public:
+        using value_type = receiver::value_type;
+        using difference_type = std::ptrdiff_t;
+
+        _iter() = default;
+        explicit _iter(container_type *channel) : channel_(channel) { ++(*this); }
+
+        const value_type &operator*() const { return *value_; }
+        _iter &operator++();
+        void operator++(int) { ++(*this); }
+
+        bool operator==(const _iter &other) const noexcept { return channel_ == other.channel_; }
+
+      private:
+        container_type *channel_{ nullptr };
+        std::optional<value_type> value_{ std::nullopt };
+    };
+    static_assert(std::input_iterator<_iter>, "The receiver iterator must satisfy input iterator");
+
+    [[nodiscard]] auto begin() -> _iter { return _iter(channel_.get()); }
+    [[nodiscard]] auto end() -> _iter { return _iter(); }
+
+  private:
+    std::shared_ptr<container_type> channel_;
 };
 
+/* Sender Implementations */
+
+template<typename T, template<typename> typename S>
+sender<T, S>::~sender()
+{
+    close();
+}
+
+template<typename T, template<typename> typename S>
+auto sender<T, S>::operator=(sender &&other) noexcept -> sender &
+{
+    if (this != &other) {
+        close();
+        channel_ = std::move(other.channel_);
+    }
+    return *this;
+}
+
+template<typename T, template<typename> typename S>
+[[nodiscard]] auto sender<T, S>::send(const value_type &value) -> error_type
+{
+    if (!channel_->push(value)) { return std::unexpected(error_id::channel_disconnected); }
+    return error_type{};
+}
+
+template<typename T, template<typename> typename S>
+[[nodiscard]] auto sender<T, S>::send(value_type &&value) -> error_type
+{
+    if (!channel_->push(std::move(value))) { return std::unexpected(error_id::channel_disconnected); }
+    return error_type{};
+}
+
+template<typename T, template<typename> typename S>
+[[nodiscard]] auto sender<T, S>::try_send(const value_type &value) -> error_type
+{
+    return _to_error(channel_->try_push(value));
+}
+
+template<typename T, template<typename> typename S>
+[[nodiscard]] auto sender<T, S>::try_send(value_type &&value) -> error_type
+{
+    return _to_error(channel_->try_push(std::move(value)));
+}
+
+template<typename T, template<typename> typename S>
+template<typename Rep, typename Period>
+[[nodiscard]] auto sender<T, S>::send_timeout(const value_type &value, const duration<Rep, Period> &timeout)
+    -> error_type
+{
+    return _to_error(channel_->push_until(value, std::chrono::steady_clock::now() + timeout));
+}
+
+template<typename T, template<typename> typename S>
+template<typename Rep, typename Period>
+[[nodiscard]] auto sender<T, S>::send_timeout(value_type &&value, const duration<Rep, Period> &timeout) -> error_type
+{
+    return _to_error(channel_->push_until(std::move(value), std::chrono::steady_clock::now() + timeout));
+}
+
+template<typename T, template<typename> typename S>
+auto sender<T, S>::close() -> void
+{
+    if (channel_) { channel_->close(); }
+}
+
+template<typename T, template<typename> typename S>
+[[nodiscard]] auto sender<T, S>::_to_error(const channel_status status) -> error_type
+{
+    if (status == channel_status::success) { return error_type{}; }
+    if (status == channel_status::closed) { return std::unexpected(error_id::channel_disconnected); }
+    return std::unexpected(error_id::channel_full);
+}
+
+/* Receiver Implementations */
+
+template<typename T, template<typename> typename S>
+receiver<T, S>::~receiver()
+{
+    close();
+}
+
+template<typename T, template<typename> typename S>
+auto receiver<T, S>::operator=(receiver &&other) noexcept -> receiver &
+{
+    if (this != &other) {
+        close();
+        channel_ = std::move(other.channel_);
+    }
+    return *this;
+}
+
+template<typename T, template<typename> typename S>
+[[nodiscard]] auto receiver<T, S>::receive() -> error_type
+{
+    auto value = channel_->pop();
+    if (!value.has_value()) { return std::unexpected(error_id::channel_disconnected); }
+    return std::move(*value);
+}
+
+template<typename T, template<typename> typename S>
+[[nodiscard]] auto receiver<T, S>::try_receive() -> error_type
+{
+    auto value = channel_->try_pop();
+    if (value.has_value()) { return std::move(*value); }
+    if (value.error() == channel_status::closed) { return std::unexpected(error_id::channel_disconnected); }
+    return std::unexpected(error_id::channel_empty);
+}
+
+template<typename T, template<typename> typename S>
+template<typename Rep, typename Period>
+[[nodiscard]] auto receiver<T, S>::receive_timeout(const duration<Rep, Period> &timeout) -> error_type
+{
+    auto value = channel_->pop_until(std::chrono::steady_clock::now() + timeout);
+    if (value.has_value()) { return std::move(*value); }
+    if (value.error() == channel_status::closed) { return std::unexpected(error_id::channel_disconnected); }
+    return std::unexpected(error_id::channel_empty);
+}
+
+template<typename T, template<typename> typename S>
+auto receiver<T, S>::close() -> void
+{
+    if (channel_) { channel_->close(); }
+}
+
+template<typename T, template<typename> typename S>
+auto receiver<T, S>::_iter::operator++() -> _iter &
+{
+    value_ = channel_->pop();
+    if (!value_.has_value()) { channel_ = nullptr; }
+    return *this;
+}
+
 }// namespace nrws::single
@@ -0,0 +1,791 @@
+#pragma once
+
+#include "narrows/_internal/_arch.hpp"
+#include "narrows/_internal/_errors.hpp"
+#include "narrows/_internal/_select.hpp"
+#include "narrows/_internal/_stats.hpp"
+#include "narrows/wait.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <expected>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace nrws {
+
+// Blocking operations shared by every channel backend.
+//
+// A backend derives from _channel_ops and only implements the non-blocking primitives below.
+// _channel_ops turns them into blocking operations by waiting on the not-full and not-empty
+// waiter sets of the Wait policy, and owns the closed flag.
+//
+// Single values go through a _handle to a slot, which has a `value_type *value` member. A slot
+// is reserved by constructing a value in it and becomes visible to receivers on commit. A
+// receiver acquires a slot, reads it in place and frees it on release.
+//
+//     constexpr static bool _bounded;                            // false if pushes never wait
+//     auto _try_reserve(Args &&...args) -> std::optional<_handle>; // only consumes args on success
+//     auto _commit(_handle &&handle) -> void;
+//     auto _try_acquire() -> std::optional<_handle>;
+//     auto _release(_handle &&handle) -> void;                   // destroys the value
+//     auto _try_push_many(It &first, const S &last) -> size_type;
+//     auto _try_pop_many(Out &out, size_type max) -> size_type;
+//     auto empty() const noexcept -> bool;
+//     auto full() const noexcept -> bool;
+//
+// Waiting threads park until empty() or full() changes, so both must only count committed and
+// released slots. A slot held by a guard counts as neither, or the other side would spin on it.
+// A waiter woken for a value queued behind such a slot finds the channel still empty and parks
+// again, swallowing the wake, so a waiter that was woken and got through passes one on.
+//
+// A backend where room freed by a receive can only be used by some of the producers sets
+// `constexpr static bool _partitioned = true;`, so freeing room wakes every room observer. It can
+// also park those producers apart, and wake only the ones that can use the room it frees:
+//
+//     auto _room_waiters() -> typename Wait::waiter_set &;        // where the caller waits for room
+//     auto _wake_producers() noexcept -> void;                     // on close, wakes every one of them
+//
+// With an instrumented Wait policy the channel keeps statistics. Backends take their locks through
+// _lock(), report lost claim races through _contended(), and keep an _entry_time_type next to
+// every value that they pass to _enter() when it is published and to _leave() when it is freed.
+// For any other policy all of these compile to nothing.
+template<typename Derived, typename T, typename Wait>
+class _channel_ops
+{
+  public:
+    using value_type = std::decay_t<T>;
+    using size_type = std::size_t;
+
+    class _write_guard;
+    class _read_guard;
+
+    // Push/Pop API, push returns false if the channel was closed before the value was placed
+    inline auto push(const value_type &value) -> bool { return _push(value); }
+    inline auto push(value_type &&value) -> bool { return _push(std::move(value)); }
+
+    [[nodiscard]] inline auto pop() -> std::optional<value_type>;
+
+    // Non-blocking Push/Pop API. try_push returns full instead of waiting for room and try_pop
+    // returns empty instead of waiting for a value, both return closed once the channel is closed
+    // (and drained for try_pop). The value is only moved from if it was placed.
+    inline auto try_push(const value_type &value) -> channel_status { return _try_push(value); }
+    inline auto try_push(value_type &&value) -> channel_status { return _try_push(std::move(value)); }
+    [[nodiscard]] inline auto try_pop() -> std::expected<value_type, channel_status>;
+
+    // Timed Push/Pop API, waits at most until the deadline and returns timeout if it passed first
+    template<typename Clock, typename Duration>
+    inline auto push_until(const value_type &value, const std::chrono::time_point<Clock, Duration> &deadline)
+        -> channel_status
+    {
+        return _push_until(deadline, value);
+    }
+    template<typename Clock, typename Duration>
+    inline auto push_until(value_type &&value, const std::chrono::time_point<Clock, Duration> &deadline)
+        -> channel_status
+    {
+        return _push_until(deadline, std::move(value));
+    }
+    template<typename Clock, typename Duration>
+    [[nodiscard]] inline auto pop_until(const std::chrono::time_point<Clock, Duration> &deadline)
+        -> std::expected<value_type, channel_status>;
+
+    // Constructs the value directly in a slot of the channel
+    template<typename... Args>
+    inline auto emplace(Args &&...args) -> bool { return _push(std::forward<Args>(args)...); }
+
+    // Zero copy API. reserve() constructs a value in a slot and hands it out to be filled in, the
+    // value is sent on commit() or when the guard is destroyed. pop_ref() hands out the next value
+    // in place, its slot is freed on release() or when the guard is destroyed. Both return
+    // nullopt once the channel is closed (and drained for pop_ref).
+    template<typename... Args>
+    [[nodiscard]] inline auto reserve(Args &&...args) -> std::optional<_write_guard>;
+    [[nodiscard]] inline auto pop_ref() -> std::optional<_read_guard>;
+
+    // Batched Push/Pop API, each synchronization with the other side moves as many values as
+    // currently fit. push_many blocks until every value is placed and returns how many were placed
+    // before the channel closed. pop_many blocks until at least one value is available and returns
+    // how many were written to out, 0 once the channel is closed and drained (or the deadline
+    // passed for pop_many_until). try_pop_many never waits, it returns empty instead.
+    template<typename It, typename S>
+    inline auto push_many(It first, S last) -> size_type;
+    // same, and leaves first at the first value that wasn't placed
+    template<typename It, typename S>
+    inline auto _push_many(It &first, const S &last) -> size_type;
+
+    template<typename Out>
+    [[nodiscard]] inline auto pop_many(Out out, size_type max) -> size_type;
+
+    template<typename Out>
+    [[nodiscard]] inline auto try_pop_many(Out out, size_type max) -> std::expected<size_type, channel_status>;
+
+    template<typename Out, typename Clock, typename Duration>
+    [[nodiscard]] inline auto pop_many_until(
+        Out out, size_type max, const std::chrono::time_point<Clock, Duration> &deadline) -> size_type;
+
+    // Closing a channel
+    inline auto close() -> void;
+    [[nodiscard]] inline auto closed() const noexcept -> bool { return closed_.load(std::memory_order_acquire); }
+
+    // Statistics of an instrumented channel, can be taken from any thread at any time
+    [[nodiscard]] inline auto stats() const noexcept -> channel_stats
+        requires _is_instrumented<Wait>
+    {
+        return stats_.snapshot();
+    }
+
+    // Iterator type, pops until the channel is closed and drained
+    class _iter
+    {
+      public:
+        using value_type = _channel_ops::value_type;
+        using difference_type = std::ptrdiff_t;
+
+        _iter() = default;
+        explicit _iter(_channel_ops *channel) : channel_(channel) { ++(*this); }
+
+        const value_type &operator*() const { return *value_; }
+        _iter &operator++();
+        void operator++(int) { ++(*this); }
+
+        bool operator==(const _iter &other) const noexcept { return channel_ == other.channel_; }
+
+      private:
+        _channel_ops *channel_{ nullptr };
+        std::optional<value_type> value_{ std::nullopt };
+    };
+    static_assert(std::input_iterator<_iter>, "The channel iterator must satisfy input iterator");
+
+    // Iterating over a _batch_range pops up to batch_size values per synchronization
+    class _batch_range
+    {
+      public:
+        class _iter
+        {
+          public:
+            using value_type = _channel_ops::value_type;
+            using difference_type = std::ptrdiff_t;
+
+            _iter() = default;
+            explicit _iter(_batch_range *range) : range_(range) { ++(*this); }
+
+            const value_type &operator*() const { return range_->buffer_[index_]; }
+            _iter &operator++();
+            void operator++(int) { ++(*this); }
+
+            bool operator==(const _iter &other) const noexcept { return range_ == other.range_; }
+
+          private:
+            _batch_range *range_{ nullptr };
+            size_type index_{ 0U };
+        };
+        static_assert(std::input_iterator<_iter>, "The batch iterator must satisfy input iterator");
+
+        _batch_range(_channel_ops *channel, const size_type batch_size) : channel_(channel), batch_size_(batch_size)
+        {
+            buffer_.reserve(batch_size_);
+        }
+
+        [[nodiscard]] auto begin() -> _iter { return _iter(this); }
+        [[nodiscard]] auto end() -> _iter { return _iter(); }
+
+      private:
+        _channel_ops *channel_;
+        size_type batch_size_;
+        std::vector<value_type> buffer_;
+    };
+
+    // Handed out by reserve(), the slot is only visible to receivers once committed
+    class _write_guard
+    {
+      public:
+        _write_guard(_channel_ops *channel, typename Derived::_handle &&handle)
+            : channel_(channel), handle_(std::move(handle))
+        {}
+        _write_guard(_write_guard &&other) noexcept
+            : channel_(std::exchange(other.channel_, nullptr)), handle_(std::move(other.handle_))
+        {}
+        ~_write_guard() { commit(); }
+
+        _write_guard(const _write_guard &) = delete;
+        _write_guard &operator=(const _write_guard &) = delete;
+        _write_guard &operator=(_write_guard &&) = delete;
+
+        value_type &operator*() const noexcept { return *handle_.value; }
+        value_type *operator->() const noexcept { return handle_.value; }
+
+        inline auto commit() -> void;
+
+      private:
+        _channel_ops *channel_;
+        typename Derived::_handle handle_;
+    };
+
+    // Handed out by pop_ref(), the value is destroyed and its slot freed on release
+    class _read_guard
+    {
+      public:
+        _read_guard(_channel_ops *channel, typename Derived::_handle &&handle)
+            : channel_(channel), handle_(std::move(handle))
+        {}
+        _read_guard(_read_guard &&other) noexcept
+            : channel_(std::exchange(other.channel_, nullptr)), handle_(std::move(other.handle_))
+        {}
+        ~_read_guard() { release(); }
+
+        _read_guard(const _read_guard &) = delete;
+        _read_guard &operator=(const _read_guard &) = delete;
+        _read_guard &operator=(_read_guard &&) = delete;
+
+        value_type &operator*() const noexcept { return *handle_.value; }
+        value_type *operator->() const noexcept { return handle_.value; }
+
+        inline auto release() -> void;
+
+      private:
+        _channel_ops *channel_;
+        typename Derived::_handle handle_;
+    };
+
+    // range functions
+    [[nodiscard]] inline auto begin() -> _iter { return _iter(this); }
+    [[nodiscard]] inline auto end() -> _iter { return _iter(); }
+    [[nodiscard]] inline auto batched(const size_type batch_size) -> _batch_range { return { this, batch_size }; }
+
+    // Lets a select or coroutine wait on this channel, the node is woken whenever a value (or
+    // room) may have become available and when the channel is closed
+    inline auto _watch_values(_observer_list::node &observer) -> void { value_observers_.add(observer); }
+    inline auto _unwatch_values(_observer_list::node &observer) -> void { value_observers_.remove(observer); }
+    inline auto _watch_room(_observer_list::node &observer) -> void { room_observers_.add(observer); }
+    inline auto _unwatch_room(_observer_list::node &observer) -> void { room_observers_.remove(observer); }
+
+    // Called by a waiter that was woken and got through, wakes another one while values (or
+    // room) are left
+    inline auto _pass_values_on() noexcept -> void;
+    inline auto _pass_room_on() noexcept -> void;
+
+  protected:
+    constexpr static bool _instrumented = _is_instrumented<Wait>;
+    using _entry_time_type = std::conditional_t<_instrumented, _entry_time, _no_entry_time>;
+
+    _channel_ops() = default;
+    ~_channel_ops() = default;
+
+    _channel_ops(const _channel_ops &) = delete;
+    _channel_ops &operator=(const _channel_ops &) = delete;
+
+    [[nodiscard]] inline auto _derived() noexcept -> Derived & { return static_cast<Derived &>(*this); }
+    [[nodiscard]] inline auto _derived() const noexcept -> const Derived & { return static_cast<const Derived &>(*this); }
+
+    template<typename... Args>
+    inline auto _push(Args &&...args) -> bool;
+    template<typename... Args>
+    inline auto _try_push(Args &&...args) -> channel_status;
+    template<typename Clock, typename Duration, typename... Args>
+    inline auto _push_until(const std::chrono::time_point<Clock, Duration> &deadline, Args &&...args)
+        -> channel_status;
+
+    // moves the value out of an acquired slot and frees it
+    template<typename Handle>
+    [[nodiscard]] inline auto _take(Handle &&handle) -> value_type;
+
+    // blocks until a slot is reserved or acquired, nullopt once that can't happen anymore.
+    // Derived is incomplete here, so the optional<Derived::_handle> return type is deduced.
+    template<typename... Args>
+    [[nodiscard]] inline auto _reserve(Args &&...args);
+    [[nodiscard]] inline auto _acquire();
+
+    // where the calling producer waits for room
+    [[nodiscard]] inline auto _producer_waiters() noexcept -> typename Wait::waiter_set &;
+    // wakes up as many waiters and coroutines as values were moved, and any select watching
+    template<typename Waiters>
+    inline auto _notify(Waiters &waiters, _observer_list &observers, const size_type count) noexcept -> void;
+    // count values that were sent or received and wake up the other side
+    inline auto _sent(const size_type count) noexcept -> void;
+    inline auto _received(const size_type count) noexcept -> void;
+
+    // wait on a waiter set, timed when instrumented
+    template<typename Waiters, typename Pred>
+    inline auto _park(Waiters &waiters, Pred ready) -> void;
+    template<typename Waiters, typename Pred, typename Clock, typename Duration>
+    inline auto _park_until(Waiters &waiters, Pred ready, const std::chrono::time_point<Clock, Duration> &deadline)
+        -> bool;
+
+    // statistics hooks for backends
+    template<typename Mutex>
+    [[nodiscard]] inline auto _lock(Mutex &mutex) -> std::unique_lock<Mutex>;
+    inline auto _contended() noexcept -> void;
+    inline auto _enter(_entry_time_type &entry) noexcept -> void;
+    inline auto _leave(const _entry_time_type &entry) noexcept -> void;
+
+    // rarely written, read by both sides
+    alignas(_cache_line_size) std::atomic<bool> closed_{ false };
+    typename Wait::waiter_set not_full_;
+    typename Wait::waiter_set not_empty_;
+    _observer_list value_observers_;
+    _observer_list room_observers_;
+
+    [[no_unique_address]] std::conditional_t<_instrumented, _live_stats, _no_stats> stats_;
+};
+
+template<typename Derived, typename T, typename Wait>
+template<typename... Args>
+[[nodiscard]] inline auto _channel_ops<Derived, T, Wait>::_reserve(Args &&...args)
+{
+    auto &self = _derived();
+    std::optional<typename Derived::_handle> handle{ std::nullopt };
+
+    auto parked = false;
+
+    while (!closed()) {
+        // _try_reserve only consumes args when it succeeds, so it is safe to forward them again
+        handle = self._try_reserve(std::forward<Args>(args)...);
+        if (handle) { break; }
+
+        _park(_producer_waiters(), [this, &self]() { return !self.full() || closed(); });
+        parked = true;
+    }
+
+    if (handle && parked) { _pass_room_on(); }
+    return handle;
+}
+
+template<typename Derived, typename T, typename Wait>
+[[nodiscard]] inline auto _channel_ops<Derived, T, Wait>::_acquire()
+{
+    auto &self = _derived();
+    std::optional<typename Derived::_handle> handle{ std::nullopt };
+
+    auto parked = false;
+
+    while (true) {
+        handle = self._try_acquire();
+        if (handle) { break; }
+
+        // everything sent before the close is still received, so only give up once the
+        // channel is closed and drained
+        if (closed() && self.empty()) { break; }
+
+        _park(not_empty_, [this, &self]() { return !self.empty() || closed(); });
+        parked = true;
+    }
+
+    if (handle && parked) { _pass_values_on(); }
+    return handle;
+}
+
+template<typename Derived, typename T, typename Wait>
+template<typename... Args>
+inline auto _channel_ops<Derived, T, Wait>::_push(Args &&...args) -> bool
+{
+    auto handle = _reserve(std::forward<Args>(args)...);
+    if (!handle) { return false; }
+
+    _derived()._commit(std::move(*handle));
+    _sent(1U);
+    return true;
+}
+
+template<typename Derived, typename T, typename Wait>
+template<typename... Args>
+inline auto _channel_ops<Derived, T, Wait>::_try_push(Args &&...args) -> channel_status
+{
+    if (closed()) { return channel_status::closed; }
+
+    // a backend may only learn about a close when it tries to reserve
+    auto handle = _derived()._try_reserve(std::forward<Args>(args)...);
+    if (!handle) { return closed() ? channel_status::closed : channel_status::full; }
+
+    _derived()._commit(std::move(*handle));
+    _sent(1U);
+    return channel_status::success;
+}
+
+template<typename Derived, typename T, typename Wait>
+template<typename Clock, typename Duration, typename... Args>
+inline auto _channel_ops<Derived, T, Wait>::_push_until(
+    const std::chrono::time_point<Clock, Duration> &deadline, Args &&...args) -> channel_status
+{
+    auto &self = _derived();
+    auto parked = false;
+
+    while (!closed()) {
+        // _try_reserve only consumes args when it succeeds, so it is safe to forward them again
+        auto handle = self._try_reserve(std::forward<Args>(args)...);
+        if (handle) {
+            self._commit(std::move(*handle));
+            _sent(1U);
+            if (parked) { _pass_room_on(); }
+            return channel_status::success;
+        }
+
+        if (!_park_until(_producer_waiters(), [this, &self]() { return !self.full() || closed(); }, deadline)) {
+            return channel_status::timeout;
+        }
+        parked = true;
+    }
+
+    return channel_status::closed;
+}
+
+template<typename Derived, typename T, typename Wait>
+template<typename Handle>
+[[nodiscard]] inline auto _channel_ops<Derived, T, Wait>::_take(Handle &&handle) -> value_type
+{
+    value_type value{ std::move(*handle.value) };
+    _derived()._release(std::forward<Handle>(handle));
+    _received(1U);
+    return value;
+}
+
+template<typename Derived, typename T, typename Wait>
+[[nodiscard]] inline auto _channel_ops<Derived, T, Wait>::pop() -> std::optional<value_type>
+{
+    auto handle = _acquire();
+    if (!handle) { return std::nullopt; }
+    return _take(std::move(*handle));
+}
+
+template<typename Derived, typename T, typename Wait>
+[[nodiscard]] inline auto _channel_ops<Derived, T, Wait>::try_pop() -> std::expected<value_type, channel_status>
+{
+    auto &self = _derived();
+
+    auto handle = self._try_acquire();
+    if (handle) { return _take(std::move(*handle)); }
+
+    if (closed() && self.empty()) { return std::unexpected(channel_status::closed); }
+    return std::unexpected(channel_status::empty);
+}
+
+template<typename Derived, typename T, typename Wait>
+template<typename Clock, typename Duration>
+[[nodiscard]] inline auto _channel_ops<Derived, T, Wait>::pop_until(
+    const std::chrono::time_point<Clock, Duration> &deadline) -> std::expected<value_type, channel_status>
+{
+    auto &self = _derived();
+    auto parked = false;
+
+    while (true) {
+        auto handle = self._try_acquire();
+        if (handle) {
+            if (parked) { _pass_values_on(); }
+            return _take(std::move(*handle));
+        }
+
+        if (closed() && self.empty()) { return std::unexpected(channel_status::closed); }
+
+        if (!_park_until(not_empty_, [this, &self]() { return !self.empty() || closed(); }, deadline)) {
+            return std::unexpected(channel_status::timeout);
+        }
+        parked = true;
+    }
+}
+
+template<typename Derived, typename T, typename Wait>
+template<typename... Args>
+[[nodiscard]] inline auto _channel_ops<Derived, T, Wait>::reserve(Args &&...args) -> std::optional<_write_guard>
+{
+    auto handle = _reserve(std::forward<Args>(args)...);
+    if (!handle) { return std::nullopt; }
+    return std::optional<_write_guard>{ std::in_place, this, std::move(*handle) };
+}
+
+template<typename Derived, typename T, typename Wait>
+[[nodiscard]] inline auto _channel_ops<Derived, T, Wait>::pop_ref() -> std::optional<_read_guard>
+{
+    auto handle = _acquire();
+    if (!handle) { return std::nullopt; }
+    return std::optional<_read_guard>{ std::in_place, this, std::move(*handle) };
+}
+
+template<typename Derived, typename T, typename Wait>
+inline auto _channel_ops<Derived, T, Wait>::_write_guard::commit() -> void
+{
+    if (channel_ == nullptr) { return; }
+
+    channel_->_derived()._commit(std::move(handle_));
+    channel_->_sent(1U);
+    channel_ = nullptr;
+}
+
+template<typename Derived, typename T, typename Wait>
+inline auto _channel_ops<Derived, T, Wait>::_read_guard::release() -> void
+{
+    if (channel_ == nullptr) { return; }
+
+    channel_->_derived()._release(std::move(handle_));
+    channel_->_received(1U);
+    channel_ = nullptr;
+}
+
+template<typename Derived, typename T, typename Wait>
+template<typename It, typename S>
+inline auto _channel_ops<Derived, T, Wait>::push_many(It first, S last) -> size_type
+{
+    return _push_many(first, last);
+}
+
+template<typename Derived, typename T, typename Wait>
+template<typename It, typename S>
+inline auto _channel_ops<Derived, T, Wait>::_push_many(It &first, const S &last) -> size_type
+{
+    auto &self = _derived();
+    size_type pushed = 0U;
+    auto parked = false;
+
+    while (first != last && !closed()) {
+        const auto count = self._try_push_many(first, last);
+        if (count != 0U) {
+            pushed += count;
+            _sent(count);
+            continue;
+        }
+
+        _park(_producer_waiters(), [this, &self]() { return !self.full() || closed(); });
+        parked = true;
+    }
+
+    if (parked) { _pass_room_on(); }
+    return pushed;
+}
+
+template<typename Derived, typename T, typename Wait>
+template<typename Out>
+[[nodiscard]] inline auto _channel_ops<Derived, T, Wait>::pop_many(Out out, const size_type max) -> size_type
+{
+    auto &self = _derived();
+    if (max == 0U) { return 0U; }
+    auto parked = false;
+
+    while (true) {
+        const auto count = self._try_pop_many(out, max);
+        if (count != 0U) {
+            _received(count);
+            if (parked) { _pass_values_on(); }
+            return count;
+        }
+
+        if (closed() && self.empty()) { return 0U; }
+
+        _park(not_empty_, [this, &self]() { return !self.empty() || closed(); });
+        parked = true;
+    }
+}
+
+template<typename Derived, typename T, typename Wait>
+template<typename Out>
+[[nodiscard]] inline auto _channel_ops<Derived, T, Wait>::try_pop_many(Out out, const size_type max)
+    -> std::expected<size_type, channel_status>
+{
+    auto &self = _derived();
+    if (max == 0U) { return 0U; }
+
+    const auto count = self._try_pop_many(out, max);
+    if (count != 0U) {
+        _received(count);
+        return count;
+    }
+
+    if (closed() && self.empty()) { return std::unexpected(channel_status::closed); }
+    return std::unexpected(channel_status::empty);
+}
+
+template<typename Derived, typename T, typename Wait>
+template<typename Out, typename Clock, typename Duration>
+[[nodiscard]] inline auto _channel_ops<Derived, T, Wait>::pop_many_until(
+    Out out, const size_type max, const std::chrono::time_point<Clock, Duration> &deadline) -> size_type
+{
+    auto &self = _derived();
+    if (max == 0U) { return 0U; }
+    auto parked = false;
+
+    while (true) {
+        const auto count = self._try_pop_many(out, max);
+        if (count != 0U) {
+            _received(count);
+            if (parked) { _pass_values_on(); }
+            return count;
+        }
+
+        if (closed() && self.empty()) { return 0U; }
+
+        if (!_park_until(not_empty_, [this, &self]() { return !self.empty() || closed(); }, deadline)) {
+            return 0U;
+        }
+        parked = true;
+    }
+}
+
+template<typename Derived, typename T, typename Wait>
+inline auto _channel_ops<Derived, T, Wait>::close() -> void
+{
+    closed_.store(true, std::memory_order_seq_cst);
+    not_full_.notify_all();
+    if constexpr (requires(Derived &self) { self._wake_producers(); }) { _derived()._wake_producers(); }
+    not_empty_.notify_all();
+    value_observers_.notify();
+    room_observers_.notify();
+}
+
+template<typename Derived, typename T, typename Wait>
+template<typename Waiters>
+inline auto _channel_ops<Derived, T, Wait>::_notify(
+    Waiters &waiters, _observer_list &observers, const size_type count) noexcept -> void
+{
+    if (count == 1U) {
+        waiters.notify_one();
+    } else {
+        waiters.notify_all();
+    }
+
+    // one observer may not be able to use the room, wake them all
+    constexpr bool partitioned = requires { requires Derived::_partitioned; };
+    if (partitioned && &observers == &room_observers_) {
+        observers.notify();
+    } else {
+        observers.notify(count);
+    }
+}
+
+template<typename Derived, typename T, typename Wait>
+[[nodiscard]] inline auto _channel_ops<Derived, T, Wait>::_producer_waiters() noexcept -> typename Wait::waiter_set &
+{
+    if constexpr (requires(Derived &self) { self._room_waiters(); }) {
+        return _derived()._room_waiters();
+    } else {
+        return not_full_;
+    }
+}
+
+template<typename Derived, typename T, typename Wait>
+inline auto _channel_ops<Derived, T, Wait>::_sent(const size_type count) noexcept -> void
+{
+    if constexpr (_instrumented) {
+        stats_.sent(count);
+        if constexpr (requires(const Derived &self) { self.size(); }) { stats_.occupied(_derived().size()); }
+    }
+    _notify(not_empty_, value_observers_, count);
+}
+
+template<typename Derived, typename T, typename Wait>
+inline auto _channel_ops<Derived, T, Wait>::_received(const size_type count) noexcept -> void
+{
+    if constexpr (_instrumented) { stats_.received(count); }
+    if constexpr (Derived::_bounded) { _notify(not_full_, room_observers_, count); }
+}
+
+template<typename Derived, typename T, typename Wait>
+inline auto _channel_ops<Derived, T, Wait>::_pass_values_on() noexcept -> void
+{
+    if (!_derived().empty()) {
+        not_empty_.notify_one();
+        value_observers_.notify(1U);
+    }
+}
+
+template<typename Derived, typename T, typename Wait>
+inline auto _channel_ops<Derived, T, Wait>::_pass_room_on() noexcept -> void
+{
+    if constexpr (Derived::_bounded) {
+        if (!_derived().full()) {
+            _producer_waiters().notify_one();
+            // a partitioned channel already wakes every room observer
+            constexpr bool partitioned = requires { requires Derived::_partitioned; };
+            if constexpr (!partitioned) { room_observers_.notify(1U); }
+        }
+    }
+}
+
+template<typename Derived, typename T, typename Wait>
+template<typename Waiters, typename Pred>
+inline auto _channel_ops<Derived, T, Wait>::_park(Waiters &waiters, Pred ready) -> void
+{
+    if constexpr (_instrumented) {
+        const auto start = std::chrono::steady_clock::now();
+        waiters.wait(std::move(ready));
+        stats_.parked(&waiters != &not_empty_, std::chrono::steady_clock::now() - start);
+    } else {
+        waiters.wait(std::move(ready));
+    }
+}
+
+template<typename Derived, typename T, typename Wait>
+template<typename Waiters, typename Pred, typename Clock, typename Duration>
+inline auto _channel_ops<Derived, T, Wait>::_park_until(
+    Waiters &waiters, Pred ready, const std::chrono::time_point<Clock, Duration> &deadline) -> bool
+{
+    if constexpr (_instrumented) {
+        const auto start = std::chrono::steady_clock::now();
+        const auto woken = waiters.wait_until(std::move(ready), deadline);
+        stats_.parked(&waiters != &not_empty_, std::chrono::steady_clock::now() - start);
+        return woken;
+    } else {
+        return waiters.wait_until(std::move(ready), deadline);
+    }
+}
+
+template<typename Derived, typename T, typename Wait>
+template<typename Mutex>
+[[nodiscard]] inline auto _channel_ops<Derived, T, Wait>::_lock(Mutex &mutex) -> std::unique_lock<Mutex>
+{
+    if constexpr (_instrumented) {
+        std::unique_lock lock{ mutex, std::try_to_lock };
+        if (!lock.owns_lock()) {
+            stats_.contended();
+            lock.lock();
+        }
+        return lock;
+    } else {
+        return std::unique_lock{ mutex };
+    }
+}
+
+template<typename Derived, typename T, typename Wait>
+inline auto _channel_ops<Derived, T, Wait>::_contended() noexcept -> void
+{
+    if constexpr (_instrumented) { stats_.contended(); }
+}
+
+template<typename Derived, typename T, typename Wait>
+inline auto _channel_ops<Derived, T, Wait>::_enter(_entry_time_type &entry) noexcept -> void
+{
+    if constexpr (_instrumented) { entry.at = _live_stats::now(); }
+}
+
+template<typename Derived, typename T, typename Wait>
+inline auto _channel_ops<Derived, T, Wait>::_leave(const _entry_time_type &entry) noexcept -> void
+{
+    if constexpr (_instrumented) { stats_.resided(entry.at); }
+}
+
+template<typename Derived, typename T, typename Wait>
+auto _channel_ops<Derived, T, Wait>::_iter::operator++() -> _iter &
+{
+    value_ = channel_->pop();
+    if (!value_.has_value()) { channel_ = nullptr; }
+    return *this;
+}
+
+template<typename Derived, typename T, typename Wait>
+auto _channel_ops<Derived, T, Wait>::_batch_range::_iter::operator++() -> _iter &
+{
+    // refill the buffer with the next batch once the current one is used up
+    index_++;
+    if (index_ >= range_->buffer_.size()) {
+        range_->buffer_.clear();
+        index_ = 0U;
+        if (range_->channel_->pop_many(std::back_inserter(range_->buffer_), range_->batch_size_) == 0U) {
+            range_ = nullptr;
+        }
+    }
+
+    return *this;
+}
+
+}// namespace nrws
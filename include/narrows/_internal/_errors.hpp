@@ -6,6 +6,10 @@ namespace nrws {
 enum class error_id : uint8_t {
     channel_full,
     channel_disconnected,
+    channel_empty,
 };
 
+// Outcome of a non-blocking or timed channel operation
+enum class channel_status : uint8_t { success, full, empty, closed, timeout };
+
 }
@@ -0,0 +1,560 @@
+#pragma once
+
+#include "narrows/_internal/_arch.hpp"
+#include "narrows/_internal/_channel_ops.hpp"
+#include "narrows/_internal/_pool.hpp"
+#include "narrows/wait.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace nrws {
+
+// Lock-free unbounded multi producer/multi consumer queue.
+//
+// This follows the list flavor of crossbeam's channels. Values live in a linked list of blocks
+// of _block_cap slots. Producers and consumers claim positions by advancing tail_ and head_ with
+// a CAS, and only the producer that claims the last slot of a block links in the next one. That
+// block is allocated before the claim, so nobody ever allocates while holding up another thread,
+// and allocation happens once every _block_cap values. Indices count _lap positions per block, the
+// extra position marks "the next block is being installed". The consumer that reads the last slot
+// of a block starts freeing it, and slots that are still being read hand that job over to their
+// reader through the _destroy bit.
+//
+// A slot held by reserve() may stay unwritten for a while, so consumers only claim slots that are
+// already written and find the channel empty otherwise, which keeps try and timed receives from
+// ever waiting on a producer.
+//
+// Freed blocks go to a per channel pool that keeps up to retained_blocks of them, so a channel
+// that has seen its peak load no longer allocates at all.
+//
+// empty() and the claim look at the head slots before claiming them, and by then other consumers may have read
+// the whole block. Consumers count themselves in one of two peekers_ counters while they look, the
+// one picked by the parity of epoch_. A block read to the end goes to retired_, and the consumer
+// that recycles retired blocks first flips epoch_ and waits for the counter of the old parity to
+// drain. Only consumers that started looking before the flip can hold one of those blocks, and
+// each of them only looks for a few instructions.
+template<typename T, typename Wait = park_wait, typename Allocator = std::allocator<std::decay_t<T>>>
+class _list_channel : public _channel_ops<_list_channel<T, Wait, Allocator>, T, Wait>
+{
+    using _base = _channel_ops<_list_channel<T, Wait, Allocator>, T, Wait>;
+    friend _base;
+
+  public:
+    using value_type = std::decay_t<T>;
+    using size_type = std::size_t;
+    using allocator_type = Allocator;
+
+    constexpr static size_type default_retained_blocks = 8U;
+
+    _list_channel() : _list_channel(default_retained_blocks) {}
+    explicit _list_channel(const Allocator &alloc) : _list_channel(default_retained_blocks, alloc) {}
+    explicit _list_channel(const size_type retained_blocks, const Allocator &alloc = Allocator());
+    ~_list_channel();
+
+    _list_channel(const _list_channel &) = delete;
+    _list_channel &operator=(const _list_channel &) = delete;
+
+    // Channel status
+    [[nodiscard]] inline auto size() const noexcept -> size_type;
+    [[nodiscard]] inline auto empty() const noexcept -> bool;
+    [[nodiscard]] constexpr auto full() const noexcept -> bool { return false; }
+
+    // Number of freed blocks currently kept for reuse
+    [[nodiscard]] inline auto pooled_blocks() const noexcept -> size_type { return pool_.pooled(); }
+
+  private:
+    constexpr static size_type _lap = 32U;
+    constexpr static size_type _block_cap = _lap - 1U;
+
+    // indices are shifted up by one, the low bit of head_ is set once the consumer knows the
+    // block after the head block exists, and it can skip checking whether the channel is empty
+    constexpr static size_type _shift = 1U;
+    constexpr static size_type _mark_bit = 1U;
+    constexpr static size_type _one = size_type{ 1U } << _shift;
+
+    // slot states
+    constexpr static unsigned _write = 1U;
+    constexpr static unsigned _read = 2U;
+    constexpr static unsigned _destroy = 4U;
+
+    struct _slot
+    {
+        std::atomic<unsigned> state{ 0U };
+        [[no_unique_address]] typename _base::_entry_time_type entered{};
+        alignas(value_type) std::byte data[sizeof(value_type)];
+    };
+
+    struct _block
+    {
+        std::atomic<_block *> next{ nullptr };
+        _slot slots[_block_cap];
+
+        // spins until the producer that claimed the last slot has linked in the next block
+        [[nodiscard]] inline auto wait_next() const noexcept -> _block *;
+    };
+
+    struct _position
+    {
+        std::atomic<size_type> index{ 0U };
+        std::atomic<_block *> block{ nullptr };
+    };
+
+    // counts the calling consumer in peekers_ for as long as it lives
+    class _peek
+    {
+      public:
+        explicit _peek(const _list_channel &channel) noexcept;
+        ~_peek() { channel_.peekers_[parity_].fetch_sub(1U, std::memory_order_release); }
+
+        _peek(const _peek &) = delete;
+        _peek &operator=(const _peek &) = delete;
+
+      private:
+        const _list_channel &channel_;
+        size_type parity_{ 0U };
+    };
+
+    struct _handle
+    {
+        value_type *value;
+        _block *block;
+        size_type offset;
+    };
+
+    constexpr static bool _bounded = false;
+
+    template<typename... Args>
+    inline auto _try_reserve(Args &&...args) -> std::optional<_handle>;
+    inline auto _commit(_handle &&handle) -> void;
+    inline auto _try_acquire() -> std::optional<_handle>;
+    inline auto _release(_handle &&handle) -> void;
+
+    template<typename It, typename S>
+    inline auto _try_push_many(It &first, const S &last) -> size_type;
+    template<typename Out>
+    inline auto _try_pop_many(Out &out, const size_type max) -> size_type;
+
+    // Claims up to count positions starting at the tail, links in the next block if the claim
+    // reaches the end of the current one. Returns the block, first offset and number claimed.
+    inline auto _claim_tail(const size_type count, size_type &offset) -> std::pair<_block *, size_type>;
+    // Same for the head, only claims slots that are written, returns 0 positions if there are none
+    inline auto _claim_head(const size_type max, size_type &offset) -> std::pair<_block *, size_type>;
+
+    // Marks a slot as written
+    static inline auto _publish(_slot &slot) noexcept -> void;
+
+    // Moves the value out of a claimed slot and releases it
+    inline auto _take_slot(_block *block, const size_type offset) -> value_type;
+    inline auto _destroy_block(_block *block, const size_type start) noexcept -> void;
+    // recycles a block that was read to the end, once no consumer can still be looking at it
+    inline auto _retire(_block *block) noexcept -> void;
+    inline auto _recycle_retired() noexcept -> void;
+
+    [[nodiscard]] static inline auto _value_at(_slot &slot) noexcept -> value_type *;
+
+    // shared by both sides, but only touched once per block
+    _node_pool<_block, Allocator> pool_;
+
+    // consumer side
+    alignas(_cache_line_size) _position head_;
+    std::atomic<size_type> epoch_{ 0U };
+    mutable std::atomic<size_type> peekers_[2]{};
+    std::atomic<_block *> retired_{ nullptr };
+    std::atomic<bool> recycling_{ false };
+
+    // producer side
+    alignas(_cache_line_size) _position tail_;
+};
+
+template<typename T, typename Wait, typename Allocator>
+_list_channel<T, Wait, Allocator>::_list_channel(const size_type retained_blocks, const Allocator &alloc)
+    : pool_(retained_blocks, alloc)
+{
+    auto *block = pool_.acquire();
+    head_.block.store(block, std::memory_order_relaxed);
+    tail_.block.store(block, std::memory_order_relaxed);
+}
+
+template<typename T, typename Wait, typename Allocator>
+_list_channel<T, Wait, Allocator>::~_list_channel()
+{
+    // destroy anything that was never received, and every block that is left
+    auto head = head_.index.load(std::memory_order_acquire) >> _shift;
+    const auto tail = tail_.index.load(std::memory_order_acquire) >> _shift;
+    auto *block = head_.block.load(std::memory_order_acquire);
+
+    for (; head != tail; head++) {
+        const auto offset = head % _lap;
+        if (offset < _block_cap) {
+            std::destroy_at(_value_at(block->slots[offset]));
+        } else {
+            auto *next = block->next.load(std::memory_order_acquire);
+            pool_.release(block);
+            block = next;
+        }
+    }
+
+    pool_.release(block);
+
+    for (auto *retired = retired_.load(std::memory_order_acquire); retired != nullptr;) {
+        auto *next = retired->next.load(std::memory_order_relaxed);
+        pool_.release(retired);
+        retired = next;
+    }
+}
+
+template<typename T, typename Wait, typename Allocator>
+[[nodiscard]] inline auto _list_channel<T, Wait, Allocator>::size() const noexcept -> size_type
+{
+    while (true) {
+        const auto tail = tail_.index.load(std::memory_order_seq_cst);
+        const auto head = head_.index.load(std::memory_order_seq_cst);
+
+        // only a consistent pair of indices gives a meaningful difference
+        if (tail_.index.load(std::memory_order_seq_cst) != tail) { continue; }
+
+        auto t = tail >> _shift;
+        auto h = head >> _shift;
+
+        // an index resting on the end of a block is really at the start of the next one
+        if (t % _lap == _block_cap) { t++; }
+        if (h % _lap == _block_cap) { h++; }
+
+        // every lap skips one position
+        return (t - t / _lap) - (h - h / _lap);
+    }
+}
+
+template<typename T, typename Wait, typename Allocator>
+[[nodiscard]] inline auto _list_channel<T, Wait, Allocator>::empty() const noexcept -> bool
+{
+    // decided by the head slot rather than the indices, so a slot held by reserve() reads as
+    // empty and receivers park on it instead of spinning
+    const _peek peek{ *this };
+
+    while (true) {
+        const auto head = head_.index.load(std::memory_order_seq_cst);
+        const auto *block = head_.block.load(std::memory_order_acquire);
+        const auto offset = (head >> _shift) % _lap;
+
+        // another consumer is moving on to the next block
+        if (offset == _block_cap) {
+            _cpu_relax();
+            continue;
+        }
+
+        const auto written = (block->slots[offset].state.load(std::memory_order_acquire) & _write) != 0U;
+        // the block may have been the one before head
+        if (head_.index.load(std::memory_order_relaxed) == head) { return !written; }
+    }
+}
+
+template<typename T, typename Wait, typename Allocator>
+template<typename... Args>
+inline auto _list_channel<T, Wait, Allocator>::_try_reserve(Args &&...args) -> std::optional<_handle>
+{
+    size_type offset = 0U;
+    auto *block = _claim_tail(1U, offset).first;
+
+    auto *value = std::construct_at(_value_at(block->slots[offset]), std::forward<Args>(args)...);
+    return _handle{ value, block, offset };
+}
+
+template<typename T, typename Wait, typename Allocator>
+inline auto _list_channel<T, Wait, Allocator>::_commit(_handle &&handle) -> void
+{
+    auto &slot = handle.block->slots[handle.offset];
+    this->_enter(slot.entered);
+    _publish(slot);
+}
+
+template<typename T, typename Wait, typename Allocator>
+inline auto _list_channel<T, Wait, Allocator>::_try_acquire() -> std::optional<_handle>
+{
+    size_type offset = 0U;
+    const auto [block, count] = _claim_head(1U, offset);
+    if (count == 0U) { return std::nullopt; }
+
+    return _handle{ _value_at(block->slots[offset]), block, offset };
+}
+
+template<typename T, typename Wait, typename Allocator>
+inline auto _list_channel<T, Wait, Allocator>::_release(_handle &&handle) -> void
+{
+    this->_leave(handle.block->slots[handle.offset].entered);
+    std::destroy_at(handle.value);
+
+    // the reader of the last slot starts freeing the block, a slot that was still being read
+    // when it got there continues from the next one
+    if (handle.offset + 1U == _block_cap) {
+        _destroy_block(handle.block, 0U);
+    } else if ((handle.block->slots[handle.offset].state.fetch_or(_read, std::memory_order_acq_rel) & _destroy) != 0U) {
+        _destroy_block(handle.block, handle.offset + 1U);
+    }
+}
+
+template<typename T, typename Wait, typename Allocator>
+template<typename It, typename S>
+inline auto _list_channel<T, Wait, Allocator>::_try_push_many(It &first, const S &last) -> size_type
+{
+    size_type pushed = 0U;
+
+    while (first != last) {
+        // without knowing how many values are left, positions can only be claimed one at a time
+        size_type wanted = 1U;
+        if constexpr (std::sized_sentinel_for<S, It>) { wanted = static_cast<size_type>(last - first); }
+
+        size_type offset = 0U;
+        const auto [block, count] = _claim_tail(wanted, offset);
+
+        for (size_type i = 0U; i < count; i++, ++first) {
+            auto &slot = block->slots[offset + i];
+            std::construct_at(_value_at(slot), *first);
+            this->_enter(slot.entered);
+            _publish(slot);
+        }
+        pushed += count;
+    }
+
+    return pushed;
+}
+
+template<typename T, typename Wait, typename Allocator>
+template<typename Out>
+inline auto _list_channel<T, Wait, Allocator>::_try_pop_many(Out &out, const size_type max) -> size_type
+{
+    size_type popped = 0U;
+
+    while (popped < max) {
+        size_type offset = 0U;
+        const auto [block, count] = _claim_head(max - popped, offset);
+        if (count == 0U) { break; }
+
+        // the block may be freed by the last read, so nothing touches it afterwards
+        for (size_type i = 0U; i < count; i++, ++out) { *out = _take_slot(block, offset + i); }
+        popped += count;
+    }
+
+    return popped;
+}
+
+template<typename T, typename Wait, typename Allocator>
+inline auto _list_channel<T, Wait, Allocator>::_claim_tail(const size_type count, size_type &offset) -> std::pair<_block *, size_type>
+{
+    auto tail = tail_.index.load(std::memory_order_acquire);
+    auto *block = tail_.block.load(std::memory_order_acquire);
+    _block *next_block = nullptr;
+
+    while (true) {
+        offset = (tail >> _shift) % _lap;
+
+        // another producer is linking in the next block
+        if (offset == _block_cap) {
+            _cpu_relax();
+            tail = tail_.index.load(std::memory_order_acquire);
+            block = tail_.block.load(std::memory_order_acquire);
+            continue;
+        }
+
+        // the next block is allocated before the claim, so the claim never waits on the allocator
+        const auto claimed = std::min(count, _block_cap - offset);
+        const auto ends_block = offset + claimed == _block_cap;
+        if (ends_block && next_block == nullptr) { next_block = pool_.acquire(); }
+
+        const auto new_tail = tail + claimed * _one;
+        if (tail_.index.compare_exchange_weak(tail, new_tail, std::memory_order_seq_cst, std::memory_order_acquire)) {
+            if (ends_block) {
+                tail_.block.store(next_block, std::memory_order_release);
+                tail_.index.store(new_tail + _one, std::memory_order_release);
+                block->next.store(next_block, std::memory_order_release);
+            } else if (next_block != nullptr) {
+                // another producer linked in the next block first
+                pool_.release(next_block);
+            }
+            return { block, claimed };
+        }
+
+        this->_contended();
+        block = tail_.block.load(std::memory_order_acquire);
+    }
+}
+
+template<typename T, typename Wait, typename Allocator>
+inline auto _list_channel<T, Wait, Allocator>::_claim_head(const size_type max, size_type &offset) -> std::pair<_block *, size_type>
+{
+    const _peek peek{ *this };
+
+    auto head = head_.index.load(std::memory_order_acquire);
+    auto *block = head_.block.load(std::memory_order_acquire);
+
+    while (true) {
+        offset = (head >> _shift) % _lap;
+
+        // another consumer is moving on to the next block
+        if (offset == _block_cap) {
+            _cpu_relax();
+            head = head_.index.load(std::memory_order_acquire);
+            block = head_.block.load(std::memory_order_acquire);
+            continue;
+        }
+
+        auto claimed = std::min(max, _block_cap - offset);
+        auto mark = head & _mark_bit;
+
+        if (mark == 0U) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const auto tail = tail_.index.load(std::memory_order_relaxed) >> _shift;
+            const auto position = head >> _shift;
+
+            if (position == tail) { return { block, 0U }; }
+
+            // the tail is in a later block, every slot left in this one has been claimed
+            if (position / _lap != tail / _lap) {
+                mark = _mark_bit;
+            } else {
+                claimed = std::min(claimed, tail - position);
+            }
+        }
+
+        // stop at the first slot that isn't written yet
+        size_type written = 0U;
+        while (written < claimed && (block->slots[offset + written].state.load(std::memory_order_acquire) & _write) != 0U) {
+            written++;
+        }
+        if (written == 0U) {
+            // only empty if head hasn't moved while the slots were read
+            const auto current = head_.index.load(std::memory_order_acquire);
+            if (current == head) { return { block, 0U }; }
+
+            head = current;
+            block = head_.block.load(std::memory_order_acquire);
+            continue;
+        }
+        claimed = written;
+
+        const auto new_head = ((head & ~_mark_bit) + claimed * _one) | mark;
+        if (head_.index.compare_exchange_weak(head, new_head, std::memory_order_seq_cst, std::memory_order_acquire)) {
+            if (offset + claimed == _block_cap) {
+                auto *next = block->wait_next();
+                auto next_index = (new_head & ~_mark_bit) + _one;
+                if (next->next.load(std::memory_order_relaxed) != nullptr) { next_index |= _mark_bit; }
+
+                head_.block.store(next, std::memory_order_release);
+                head_.index.store(next_index, std::memory_order_release);
+            }
+            return { block, claimed };
+        }
+
+        this->_contended();
+        block = head_.block.load(std::memory_order_acquire);
+    }
+}
+
+template<typename T, typename Wait, typename Allocator>
+inline auto _list_channel<T, Wait, Allocator>::_take_slot(_block *block, const size_type offset) -> value_type
+{
+    _handle handle{ _value_at(block->slots[offset]), block, offset };
+    value_type value{ std::move(*handle.value) };
+    _release(std::move(handle));
+    return value;
+}
+
+template<typename T, typename Wait, typename Allocator>
+inline auto _list_channel<T, Wait, Allocator>::_destroy_block(_block *block, const size_type start) noexcept -> void
+{
+    // the last slot is never checked, its reader is the one that started destroying the block
+    for (auto offset = start; offset < _block_cap - 1U; offset++) {
+        auto &slot = block->slots[offset];
+
+        // a reader that hasn't finished will see the _destroy bit and take over
+        if ((slot.state.load(std::memory_order_acquire) & _read) == 0U
+            && (slot.state.fetch_or(_destroy, std::memory_order_acq_rel) & _read) == 0U) {
+            return;
+        }
+    }
+
+    _retire(block);
+}
+
+template<typename T, typename Wait, typename Allocator>
+inline auto _list_channel<T, Wait, Allocator>::_retire(_block *block) noexcept -> void
+{
+    // nobody reads next anymore once a block was read to the end
+    auto *top = retired_.load(std::memory_order_relaxed);
+    do {
+        block->next.store(top, std::memory_order_relaxed);
+    } while (!retired_.compare_exchange_weak(top, block, std::memory_order_release, std::memory_order_relaxed));
+
+    // one consumer recycles at a time, the others leave their block for it or the next one
+    if (!recycling_.exchange(true, std::memory_order_acquire)) {
+        _recycle_retired();
+        recycling_.store(false, std::memory_order_release);
+    }
+}
+
+template<typename T, typename Wait, typename Allocator>
+inline auto _list_channel<T, Wait, Allocator>::_recycle_retired() noexcept -> void
+{
+    auto *retired = retired_.exchange(nullptr, std::memory_order_acquire);
+
+    // consumers that start looking from now on count in the other parity, and can't find these
+    // blocks since the head is past all of them
+    const auto parity = epoch_.fetch_add(1U, std::memory_order_seq_cst) & 1U;
+    while (peekers_[parity].load(std::memory_order_acquire) != 0U) { _cpu_relax(); }
+
+    while (retired != nullptr) {
+        auto *next = retired->next.load(std::memory_order_relaxed);
+        pool_.release(retired);
+        retired = next;
+    }
+}
+
+template<typename T, typename Wait, typename Allocator>
+_list_channel<T, Wait, Allocator>::_peek::_peek(const _list_channel &channel) noexcept : channel_(channel)
+{
+    // the epoch may flip between picking a counter and joining it, the recycler then doesn't wait
+    // for us, so look again under the new parity
+    while (true) {
+        parity_ = channel_.epoch_.load(std::memory_order_seq_cst) & 1U;
+        channel_.peekers_[parity_].fetch_add(1U, std::memory_order_seq_cst);
+        if ((channel_.epoch_.load(std::memory_order_seq_cst) & 1U) == parity_) { return; }
+        channel_.peekers_[parity_].fetch_sub(1U, std::memory_order_relaxed);
+    }
+}
+
+template<typename T, typename Wait, typename Allocator>
+inline auto _list_channel<T, Wait, Allocator>::_publish(_slot &slot) noexcept -> void
+{
+    slot.state.fetch_or(_write, std::memory_order_release);
+}
+
+template<typename T, typename Wait, typename Allocator>
+[[nodiscard]] inline auto _list_channel<T, Wait, Allocator>::_block::wait_next() const noexcept -> _block *
+{
+    for (int spin = 0;; spin++) {
+        if (auto *next_block = next.load(std::memory_order_acquire)) { return next_block; }
+
+        if (spin < 64) {
+            _cpu_relax();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+template<typename T, typename Wait, typename Allocator>
+[[nodiscard]] inline auto _list_channel<T, Wait, Allocator>::_value_at(_slot &slot) noexcept -> value_type *
+{
+    return std::launder(reinterpret_cast<value_type *>(slot.data));
+}
+
+}// namespace nrws
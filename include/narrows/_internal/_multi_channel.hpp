@@ -39,7 +39,7 @@ class _multi_channel
     // Iterator type
     class _iter
     {
-        using value_type = value_type;
+        using value_type = _multi_channel::value_type;
 
         _iter(_multi_channel &mc) : mc_(mc) {}
 
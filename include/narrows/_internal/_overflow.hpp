@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace nrws {
+
+// Overflow policies, what a bounded_channel does with a value that arrives while it is full.
+//
+// Every policy but block_on_full makes the channel lossy: sends never wait for room and always
+// succeed, and the channel counts what it threw away in dropped() and conflated() instead.
+
+// The sender waits for room, nothing is lost
+struct block_on_full
+{
+};
+
+// The new value is dropped, the values already in the channel are kept
+struct drop_newest
+{
+};
+
+// The oldest value still in the channel is evicted to make room for the new one
+struct overwrite_oldest
+{
+};
+
+// A value replaces the pending value with the same key in place, so a slow receiver only sees the
+// latest value per key. KeyOf is a default constructible callable returning the key of a value,
+// e.g. conflate<decltype([](const quote &q) { return q.symbol; })>. A value with a new key that
+// arrives while the channel is full evicts the oldest value, as with overwrite_oldest.
+template<typename KeyOf>
+struct conflate
+{
+    using key_of = KeyOf;
+};
+
+template<typename Overflow>
+struct _overflow_traits
+{
+    constexpr static bool lossy = !std::is_same_v<Overflow, block_on_full>;
+    constexpr static bool conflating = false;
+};
+
+template<typename KeyOf>
+struct _overflow_traits<conflate<KeyOf>>
+{
+    constexpr static bool lossy = true;
+    constexpr static bool conflating = true;
+};
+
+// a lossy channel that doesn't conflate keeps no key index
+struct _no_key_index
+{
+    template<typename Allocator>
+    explicit _no_key_index(const Allocator & /*alloc*/) noexcept
+    {}
+};
+
+// maps the key of every pending value to its slot, from the channel's allocator
+template<typename Overflow, typename V, typename Allocator>
+struct _key_index
+{
+    using type = _no_key_index;
+};
+
+template<typename KeyOf, typename V, typename Allocator>
+struct _key_index<conflate<KeyOf>, V, Allocator>
+{
+    using key_type = std::decay_t<std::invoke_result_t<KeyOf, const V &>>;
+    using type = std::unordered_map<key_type,
+        std::size_t,
+        std::hash<key_type>,
+        std::equal_to<key_type>,
+        typename std::allocator_traits<Allocator>::template rebind_alloc<std::pair<const key_type, std::size_t>>>;
+};
+
+}// namespace nrws
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+
+namespace nrws {
+
+// Lock-free free list that recycles the nodes of one channel.
+//
+// Released nodes are destroyed and their storage is pushed onto a stack instead of going back
+// to the allocator, up to retain of them. Pushing a node is a plain CAS, but a CAS based pop would
+// suffer from ABA since the same nodes keep coming back. acquire() takes the whole stack with an
+// exchange instead and pushes the rest back, so a concurrent acquire may find it empty and fall
+// back to allocating. That's fine for a channel, which only acquires once per block of values.
+template<typename Node, typename Allocator>
+class _node_pool
+{
+  public:
+    using allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+    using size_type = std::size_t;
+
+    _node_pool(const size_type retain, const Allocator &alloc) : retain_(retain), alloc_(alloc) {}
+    ~_node_pool();
+
+    _node_pool(const _node_pool &) = delete;
+    _node_pool &operator=(const _node_pool &) = delete;
+
+    // Returns a value-initialized node, only allocates if no storage is pooled
+    [[nodiscard]] inline auto acquire() -> Node *;
+    // Destroys the node and keeps its storage, unless retain nodes are already pooled
+    inline auto release(Node *node) noexcept -> void;
+
+    [[nodiscard]] inline auto pooled() const noexcept -> size_type { return count_.load(std::memory_order_relaxed); }
+    [[nodiscard]] inline auto retain() const noexcept -> size_type { return retain_; }
+
+  private:
+    using _traits = std::allocator_traits<allocator_type>;
+
+    // lives in the storage of a pooled node
+    struct _link
+    {
+        _link *next;
+    };
+    static_assert(sizeof(Node) >= sizeof(_link) && alignof(Node) >= alignof(_link), "A node must be able to hold a link");
+
+    inline auto _push(_link *first, _link *last) noexcept -> void;
+
+    std::atomic<_link *> head_{ nullptr };
+    std::atomic<size_type> count_{ 0U };
+    size_type retain_;
+    allocator_type alloc_;
+};
+
+template<typename Node, typename Allocator>
+_node_pool<Node, Allocator>::~_node_pool()
+{
+    auto *link = head_.load(std::memory_order_acquire);
+    while (link != nullptr) {
+        auto *next = link->next;
+        _traits::deallocate(alloc_, static_cast<Node *>(static_cast<void *>(link)), 1U);
+        link = next;
+    }
+}
+
+template<typename Node, typename Allocator>
+[[nodiscard]] inline auto _node_pool<Node, Allocator>::acquire() -> Node *
+{
+    auto *link = head_.exchange(nullptr, std::memory_order_acquire);
+
+    Node *node = nullptr;
+    if (link == nullptr) {
+        node = _traits::allocate(alloc_, 1U);
+    } else {
+        count_.fetch_sub(1U, std::memory_order_relaxed);
+
+        // hand the rest of the stack back
+        if (auto *rest = link->next; rest != nullptr) {
+            auto *last = rest;
+            while (last->next != nullptr) { last = last->next; }
+            _push(rest, last);
+        }
+
+        node = static_cast<Node *>(static_cast<void *>(link));
+    }
+
+    _traits::construct(alloc_, node);
+    return node;
+}
+
+template<typename Node, typename Allocator>
+inline auto _node_pool<Node, Allocator>::release(Node *node) noexcept -> void
+{
+    _traits::destroy(alloc_, node);
+
+    if (count_.fetch_add(1U, std::memory_order_relaxed) >= retain_) {
+        count_.fetch_sub(1U, std::memory_order_relaxed);
+        _traits::deallocate(alloc_, node, 1U);
+        return;
+    }
+
+    auto *link = ::new (static_cast<void *>(node)) _link{ nullptr };
+    _push(link, link);
+}
+
+template<typename Node, typename Allocator>
+inline auto _node_pool<Node, Allocator>::_push(_link *first, _link *last) noexcept -> void
+{
+    last->next = head_.load(std::memory_order_relaxed);
+    while (!head_.compare_exchange_weak(last->next, first, std::memory_order_release, std::memory_order_relaxed)) {}
+}
+
+}// namespace nrws
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace nrws {
+
+// Wakes a thread blocked in a select once any of the channels it watches changed.
+//
+// Like _waiter_set, untimed waits park on std::atomic::wait and waits with a deadline sleep on a
+// condition variable, which notifiers only touch while someone is actually asleep on it.
+class _select_signal
+{
+  public:
+    // Read before the last check of the watched channels, any change after it bumps the epoch
+    [[nodiscard]] inline auto epoch() const noexcept -> std::uint32_t { return epoch_.load(std::memory_order_acquire); }
+
+    // Blocks until the epoch moves on from epoch (or the deadline passes, then returns false)
+    inline auto wait(const std::uint32_t epoch) -> void { epoch_.wait(epoch, std::memory_order_acquire); }
+    template<typename Clock, typename Duration>
+    inline auto wait_until(const std::uint32_t epoch, const std::chrono::time_point<Clock, Duration> &deadline) -> bool;
+
+    inline auto notify() noexcept -> void;
+
+  private:
+    std::atomic<std::uint32_t> epoch_{ 0U };
+    std::atomic<bool> timed_{ false };
+
+    std::mutex timed_mutex_;
+    std::condition_variable timed_cv_;
+};
+
+// The selects and suspended coroutines watching one channel for one kind of change.
+//
+// Nodes live in whatever registered them, so watching a channel never allocates. A channel calls
+// notify() after every change a watcher might be waiting for, which is only a fence and a load
+// while nobody is watching.
+//
+// wake(context) is called under the list's lock and returns whether the node took the change, as
+// a suspended coroutine does when it starts an attempt at its operation. Watchers that only look
+// (selects, ready_fd) return false and are woken by every notify, while notify(count) stops once
+// count nodes took the change. Nodes are woken in the order they were added.
+class _observer_list
+{
+  public:
+    struct node
+    {
+        bool (*wake)(void *context) noexcept { nullptr };
+        void *context{ nullptr };
+        node *prev{ nullptr };
+        node *next{ nullptr };
+    };
+
+    inline auto add(node &observer) -> void;
+    inline auto remove(node &observer) -> void;
+
+    // Must be called after the state the watchers look at has been changed
+    inline auto notify() noexcept -> void { notify(SIZE_MAX); }
+    inline auto notify(std::size_t count) noexcept -> void;
+
+  private:
+    std::atomic<std::uint32_t> count_{ 0U };
+    std::mutex mutex_;
+    node *head_{ nullptr };
+    node *tail_{ nullptr };
+};
+
+template<typename Clock, typename Duration>
+inline auto _select_signal::wait_until(const std::uint32_t epoch, const std::chrono::time_point<Clock, Duration> &deadline)
+    -> bool
+{
+    std::unique_lock lock{ timed_mutex_ };
+    timed_.store(true, std::memory_order_seq_cst);
+
+    // a notifier bumps the epoch before looking at timed_, so it either sees us or we see it
+    const auto woken = timed_cv_.wait_until(
+        lock, deadline, [this, epoch]() { return epoch_.load(std::memory_order_acquire) != epoch; });
+
+    timed_.store(false, std::memory_order_relaxed);
+    return woken;
+}
+
+inline auto _select_signal::notify() noexcept -> void
+{
+    epoch_.fetch_add(1U, std::memory_order_seq_cst);
+    epoch_.notify_one();
+
+    if (timed_.load(std::memory_order_seq_cst)) {
+        { std::lock_guard lock{ timed_mutex_ }; }
+        timed_cv_.notify_all();
+    }
+}
+
+inline auto _observer_list::add(node &observer) -> void
+{
+    std::lock_guard lock{ mutex_ };
+
+    observer.prev = tail_;
+    observer.next = nullptr;
+    if (tail_ != nullptr) {
+        tail_->next = &observer;
+    } else {
+        head_ = &observer;
+    }
+    tail_ = &observer;
+
+    // ordered before the select checks the channel again
+    count_.fetch_add(1U, std::memory_order_seq_cst);
+}
+
+inline auto _observer_list::remove(node &observer) -> void
+{
+    std::lock_guard lock{ mutex_ };
+
+    if (observer.prev != nullptr) {
+        observer.prev->next = observer.next;
+    } else {
+        head_ = observer.next;
+    }
+    if (observer.next != nullptr) {
+        observer.next->prev = observer.prev;
+    } else {
+        tail_ = observer.prev;
+    }
+    observer.prev = observer.next = nullptr;
+
+    count_.fetch_sub(1U, std::memory_order_relaxed);
+}
+
+inline auto _observer_list::notify(std::size_t count) noexcept -> void
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (count_.load(std::memory_order_relaxed) == 0U) { return; }
+
+    std::lock_guard lock{ mutex_ };
+    for (auto *observer = head_; observer != nullptr && count != 0U; observer = observer->next) {
+        if (observer->wake(observer->context)) { count--; }
+    }
+}
+
+}// namespace nrws
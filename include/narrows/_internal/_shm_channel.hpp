@@ -0,0 +1,699 @@
+#pragma once
+
+#if defined(__linux__)
+
+#include "narrows/_internal/_arch.hpp"
+#include "narrows/_internal/_channel_ops.hpp"
+#include "narrows/concepts.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace nrws {
+
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free && std::atomic<std::uint64_t>::is_always_lock_free,
+    "Shared memory channels need atomics that work across processes");
+
+// Blocks while word holds expected, for at most timeout. Unlike std::atomic::wait this doesn't
+// use a private futex, so it is woken by a process that maps the same memory. Returns false if
+// the timeout passed.
+inline auto _futex_wait(std::atomic<std::uint32_t> &word,
+    const std::uint32_t expected,
+    const std::chrono::nanoseconds timeout) noexcept -> bool
+{
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+    timespec relative{};
+    relative.tv_sec = seconds.count();
+    relative.tv_nsec = (timeout - seconds).count();
+
+    const auto result =
+        ::syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&word), FUTEX_WAIT, expected, &relative, nullptr, 0);
+    return result == 0 || errno != ETIMEDOUT;
+}
+
+inline auto _futex_wake(std::atomic<std::uint32_t> &word, const int count) noexcept -> void
+{
+    ::syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&word), FUTEX_WAKE, count, nullptr, nullptr, 0);
+}
+
+// The futex words of one waiter set of a shared memory channel, they live in the segment
+struct _shm_waiters
+{
+    std::atomic<std::uint32_t> epoch{ 0U };
+    std::atomic<std::uint32_t> waiters{ 0U };
+};
+
+// Waiter set of a shared memory channel, with the same protocol as _waiter_set but parked on a
+// futex in the segment so threads of every process that attached can wake each other.
+//
+// A waiter never sleeps for longer than _liveness_interval. Every time it wakes up it calls back
+// into its channel, which picks up a close by another process and, after a timeout, checks that
+// the other side is still there.
+class _shm_waiter_set
+{
+  public:
+    // called after every sleep, timed_out is true if nobody woke us
+    using poll_type = void (*)(void *context, bool timed_out) noexcept;
+
+    // Must be called before anyone waits or notifies
+    inline auto _bind(_shm_waiters &shared, poll_type poll, void *context) noexcept -> void
+    {
+        shared_ = &shared;
+        poll_ = poll;
+        context_ = context;
+    }
+
+    template<typename Pred>
+    inline auto wait(Pred ready) -> void;
+
+    template<typename Pred, typename Clock, typename Duration>
+    inline auto wait_until(Pred ready, const std::chrono::time_point<Clock, Duration> &deadline) -> bool;
+
+    inline auto notify_one() noexcept -> void { _wake(1); }
+    inline auto notify_all() noexcept -> void { _wake(INT_MAX); }
+
+  private:
+    constexpr static int _spin_limit = 64;
+    constexpr static int _yield_limit = 8;
+    constexpr static std::chrono::milliseconds _liveness_interval{ 50 };
+
+    template<typename Pred>
+    inline auto _spin(Pred ready) -> bool;
+    template<typename Pred>
+    inline auto _sleep(Pred ready, std::chrono::nanoseconds timeout) -> bool;
+    inline auto _wake(int count) noexcept -> void;
+
+    _shm_waiters *shared_{ nullptr };
+    poll_type poll_{ nullptr };
+    void *context_{ nullptr };
+};
+
+// the wait policy of shm_channel, it can't be swapped for another one
+struct _shm_wait
+{
+    using waiter_set = _shm_waiter_set;
+};
+static_assert(is_wait_policy<_shm_wait>, "Must satisfy the wait policy concept");
+
+// which side of the channel a handle attached as
+enum class _shm_side : std::uint8_t { sender, receiver };
+
+// Start of the segment, followed by the slots
+struct _shm_header
+{
+    // written last by the creator, attachers wait for it
+    std::atomic<std::uint64_t> magic{ 0U };
+    std::uint64_t value_size{ 0U };
+    std::uint64_t value_align{ 0U };
+    std::uint64_t capacity{ 0U };
+
+    // rarely written, read by both sides. attached is set once a sender or receiver attached, so
+    // a side that is gone can be told from one that isn't there yet.
+    alignas(_cache_line_size) std::atomic<std::uint32_t> closed{ 0U };
+    std::atomic<std::uint32_t> lost{ 0U };
+    std::atomic<std::uint32_t> attached[2]{};
+
+    alignas(_cache_line_size) _shm_waiters not_full;
+    alignas(_cache_line_size) _shm_waiters not_empty;
+
+    // producer side
+    alignas(_cache_line_size) std::atomic<std::uint64_t> head{ 0U };
+
+    // consumer side
+    alignas(_cache_line_size) std::atomic<std::uint64_t> tail{ 0U };
+};
+
+// "nrwsshm" and the layout version
+inline constexpr std::uint64_t _shm_magic = 0x6e72777373686d01U;
+
+// Bounded multi producer/multi consumer channel in a named POSIX shared memory segment.
+//
+// The ring is the same lock-free queue as _array_channel, with its positions and stamps in the
+// segment. Values are copied in and out as plain bytes, so T must be trivially copyable and can't
+// point into the memory of one process. Each handle is local to its process and maps the segment
+// on its own, only the segment is shared.
+//
+// Every attached handle holds a shared open file description lock on the byte of its side. The
+// kernel drops it when the process exits, however that happens, so a waiter that doesn't hear
+// from the other side checks whether anyone still holds that lock. Once every sender or every
+// receiver is gone without closing, the channel is closed and peer_lost() returns true. A sender
+// that dies between claiming and writing a slot leaves a hole that receivers can't pass.
+template<typename T>
+class _shm_channel : public _channel_ops<_shm_channel<T>, T, _shm_wait>
+{
+    using _base = _channel_ops<_shm_channel<T>, T, _shm_wait>;
+    friend _base;
+
+  public:
+    using value_type = std::decay_t<T>;
+    using size_type = std::size_t;
+
+    static_assert(std::is_trivially_copyable_v<value_type>, "Only trivially copyable values can be shared");
+
+    // Creates the segment under name, replacing any segment a creator left behind, and attaches
+    // to it. The capacity is rounded up to a power of two. The name is removed again when this
+    // handle is destroyed, handles that attached keep working.
+    _shm_channel(const std::string &name, size_type capacity, _shm_side side);
+    // Attaches to the segment another handle created under name. Throws std::system_error if
+    // there is none or it holds values of another size or alignment.
+    _shm_channel(const std::string &name, _shm_side side);
+    ~_shm_channel();
+
+    _shm_channel(const _shm_channel &) = delete;
+    _shm_channel &operator=(const _shm_channel &) = delete;
+
+    // Channel status
+    [[nodiscard]] inline auto size() const noexcept -> size_type;
+    [[nodiscard]] inline auto empty() const noexcept -> bool;
+    [[nodiscard]] inline auto full() const noexcept -> bool;
+    [[nodiscard]] inline auto capacity() const noexcept -> size_type { return mask_ + 1U; }
+
+    // Closes the channel in every process
+    inline auto close() -> void;
+
+    // true once the channel was closed because every sender or every receiver went away
+    [[nodiscard]] inline auto peer_lost() const noexcept -> bool
+    {
+        return header_->lost.load(std::memory_order_acquire) != 0U;
+    }
+
+  private:
+    struct _slot
+    {
+        std::atomic<std::uint64_t> stamp{ 0U };
+        alignas(value_type) std::byte data[sizeof(value_type)];
+    };
+
+    struct _place
+    {
+        _slot *slot;
+        std::uint64_t free;// stamp of the slot while it is free during this lap, +1 once written
+    };
+
+    struct _handle
+    {
+        value_type *value;
+        _slot *slot;
+        std::uint64_t free;
+    };
+
+    constexpr static bool _bounded = true;
+    constexpr static size_type _slots_offset =
+        (sizeof(_shm_header) + alignof(_slot) - 1U) / alignof(_slot) * alignof(_slot);
+    // how long an attacher waits for the creator to set the segment up
+    constexpr static std::chrono::seconds _attach_timeout{ 1 };
+
+    template<typename... Args>
+    inline auto _try_reserve(Args &&...args) -> std::optional<_handle>;
+    inline auto _commit(_handle &&handle) -> void;
+    inline auto _try_acquire() -> std::optional<_handle>;
+    inline auto _release(_handle &&handle) -> void;
+
+    template<typename It, typename S>
+    inline auto _try_push_many(It &first, const S &last) -> size_type;
+    template<typename Out>
+    inline auto _try_pop_many(Out &out, const size_type max) -> size_type;
+
+    // segment setup, _fail cleans up what was set up so far and throws
+    inline auto _create(size_type capacity) -> void;
+    inline auto _attach() -> void;
+    inline auto _map(size_type size) -> void;
+    inline auto _join() -> void;
+    [[noreturn]] inline auto _fail(const char *what, int error) -> void;
+
+    // picks up a close by another process, true if the channel is closed
+    inline auto _sync() noexcept -> bool;
+    [[nodiscard]] inline auto _peer_attached() const noexcept -> bool;
+    static inline auto _poll(void *context, bool timed_out) noexcept -> void;
+
+    [[nodiscard]] inline auto _locate(const std::uint64_t position) const noexcept -> _place;
+    [[nodiscard]] static inline auto _value_at(_slot &slot) noexcept -> value_type *;
+
+    // read only after construction
+    std::string name_;
+    _shm_side side_;
+    bool owner_{ false };
+    int fd_{ -1 };
+    void *mapping_{ MAP_FAILED };
+    size_type mapping_size_{ 0U };
+    _shm_header *header_{ nullptr };
+    _slot *slots_{ nullptr };
+    std::uint64_t mask_{ 0U };
+    std::uint64_t shift_{ 0U };
+};
+
+/* Shm Waiter Set Implementations */
+
+template<typename Pred>
+inline auto _shm_waiter_set::_spin(Pred ready) -> bool
+{
+    for (int spin = 0; spin < _spin_limit; spin++) {
+        if (ready()) { return true; }
+        _cpu_relax();
+    }
+
+    for (int yield = 0; yield < _yield_limit; yield++) {
+        if (ready()) { return true; }
+        std::this_thread::yield();
+    }
+
+    return false;
+}
+
+template<typename Pred>
+inline auto _shm_waiter_set::_sleep(Pred ready, const std::chrono::nanoseconds timeout) -> bool
+{
+    shared_->waiters.fetch_add(1U, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // read the epoch before the last check, any notify after that check bumps it
+    const auto epoch = shared_->epoch.load(std::memory_order_acquire);
+    auto woken = true;
+    if (!ready()) { woken = _futex_wait(shared_->epoch, epoch, timeout); }
+
+    shared_->waiters.fetch_sub(1U, std::memory_order_relaxed);
+    return woken;
+}
+
+template<typename Pred>
+inline auto _shm_waiter_set::wait(Pred ready) -> void
+{
+    if (_spin(ready)) { return; }
+
+    while (!ready()) {
+        const auto timed_out = !_sleep(ready, _liveness_interval);
+        poll_(context_, timed_out);
+    }
+}
+
+template<typename Pred, typename Clock, typename Duration>
+inline auto _shm_waiter_set::wait_until(Pred ready, const std::chrono::time_point<Clock, Duration> &deadline) -> bool
+{
+    if (_spin(ready)) { return true; }
+
+    while (!ready()) {
+        const auto left = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - Clock::now());
+        if (left <= std::chrono::nanoseconds::zero()) { return ready(); }
+
+        const auto timed_out = !_sleep(ready, std::min<std::chrono::nanoseconds>(left, _liveness_interval));
+        poll_(context_, timed_out);
+    }
+
+    return true;
+}
+
+inline auto _shm_waiter_set::_wake(const int count) noexcept -> void
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (shared_->waiters.load(std::memory_order_relaxed) != 0U) {
+        shared_->epoch.fetch_add(1U, std::memory_order_seq_cst);
+        _futex_wake(shared_->epoch, count);
+    }
+}
+
+/* Shm Channel Implementations */
+
+template<typename T>
+_shm_channel<T>::_shm_channel(const std::string &name, const size_type capacity, const _shm_side side)
+    : name_(name), side_(side)
+{
+    _create(capacity);
+    _join();
+}
+
+template<typename T>
+_shm_channel<T>::_shm_channel(const std::string &name, const _shm_side side) : name_(name), side_(side)
+{
+    _attach();
+    _join();
+}
+
+template<typename T>
+_shm_channel<T>::~_shm_channel()
+{
+    // the mapping holds on to the open file description as well, so it goes first for the lock
+    // to be released
+    ::munmap(mapping_, mapping_size_);
+    ::close(fd_);
+    if (owner_) { ::shm_unlink(name_.c_str()); }
+}
+
+template<typename T>
+inline auto _shm_channel<T>::_create(const size_type capacity) -> void
+{
+    // a segment under this name was left behind by a creator that is gone
+    ::shm_unlink(name_.c_str());
+
+    fd_ = ::shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd_ < 0) { _fail("shm_open", errno); }
+    owner_ = true;
+
+    const auto slots = _next_power_of_two(std::max(capacity, size_type{ 1U }));
+    const auto size = _slots_offset + slots * sizeof(_slot);
+    if (::ftruncate(fd_, static_cast<off_t>(size)) != 0) { _fail("ftruncate", errno); }
+    _map(size);
+
+    // the segment starts out zeroed, which is what every stamp and counter starts at
+    header_ = std::construct_at(static_cast<_shm_header *>(mapping_));
+    header_->value_size = sizeof(value_type);
+    header_->value_align = alignof(value_type);
+    header_->capacity = slots;
+    header_->magic.store(_shm_magic, std::memory_order_release);
+}
+
+template<typename T>
+inline auto _shm_channel<T>::_attach() -> void
+{
+    fd_ = ::shm_open(name_.c_str(), O_RDWR, 0);
+    if (fd_ < 0) { _fail("shm_open", errno); }
+
+    // the creator may still be setting the segment up, it is sized before the header is written
+    const auto deadline = std::chrono::steady_clock::now() + _attach_timeout;
+    struct stat info{};
+    while (true) {
+        if (::fstat(fd_, &info) != 0) { _fail("fstat", errno); }
+        if (static_cast<size_type>(info.st_size) >= _slots_offset) { break; }
+        if (std::chrono::steady_clock::now() >= deadline) { _fail("shm_channel attach", ETIMEDOUT); }
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+    }
+    _map(static_cast<size_type>(info.st_size));
+
+    header_ = std::launder(static_cast<_shm_header *>(mapping_));
+    while (header_->magic.load(std::memory_order_acquire) != _shm_magic) {
+        if (std::chrono::steady_clock::now() >= deadline) { _fail("shm_channel attach", ETIMEDOUT); }
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+    }
+
+    const auto capacity = header_->capacity;
+    if (header_->value_size != sizeof(value_type) || header_->value_align != alignof(value_type)
+        || !std::has_single_bit(capacity) || mapping_size_ < _slots_offset + capacity * sizeof(_slot)) {
+        _fail("shm_channel attach", EINVAL);
+    }
+}
+
+template<typename T>
+inline auto _shm_channel<T>::_map(const size_type size) -> void
+{
+    mapping_ = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (mapping_ == MAP_FAILED) { _fail("mmap", errno); }
+    mapping_size_ = size;
+}
+
+template<typename T>
+inline auto _shm_channel<T>::_join() -> void
+{
+    slots_ = std::launder(reinterpret_cast<_slot *>(static_cast<std::byte *>(mapping_) + _slots_offset));
+    mask_ = header_->capacity - 1U;
+    shift_ = static_cast<std::uint64_t>(std::countr_zero(header_->capacity));
+
+    // held for as long as this handle lives, see _peer_attached
+    flock lock{};
+    lock.l_type = F_RDLCK;
+    lock.l_whence = SEEK_SET;
+    lock.l_start = static_cast<off_t>(side_);
+    lock.l_len = 1;
+    if (::fcntl(fd_, F_OFD_SETLK, &lock) != 0) { _fail("fcntl", errno); }
+    header_->attached[static_cast<std::size_t>(side_)].store(1U, std::memory_order_release);
+
+    this->not_full_._bind(header_->not_full, &_poll, this);
+    this->not_empty_._bind(header_->not_empty, &_poll, this);
+
+    // the channel may have been closed before we attached
+    _sync();
+}
+
+template<typename T>
+inline auto _shm_channel<T>::_fail(const char *what, const int error) -> void
+{
+    if (mapping_ != MAP_FAILED) { ::munmap(mapping_, mapping_size_); }
+    if (fd_ >= 0) { ::close(fd_); }
+    if (owner_) { ::shm_unlink(name_.c_str()); }
+    throw std::system_error(error, std::system_category(), what);
+}
+
+template<typename T>
+[[nodiscard]] inline auto _shm_channel<T>::size() const noexcept -> size_type
+{
+    // load tail first, it can never pass head
+    const auto tail = header_->tail.load(std::memory_order_acquire);
+    const auto head = header_->head.load(std::memory_order_acquire);
+    return std::min(head - tail, capacity());
+}
+
+template<typename T>
+[[nodiscard]] inline auto _shm_channel<T>::empty() const noexcept -> bool
+{
+    // decided by the front slot rather than the positions, so the slot of a sender that died
+    // before writing it reads as empty and receivers park instead of spinning on it
+    const auto place = _locate(header_->tail.load(std::memory_order_acquire));
+    return place.slot->stamp.load(std::memory_order_acquire) < place.free + 1U;
+}
+
+template<typename T>
+[[nodiscard]] inline auto _shm_channel<T>::full() const noexcept -> bool
+{
+    const auto place = _locate(header_->head.load(std::memory_order_acquire));
+    return place.slot->stamp.load(std::memory_order_acquire) < place.free;
+}
+
+template<typename T>
+inline auto _shm_channel<T>::close() -> void
+{
+    header_->closed.store(1U, std::memory_order_seq_cst);
+    _base::close();
+}
+
+template<typename T>
+inline auto _shm_channel<T>::_sync() noexcept -> bool
+{
+    if (this->closed()) { return true; }
+    if (header_->closed.load(std::memory_order_acquire) == 0U) { return false; }
+
+    _base::close();
+    return true;
+}
+
+template<typename T>
+[[nodiscard]] inline auto _shm_channel<T>::_peer_attached() const noexcept -> bool
+{
+    const auto peer = side_ == _shm_side::sender ? _shm_side::receiver : _shm_side::sender;
+
+    // not there yet
+    if (header_->attached[static_cast<std::size_t>(peer)].load(std::memory_order_acquire) == 0U) { return true; }
+
+    // a write lock conflicts with the read lock of every handle on that side
+    flock probe{};
+    probe.l_type = F_WRLCK;
+    probe.l_whence = SEEK_SET;
+    probe.l_start = static_cast<off_t>(peer);
+    probe.l_len = 1;
+    if (::fcntl(fd_, F_OFD_GETLK, &probe) != 0) { return true; }
+    return probe.l_type != F_UNLCK;
+}
+
+template<typename T>
+inline auto _shm_channel<T>::_poll(void *context, const bool timed_out) noexcept -> void
+{
+    auto &self = *static_cast<_shm_channel *>(context);
+    if (self._sync()) { return; }
+
+    // only checked when nobody woke us, so a busy channel never pays for the syscall
+    if (timed_out && !self._peer_attached()) {
+        self.header_->lost.store(1U, std::memory_order_release);
+        self.close();
+    }
+}
+
+template<typename T>
+template<typename... Args>
+inline auto _shm_channel<T>::_try_reserve(Args &&...args) -> std::optional<_handle>
+{
+    if (_sync()) { return std::nullopt; }
+
+    auto position = header_->head.load(std::memory_order_relaxed);
+
+    while (true) {
+        const auto place = _locate(position);
+        const auto stamp = place.slot->stamp.load(std::memory_order_acquire);
+
+        if (stamp == place.free) {
+            // the slot is free for this lap, try to claim it
+            if (header_->head.compare_exchange_weak(position, position + 1U, std::memory_order_relaxed)) {
+                auto *value = std::construct_at(_value_at(*place.slot), std::forward<Args>(args)...);
+                return _handle{ value, place.slot, place.free };
+            }
+        } else if (stamp < place.free) {
+            // the slot is still in use from the previous lap, so the queue is full
+            return std::nullopt;
+        } else {
+            // another producer claimed this position first
+            position = header_->head.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template<typename T>
+inline auto _shm_channel<T>::_commit(_handle &&handle) -> void
+{
+    handle.slot->stamp.store(handle.free + 1U, std::memory_order_release);
+}
+
+template<typename T>
+inline auto _shm_channel<T>::_try_acquire() -> std::optional<_handle>
+{
+    auto position = header_->tail.load(std::memory_order_relaxed);
+
+    while (true) {
+        const auto place = _locate(position);
+        const auto stamp = place.slot->stamp.load(std::memory_order_acquire);
+
+        if (stamp == place.free + 1U) {
+            // the slot holds a value for this lap, try to claim it
+            if (header_->tail.compare_exchange_weak(position, position + 1U, std::memory_order_relaxed)) {
+                return _handle{ _value_at(*place.slot), place.slot, place.free };
+            }
+        } else if (stamp < place.free + 1U) {
+            // the slot hasn't been written for this lap yet, so the queue is empty
+            _sync();
+            return std::nullopt;
+        } else {
+            // another consumer claimed this position first
+            position = header_->tail.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template<typename T>
+inline auto _shm_channel<T>::_release(_handle &&handle) -> void
+{
+    // frees the slot for the next lap
+    handle.slot->stamp.store(handle.free + 2U, std::memory_order_release);
+}
+
+template<typename T>
+template<typename It, typename S>
+inline auto _shm_channel<T>::_try_push_many(It &first, const S &last) -> size_type
+{
+    if (_sync()) { return 0U; }
+
+    // without knowing how many values are left, slots can only be claimed one at a time
+    if constexpr (!std::sized_sentinel_for<S, It>) {
+        size_type pushed = 0U;
+        while (first != last) {
+            auto handle = _try_reserve(*first);
+            if (!handle) { break; }
+
+            _commit(std::move(*handle));
+            ++first;
+            pushed++;
+        }
+        return pushed;
+    } else {
+        const auto wanted = std::min(static_cast<size_type>(last - first), capacity());
+        auto position = header_->head.load(std::memory_order_relaxed);
+
+        while (true) {
+            // every slot that is free for this lap can be claimed together with a single CAS
+            size_type count = 0U;
+            while (count < wanted) {
+                const auto place = _locate(position + count);
+                if (place.slot->stamp.load(std::memory_order_acquire) != place.free) { break; }
+                count++;
+            }
+
+            if (count == 0U) {
+                // the first slot is either in use from the previous lap (full) or already claimed
+                const auto place = _locate(position);
+                if (place.slot->stamp.load(std::memory_order_acquire) < place.free) { return 0U; }
+                position = header_->head.load(std::memory_order_relaxed);
+                continue;
+            }
+
+            if (header_->head.compare_exchange_weak(position, position + count, std::memory_order_relaxed)) {
+                for (size_type i = 0U; i < count; i++, ++first) {
+                    const auto place = _locate(position + i);
+                    std::construct_at(_value_at(*place.slot), *first);
+                    place.slot->stamp.store(place.free + 1U, std::memory_order_release);
+                }
+                return count;
+            }
+        }
+    }
+}
+
+template<typename T>
+template<typename Out>
+inline auto _shm_channel<T>::_try_pop_many(Out &out, const size_type max) -> size_type
+{
+    const auto wanted = std::min(max, capacity());
+    auto position = header_->tail.load(std::memory_order_relaxed);
+
+    while (true) {
+        // every slot that holds a value for this lap can be claimed together with a single CAS
+        size_type count = 0U;
+        while (count < wanted) {
+            const auto place = _locate(position + count);
+            if (place.slot->stamp.load(std::memory_order_acquire) != place.free + 1U) { break; }
+            count++;
+        }
+
+        if (count == 0U) {
+            // the first slot is either not written yet (empty) or already claimed
+            const auto place = _locate(position);
+            if (place.slot->stamp.load(std::memory_order_acquire) < place.free + 1U) {
+                _sync();
+                return 0U;
+            }
+            position = header_->tail.load(std::memory_order_relaxed);
+            continue;
+        }
+
+        if (header_->tail.compare_exchange_weak(position, position + count, std::memory_order_relaxed)) {
+            for (size_type i = 0U; i < count; i++) {
+                const auto place = _locate(position + i);
+                *out = *_value_at(*place.slot);
+                ++out;
+                place.slot->stamp.store(place.free + 2U, std::memory_order_release);
+            }
+            return count;
+        }
+    }
+}
+
+template<typename T>
+[[nodiscard]] inline auto _shm_channel<T>::_locate(const std::uint64_t position) const noexcept -> _place
+{
+    return { &slots_[position & mask_], 2U * (position >> shift_) };
+}
+
+template<typename T>
+[[nodiscard]] inline auto _shm_channel<T>::_value_at(_slot &slot) noexcept -> value_type *
+{
+    return std::launder(reinterpret_cast<value_type *>(slot.data));
+}
+
+}// namespace nrws
+
+#endif
@@ -0,0 +1,242 @@
+#pragma once
+
+#include "narrows/_internal/_arch.hpp"
+#include "narrows/_internal/_batch.hpp"
+#include "narrows/_internal/_channel_ops.hpp"
+#include "narrows/wait.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace nrws {
+
+// Wait-free single producer/single consumer ring buffer.
+//
+// head_ is only ever written by the producer and tail_ only by the consumer, and they live on
+// separate cache lines. Each side keeps a cached copy of the other side's index, so the shared
+// line is only read again when the ring looks full (producer) or empty (consumer). A thread only
+// waits, using the Wait policy, once the ring is actually full or empty.
+//
+// push/push_many/reserve must only be called by the producer and pop/pop_many/pop_ref by the
+// consumer, and each side can hold at most one reserved or acquired slot at a time.
+template<typename T, typename Wait = park_wait, typename Allocator = std::allocator<std::decay_t<T>>>
+class _spsc_ring : public _channel_ops<_spsc_ring<T, Wait, Allocator>, T, Wait>
+{
+    using _base = _channel_ops<_spsc_ring<T, Wait, Allocator>, T, Wait>;
+    friend _base;
+
+  public:
+    using value_type = std::decay_t<T>;
+    using size_type = std::size_t;
+    using allocator_type = Allocator;
+
+    explicit _spsc_ring(const size_type capacity, const Allocator &alloc = Allocator());
+    ~_spsc_ring();
+
+    _spsc_ring(const _spsc_ring &) = delete;
+    _spsc_ring &operator=(const _spsc_ring &) = delete;
+
+    // Ring status
+    [[nodiscard]] inline auto size() const noexcept -> size_type;
+    [[nodiscard]] inline auto empty() const noexcept -> bool;
+    [[nodiscard]] inline auto full() const noexcept -> bool;
+    [[nodiscard]] inline auto capacity() const noexcept -> size_type;
+
+  private:
+    using _value_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<value_type>;
+    using _value_traits = std::allocator_traits<_value_allocator>;
+    using _entry_time_type = typename _base::_entry_time_type;
+    using _entry_times = std::conditional_t<_base::_instrumented,
+        std::vector<_entry_time_type,
+            typename std::allocator_traits<Allocator>::template rebind_alloc<_entry_time_type>>,
+        _no_entry_times>;
+
+    struct _handle
+    {
+        value_type *value;
+        size_type index;
+    };
+
+    constexpr static bool _bounded = true;
+
+    template<typename... Args>
+    inline auto _try_reserve(Args &&...args) -> std::optional<_handle>;
+    inline auto _commit(_handle &&handle) -> void;
+    inline auto _try_acquire() -> std::optional<_handle>;
+    inline auto _release(_handle &&handle) -> void;
+
+    template<typename It, typename S>
+    inline auto _try_push_many(It &first, const S &last) -> size_type;
+    template<typename Out>
+    inline auto _try_pop_many(Out &out, const size_type max) -> size_type;
+
+    [[nodiscard]] inline auto _slot_at(const size_type index) const noexcept -> value_type *;
+
+    // read only after construction
+    _value_allocator alloc_;
+    size_type capacity_;
+    size_type mask_;
+    value_type *buffer_;
+    // instrumented only, when the value in each slot was published
+    [[no_unique_address]] _entry_times entered_;
+
+    // producer side
+    alignas(_cache_line_size) std::atomic<size_type> head_{ 0U };
+    size_type cached_tail_{ 0U };
+
+    // consumer side
+    alignas(_cache_line_size) std::atomic<size_type> tail_{ 0U };
+    size_type cached_head_{ 0U };
+};
+
+template<typename T, typename Wait, typename Allocator>
+_spsc_ring<T, Wait, Allocator>::_spsc_ring(const size_type capacity, const Allocator &alloc)
+    : alloc_(alloc), capacity_(capacity), mask_(_next_power_of_two(capacity) - 1U),
+      buffer_(_value_traits::allocate(alloc_, mask_ + 1U)), entered_(mask_ + 1U, alloc)
+{}
+
+template<typename T, typename Wait, typename Allocator>
+_spsc_ring<T, Wait, Allocator>::~_spsc_ring()
+{
+    // destroy anything that was never received
+    const auto head = head_.load(std::memory_order_acquire);
+    for (auto index = tail_.load(std::memory_order_acquire); index != head; index++) {
+        std::destroy_at(_slot_at(index));
+    }
+
+    _value_traits::deallocate(alloc_, buffer_, mask_ + 1U);
+}
+
+template<typename T, typename Wait, typename Allocator>
+[[nodiscard]] inline auto _spsc_ring<T, Wait, Allocator>::size() const noexcept -> size_type
+{
+    // load tail first, it can never pass head
+    const auto tail = tail_.load(std::memory_order_acquire);
+    const auto head = head_.load(std::memory_order_acquire);
+    return head - tail;
+}
+
+template<typename T, typename Wait, typename Allocator>
+[[nodiscard]] inline auto _spsc_ring<T, Wait, Allocator>::empty() const noexcept -> bool
+{
+    return size() == 0U;
+}
+
+template<typename T, typename Wait, typename Allocator>
+[[nodiscard]] inline auto _spsc_ring<T, Wait, Allocator>::full() const noexcept -> bool
+{
+    return size() >= capacity_;
+}
+
+template<typename T, typename Wait, typename Allocator>
+[[nodiscard]] inline auto _spsc_ring<T, Wait, Allocator>::capacity() const noexcept -> size_type
+{
+    return capacity_;
+}
+
+template<typename T, typename Wait, typename Allocator>
+template<typename... Args>
+inline auto _spsc_ring<T, Wait, Allocator>::_try_reserve(Args &&...args) -> std::optional<_handle>
+{
+    const auto head = head_.load(std::memory_order_relaxed);
+
+    // only go to the consumer's cache line when the ring looks full
+    if (head - cached_tail_ == capacity_) {
+        cached_tail_ = tail_.load(std::memory_order_acquire);
+        if (head - cached_tail_ == capacity_) { return std::nullopt; }
+    }
+
+    auto *slot = std::construct_at(_slot_at(head), std::forward<Args>(args)...);
+    return _handle{ slot, head };
+}
+
+template<typename T, typename Wait, typename Allocator>
+inline auto _spsc_ring<T, Wait, Allocator>::_commit(_handle &&handle) -> void
+{
+    this->_enter(entered_[handle.index & mask_]);
+    head_.store(handle.index + 1U, std::memory_order_release);
+}
+
+template<typename T, typename Wait, typename Allocator>
+inline auto _spsc_ring<T, Wait, Allocator>::_try_acquire() -> std::optional<_handle>
+{
+    const auto tail = tail_.load(std::memory_order_relaxed);
+
+    // only go to the producer's cache line when the ring looks empty
+    if (tail == cached_head_) {
+        cached_head_ = head_.load(std::memory_order_acquire);
+        if (tail == cached_head_) { return std::nullopt; }
+    }
+
+    return _handle{ _slot_at(tail), tail };
+}
+
+template<typename T, typename Wait, typename Allocator>
+inline auto _spsc_ring<T, Wait, Allocator>::_release(_handle &&handle) -> void
+{
+    this->_leave(entered_[handle.index & mask_]);
+    std::destroy_at(handle.value);
+    tail_.store(handle.index + 1U, std::memory_order_release);
+}
+
+template<typename T, typename Wait, typename Allocator>
+template<typename It, typename S>
+inline auto _spsc_ring<T, Wait, Allocator>::_try_push_many(It &first, const S &last) -> size_type
+{
+    // a batch is worth a fresh look at the consumer's index
+    const auto head = head_.load(std::memory_order_relaxed);
+    cached_tail_ = tail_.load(std::memory_order_acquire);
+    const auto free = capacity_ - (head - cached_tail_);
+
+    // the free space is at most two contiguous segments, one before and one after the wrap
+    size_type pushed = 0U;
+    while (pushed < free && first != last) {
+        const auto index = (head + pushed) & mask_;
+        const auto segment = std::min(free - pushed, mask_ + 1U - index);
+        const auto count = _construct_segment(first, last, buffer_ + index, segment);
+
+        for (size_type i = 0U; i < count; i++) { this->_enter(entered_[index + i]); }
+        pushed += count;
+        if (count < segment) { break; }
+    }
+
+    if (pushed != 0U) { head_.store(head + pushed, std::memory_order_release); }
+    return pushed;
+}
+
+template<typename T, typename Wait, typename Allocator>
+template<typename Out>
+inline auto _spsc_ring<T, Wait, Allocator>::_try_pop_many(Out &out, const size_type max) -> size_type
+{
+    const auto tail = tail_.load(std::memory_order_relaxed);
+    cached_head_ = head_.load(std::memory_order_acquire);
+    const auto available = std::min(max, cached_head_ - tail);
+
+    size_type popped = 0U;
+    while (popped < available) {
+        const auto index = (tail + popped) & mask_;
+        const auto segment = std::min(available - popped, mask_ + 1U - index);
+
+        _move_segment_out(buffer_ + index, segment, out);
+        for (size_type i = 0U; i < segment; i++) { this->_leave(entered_[index + i]); }
+        std::destroy_n(buffer_ + index, segment);
+        popped += segment;
+    }
+
+    if (popped != 0U) { tail_.store(tail + popped, std::memory_order_release); }
+    return popped;
+}
+
+template<typename T, typename Wait, typename Allocator>
+[[nodiscard]] inline auto _spsc_ring<T, Wait, Allocator>::_slot_at(const size_type index) const noexcept -> value_type *
+{
+    return buffer_ + (index & mask_);
+}
+
+}// namespace nrws
@@ -0,0 +1,219 @@
+#pragma once
+
+#include "narrows/_internal/_arch.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace nrws {
+
+// Log-linear histogram in the style of HdrHistogram. Values below sub_buckets get a bucket each,
+// above that every power of two is split into sub_buckets buckets, so a value is recorded with a
+// relative error of at most 1 / sub_buckets over the whole 64 bit range.
+class residency_histogram
+{
+  public:
+    constexpr static std::size_t sub_bucket_bits = 3U;
+    constexpr static std::size_t sub_buckets = std::size_t{ 1U } << sub_bucket_bits;
+    constexpr static std::size_t buckets = (64U - sub_bucket_bits + 1U) * sub_buckets;
+
+    // the bucket a value falls in, and the smallest value in a bucket
+    [[nodiscard]] constexpr static auto bucket_of(std::uint64_t value) noexcept -> std::size_t;
+    [[nodiscard]] constexpr static auto lower_bound(std::size_t bucket) noexcept -> std::uint64_t;
+
+    [[nodiscard]] inline auto count() const noexcept -> std::uint64_t;
+    // the time at or below which the fraction q of the recorded values fall, e.g. percentile(0.99)
+    [[nodiscard]] inline auto percentile(double q) const noexcept -> std::chrono::nanoseconds;
+
+    // values recorded per bucket, in nanoseconds
+    std::array<std::uint64_t, buckets> counts{};
+};
+
+// Snapshot of the statistics an instrumented channel keeps. Every counter is read on its own while
+// traffic goes on, so counters taken at the same moment may disagree by a few values.
+struct channel_stats
+{
+    std::uint64_t sends{ 0U };
+    std::uint64_t receives{ 0U };
+    // sends that had to wait for room, receives that had to wait for a value
+    std::uint64_t blocked_sends{ 0U };
+    std::uint64_t blocked_receives{ 0U };
+    // time senders and receivers spent waiting
+    std::chrono::nanoseconds parked{ 0 };
+    // the most values the channel held at once
+    std::size_t high_water{ 0U };
+    // lock acquisitions that had to wait, or slot claims that lost a race to another thread
+    std::uint64_t contended{ 0U };
+    // time from send to receive
+    residency_histogram residency;
+};
+
+// the statistics of an instrumented channel as they are being kept. Each side has its own cache
+// line so senders and receivers don't contend on the counters.
+class _live_stats
+{
+  public:
+    inline auto sent(const std::uint64_t count) noexcept -> void
+    {
+        send_.transfers.fetch_add(count, std::memory_order_relaxed);
+    }
+    inline auto received(const std::uint64_t count) noexcept -> void
+    {
+        receive_.transfers.fetch_add(count, std::memory_order_relaxed);
+    }
+    inline auto parked(bool sending, std::chrono::nanoseconds duration) noexcept -> void;
+    inline auto occupied(std::size_t size) noexcept -> void;
+    inline auto contended() noexcept -> void { contended_.fetch_add(1U, std::memory_order_relaxed); }
+    inline auto resided(std::uint64_t entered) noexcept -> void;
+
+    [[nodiscard]] inline auto snapshot() const noexcept -> channel_stats;
+
+    // steady clock in nanoseconds, what entry times are taken in
+    [[nodiscard]] static inline auto now() noexcept -> std::uint64_t
+    {
+        const auto since_epoch = std::chrono::steady_clock::now().time_since_epoch();
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(since_epoch).count());
+    }
+
+  private:
+    struct alignas(_cache_line_size) _side
+    {
+        std::atomic<std::uint64_t> transfers{ 0U };
+        std::atomic<std::uint64_t> blocked{ 0U };
+        std::atomic<std::uint64_t> parked_ns{ 0U };
+    };
+
+    _side send_;
+    _side receive_;
+
+    alignas(_cache_line_size) std::atomic<std::size_t> high_water_{ 0U };
+    std::atomic<std::uint64_t> contended_{ 0U };
+    std::array<std::atomic<std::uint64_t>, residency_histogram::buckets> residency_{};
+};
+
+// stands in for _live_stats in a channel that isn't instrumented
+struct _no_stats
+{
+};
+
+// when the value in a slot was sent, kept next to it by instrumented channels only
+struct _entry_time
+{
+    std::uint64_t at{ 0U };
+};
+struct _no_entry_time
+{
+};
+
+// stands in for the entry times of a channel that isn't instrumented
+struct _no_entry_times
+{
+    template<typename... Args>
+    explicit _no_entry_times(Args &&.../*args*/) noexcept
+    {}
+
+    [[nodiscard]] inline auto operator[](std::size_t /*index*/) noexcept -> _no_entry_time & { return none; }
+
+    [[no_unique_address]] _no_entry_time none;
+};
+
+/* Residency Histogram Implementations */
+
+[[nodiscard]] constexpr auto residency_histogram::bucket_of(const std::uint64_t value) noexcept -> std::size_t
+{
+    if (value < sub_buckets) { return value; }
+
+    // the leading bit picks the power of two, the sub_bucket_bits below it the sub bucket
+    const std::uint64_t shift = static_cast<unsigned>(std::bit_width(value)) - 1U - sub_bucket_bits;
+    const std::uint64_t sub = (value >> shift) & (sub_buckets - 1U);
+    return (shift + 1U) * sub_buckets + sub;
+}
+
+[[nodiscard]] constexpr auto residency_histogram::lower_bound(const std::size_t bucket) noexcept -> std::uint64_t
+{
+    if (bucket < sub_buckets) { return bucket; }
+
+    const auto shift = bucket / sub_buckets - 1U;
+    const auto sub = bucket % sub_buckets;
+    return std::uint64_t{ sub_buckets + sub } << shift;
+}
+
+[[nodiscard]] inline auto residency_histogram::count() const noexcept -> std::uint64_t
+{
+    std::uint64_t total = 0U;
+    for (const auto bucket : counts) { total += bucket; }
+    return total;
+}
+
+[[nodiscard]] inline auto residency_histogram::percentile(const double q) const noexcept -> std::chrono::nanoseconds
+{
+    const auto total = count();
+    if (total == 0U) { return std::chrono::nanoseconds{ 0 }; }
+
+    // the value of rank ceil(q * total), reported as the highest value of its bucket like HdrHistogram
+    const auto wanted = std::ceil(std::clamp(q, 0.0, 1.0) * static_cast<double>(total));
+    const auto rank = std::max(std::uint64_t{ 1U }, static_cast<std::uint64_t>(wanted));
+    constexpr auto longest = static_cast<std::uint64_t>(std::numeric_limits<std::chrono::nanoseconds::rep>::max());
+
+    std::uint64_t seen = 0U;
+    for (std::size_t bucket = 0U; bucket + 1U < buckets; bucket++) {
+        seen += counts[bucket];
+        if (seen >= rank) {
+            const auto highest = std::min(lower_bound(bucket + 1U) - 1U, longest);
+            return std::chrono::nanoseconds{ static_cast<std::chrono::nanoseconds::rep>(highest) };
+        }
+    }
+    return std::chrono::nanoseconds::max();
+}
+
+/* Live Stats Implementations */
+
+inline auto _live_stats::parked(const bool sending, const std::chrono::nanoseconds duration) noexcept -> void
+{
+    auto &side = sending ? send_ : receive_;
+    side.blocked.fetch_add(1U, std::memory_order_relaxed);
+    side.parked_ns.fetch_add(static_cast<std::uint64_t>(duration.count()), std::memory_order_relaxed);
+}
+
+inline auto _live_stats::occupied(const std::size_t size) noexcept -> void
+{
+    // only ever raised, most sends see a high water mark that is already higher
+    auto high = high_water_.load(std::memory_order_relaxed);
+    while (size > high && !high_water_.compare_exchange_weak(high, size, std::memory_order_relaxed)) {}
+}
+
+inline auto _live_stats::resided(const std::uint64_t entered) noexcept -> void
+{
+    const auto left = now();
+    const auto bucket = residency_histogram::bucket_of(left > entered ? left - entered : 0U);
+    residency_[bucket].fetch_add(1U, std::memory_order_relaxed);
+}
+
+[[nodiscard]] inline auto _live_stats::snapshot() const noexcept -> channel_stats
+{
+    channel_stats stats;
+    stats.sends = send_.transfers.load(std::memory_order_relaxed);
+    stats.receives = receive_.transfers.load(std::memory_order_relaxed);
+    stats.blocked_sends = send_.blocked.load(std::memory_order_relaxed);
+    stats.blocked_receives = receive_.blocked.load(std::memory_order_relaxed);
+
+    const auto parked_ns =
+        send_.parked_ns.load(std::memory_order_relaxed) + receive_.parked_ns.load(std::memory_order_relaxed);
+    stats.parked = std::chrono::nanoseconds{ static_cast<std::chrono::nanoseconds::rep>(parked_ns) };
+
+    stats.high_water = high_water_.load(std::memory_order_relaxed);
+    stats.contended = contended_.load(std::memory_order_relaxed);
+    for (std::size_t i = 0U; i < residency_histogram::buckets; i++) {
+        stats.residency.counts[i] = residency_[i].load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+}// namespace nrws
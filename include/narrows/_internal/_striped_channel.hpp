@@ -0,0 +1,397 @@
+#pragma once
+
+#include "narrows/_internal/_array_channel.hpp"
+#include "narrows/_internal/_channel_ops.hpp"
+#include "narrows/wait.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace nrws {
+
+// How the consumer of a striped channel picks the stripe to take the next value from
+struct round_robin_drain
+{};// visits the stripes in turn
+struct timestamp_drain
+{};// takes the oldest value at the front of any stripe, at the cost of reading the clock per send
+
+// Identifies the calling thread. Unlike std::thread::id never reused, so a new thread doesn't
+// take over the home table entries of one that has exited.
+inline auto _thread_serial() noexcept -> std::uint64_t
+{
+    static std::atomic<std::uint64_t> next{ 0U };
+    thread_local const std::uint64_t serial = next.fetch_add(1U, std::memory_order_relaxed);
+    return serial;
+}
+
+// Bounded channel made of several independent lock-free rings, so producers don't contend with
+// each other.
+//
+// Every producer thread has a home stripe and only touches that stripe's head, so with at least as
+// many stripes as producers a push never shares a written cache line with another producer. Homes
+// are handed out per channel in the order producers first send on it, and a thread keeps its
+// home for the lifetime of the channel. The consumer side visits every stripe instead, in turn or
+// by the timestamp each value was sent with.
+//
+// Homes are kept in a fixed table indexed by thread serial, so the channel doesn't grow with every
+// thread that ever sent on it. An entry is never handed to another thread, a thread whose entry is
+// already taken uses its serial modulo the stripe count as its home instead.
+//
+// With keep_producer_order (the default) a producer only ever uses its home stripe, which keeps
+// the values of one producer in the order they were sent, and the channel counts as full for it
+// once its home stripe is full. Without it, a producer spills into the other stripes when its own
+// is full, and there is no order between values at all.
+template<typename T, typename Order, typename Wait, typename Allocator>
+class _striped_channel : public _channel_ops<_striped_channel<T, Order, Wait, Allocator>, T, Wait>
+{
+    using _base = _channel_ops<_striped_channel<T, Order, Wait, Allocator>, T, Wait>;
+    friend _base;
+
+  public:
+    using value_type = std::decay_t<T>;
+    using size_type = std::size_t;
+    using allocator_type = Allocator;
+
+    // stripes picked by default never hold fewer slots than this
+    constexpr static size_type min_stripe_capacity = 16U;
+
+    // The capacity is split over the stripes as evenly as it goes. Without a stripe count there is
+    // one per hardware thread, as long as each keeps min_stripe_capacity slots.
+    explicit _striped_channel(const size_type capacity,
+        const size_type stripes = 0U,
+        const bool keep_producer_order = true,
+        const Allocator &alloc = Allocator());
+
+    _striped_channel(const _striped_channel &) = delete;
+    _striped_channel &operator=(const _striped_channel &) = delete;
+
+    // Channel status
+    [[nodiscard]] inline auto size() const noexcept -> size_type;
+    [[nodiscard]] inline auto empty() const noexcept -> bool;
+    [[nodiscard]] inline auto full() const noexcept -> bool;
+    [[nodiscard]] inline auto capacity() const noexcept -> size_type;
+    [[nodiscard]] inline auto stripes() const noexcept -> size_type { return stripes_.size(); }
+
+  private:
+    constexpr static bool _timestamped = std::is_same_v<Order, timestamp_drain>;
+
+    // the stripes never wait on their own, that's done by this channel
+    using _stripe = _array_channel<value_type, spin_wait, Allocator>;
+    using _stripe_handle = typename _stripe::_handle;
+
+    struct _handle
+    {
+        value_type *value;
+        size_type stripe;
+        _stripe_handle inner;
+    };
+
+    constexpr static bool _bounded = true;
+    // room in one stripe is no use to the producers of another
+    constexpr static bool _partitioned = true;
+
+    // producers that keep their order wait for room in their home stripe only
+    [[nodiscard]] inline auto _room_waiters() noexcept -> typename Wait::waiter_set &;
+    inline auto _wake_producers() noexcept -> void;
+
+    template<typename... Args>
+    inline auto _try_reserve(Args &&...args) -> std::optional<_handle>;
+    inline auto _commit(_handle &&handle) -> void;
+    inline auto _try_acquire() -> std::optional<_handle>;
+    inline auto _release(_handle &&handle) -> void;
+
+    template<typename It, typename S>
+    inline auto _try_push_many(It &first, const S &last) -> size_type;
+    template<typename Out>
+    inline auto _try_pop_many(Out &out, const size_type max) -> size_type;
+
+    // wakes the producers homed on a stripe once values were taken from it
+    inline auto _freed(size_type stripe, size_type count) noexcept -> void;
+    // the home stripe of the calling thread in this channel
+    [[nodiscard]] inline auto _home() const noexcept -> size_type;
+    template<typename... Args>
+    [[nodiscard]] inline auto _try_reserve_in(size_type stripe, Args &&...args) -> std::optional<_handle>;
+    // the stripe whose front value was sent first, or the next one in turn
+    [[nodiscard]] inline auto _pick() const noexcept -> size_type;
+    [[nodiscard]] static inline auto _now() noexcept -> std::uint64_t;
+
+    std::vector<std::unique_ptr<_stripe>> stripes_;
+    // timestamp_drain only, when the value in each slot of each stripe was sent. Kept out of the
+    // slots so _pick never reads a slot that another consumer is destroying or a producer writing.
+    std::vector<std::unique_ptr<std::atomic<std::uint64_t>[]>> sent_;
+    // with keep_producer_order, the producers waiting for room in each stripe
+    std::unique_ptr<typename Wait::waiter_set[]> room_;
+    size_type capacity_{ 0U };
+    bool keep_producer_order_;
+
+    // (serial + 1) * stripes + home of the thread that claimed each entry, 0 while free
+    constexpr static size_type _home_entries = 64U;
+    mutable std::atomic<std::uint64_t> homes_[_home_entries]{};
+    mutable std::atomic<size_type> next_home_{ 0U };
+
+    // consumer side, the stripe to look at first
+    alignas(_cache_line_size) std::atomic<size_type> next_{ 0U };
+};
+
+template<typename T, typename Order, typename Wait, typename Allocator>
+_striped_channel<T, Order, Wait, Allocator>::_striped_channel(const size_type capacity,
+    const size_type stripes,
+    const bool keep_producer_order,
+    const Allocator &alloc)
+    : keep_producer_order_(keep_producer_order)
+{
+    const auto hardware = std::max(static_cast<size_type>(std::thread::hardware_concurrency()), size_type{ 1U });
+    auto count = stripes != 0U ? stripes : std::min(hardware, capacity / min_stripe_capacity);
+    // every stripe needs at least one slot
+    count = std::clamp(count, size_type{ 1U }, std::max(capacity, size_type{ 1U }));
+
+    // the first capacity % count stripes take one slot more
+    stripes_.reserve(count);
+    for (size_type i = 0U; i < count; i++) {
+        const auto size = std::max(capacity / count + (i < capacity % count ? 1U : 0U), size_type{ 1U });
+        stripes_.push_back(std::make_unique<_stripe>(size, alloc));
+        if constexpr (_timestamped) { sent_.push_back(std::make_unique<std::atomic<std::uint64_t>[]>(size)); }
+        capacity_ += size;
+    }
+    room_ = std::make_unique<typename Wait::waiter_set[]>(count);
+}
+
+template<typename T, typename Order, typename Wait, typename Allocator>
+[[nodiscard]] inline auto _striped_channel<T, Order, Wait, Allocator>::size() const noexcept -> size_type
+{
+    size_type size = 0U;
+    for (const auto &stripe : stripes_) { size += stripe->size(); }
+    return size;
+}
+
+template<typename T, typename Order, typename Wait, typename Allocator>
+[[nodiscard]] inline auto _striped_channel<T, Order, Wait, Allocator>::empty() const noexcept -> bool
+{
+    return std::ranges::all_of(stripes_, [](const auto &stripe) { return stripe->empty(); });
+}
+
+template<typename T, typename Order, typename Wait, typename Allocator>
+[[nodiscard]] inline auto _striped_channel<T, Order, Wait, Allocator>::full() const noexcept -> bool
+{
+    // full for the calling producer, so other threads may see room in their own stripes
+    if (keep_producer_order_) { return stripes_[_home()]->full(); }
+    return std::ranges::all_of(stripes_, [](const auto &stripe) { return stripe->full(); });
+}
+
+template<typename T, typename Order, typename Wait, typename Allocator>
+[[nodiscard]] inline auto _striped_channel<T, Order, Wait, Allocator>::capacity() const noexcept -> size_type
+{
+    return capacity_;
+}
+
+template<typename T, typename Order, typename Wait, typename Allocator>
+template<typename... Args>
+inline auto _striped_channel<T, Order, Wait, Allocator>::_try_reserve(Args &&...args) -> std::optional<_handle>
+{
+    const auto home = _home();
+    if (auto handle = _try_reserve_in(home, std::forward<Args>(args)...)) { return handle; }
+    if (keep_producer_order_) { return std::nullopt; }
+
+    // _try_reserve_in only consumes args when it succeeds, so it is safe to forward them again
+    for (size_type i = 1U; i < stripes_.size(); i++) {
+        if (auto handle = _try_reserve_in((home + i) % stripes_.size(), std::forward<Args>(args)...)) {
+            return handle;
+        }
+    }
+    return std::nullopt;
+}
+
+template<typename T, typename Order, typename Wait, typename Allocator>
+inline auto _striped_channel<T, Order, Wait, Allocator>::_commit(_handle &&handle) -> void
+{
+    stripes_[handle.stripe]->_commit(std::move(handle.inner));
+}
+
+template<typename T, typename Order, typename Wait, typename Allocator>
+inline auto _striped_channel<T, Order, Wait, Allocator>::_try_acquire() -> std::optional<_handle>
+{
+    const auto start = _pick();
+    for (size_type i = 0U; i < stripes_.size(); i++) {
+        const auto stripe = (start + i) % stripes_.size();
+        if (auto inner = stripes_[stripe]->_try_acquire()) {
+            next_.store(stripe + 1U, std::memory_order_relaxed);
+            return _handle{ inner->value, stripe, std::move(*inner) };
+        }
+    }
+    return std::nullopt;
+}
+
+template<typename T, typename Order, typename Wait, typename Allocator>
+inline auto _striped_channel<T, Order, Wait, Allocator>::_release(_handle &&handle) -> void
+{
+    const auto stripe = handle.stripe;
+    stripes_[stripe]->_release(std::move(handle.inner));
+    _freed(stripe, 1U);
+}
+
+template<typename T, typename Order, typename Wait, typename Allocator>
+template<typename It, typename S>
+inline auto _striped_channel<T, Order, Wait, Allocator>::_try_push_many(It &first, const S &last) -> size_type
+{
+    // every value needs its own timestamp
+    if constexpr (_timestamped) {
+        size_type pushed = 0U;
+        while (first != last) {
+            auto handle = _try_reserve(*first);
+            if (!handle) { break; }
+
+            _commit(std::move(*handle));
+            ++first;
+            pushed++;
+        }
+        return pushed;
+    } else {
+        const auto home = _home();
+        auto pushed = stripes_[home]->_try_push_many(first, last);
+        if (keep_producer_order_) { return pushed; }
+
+        for (size_type i = 1U; i < stripes_.size() && first != last; i++) {
+            pushed += stripes_[(home + i) % stripes_.size()]->_try_push_many(first, last);
+        }
+        return pushed;
+    }
+}
+
+template<typename T, typename Order, typename Wait, typename Allocator>
+template<typename Out>
+inline auto _striped_channel<T, Order, Wait, Allocator>::_try_pop_many(Out &out, const size_type max) -> size_type
+{
+    if constexpr (_timestamped) {
+        size_type popped = 0U;
+        while (popped < max) {
+            auto handle = _try_acquire();
+            if (!handle) { break; }
+
+            *out = std::move(*handle->value);
+            ++out;
+            _release(std::move(*handle));
+            popped++;
+        }
+        return popped;
+    } else {
+        // a whole batch from each stripe in turn
+        const auto start = next_.load(std::memory_order_relaxed);
+        size_type popped = 0U;
+        for (size_type i = 0U; i < stripes_.size() && popped < max; i++) {
+            const auto stripe = (start + i) % stripes_.size();
+            const auto count = stripes_[stripe]->_try_pop_many(out, max - popped);
+            if (count != 0U) {
+                next_.store(stripe + 1U, std::memory_order_relaxed);
+                _freed(stripe, count);
+            }
+            popped += count;
+        }
+        return popped;
+    }
+}
+
+template<typename T, typename Order, typename Wait, typename Allocator>
+template<typename... Args>
+[[nodiscard]] inline auto _striped_channel<T, Order, Wait, Allocator>::_try_reserve_in(
+    const size_type stripe, Args &&...args) -> std::optional<_handle>
+{
+    auto inner = stripes_[stripe]->_try_reserve(std::forward<Args>(args)...);
+    if (!inner) { return std::nullopt; }
+
+    // the slot is ours until _commit publishes it, which also publishes the time
+    if constexpr (_timestamped) {
+        sent_[stripe][stripes_[stripe]->_index(*inner->slot)].store(_now(), std::memory_order_relaxed);
+    }
+    return _handle{ inner->value, stripe, std::move(*inner) };
+}
+
+template<typename T, typename Order, typename Wait, typename Allocator>
+[[nodiscard]] inline auto _striped_channel<T, Order, Wait, Allocator>::_room_waiters() noexcept
+    -> typename Wait::waiter_set &
+{
+    // without an order to keep, room in any stripe will do
+    if (!keep_producer_order_) { return this->not_full_; }
+    return room_[_home()];
+}
+
+template<typename T, typename Order, typename Wait, typename Allocator>
+inline auto _striped_channel<T, Order, Wait, Allocator>::_wake_producers() noexcept -> void
+{
+    for (size_type i = 0U; i < stripes_.size(); i++) { room_[i].notify_all(); }
+}
+
+template<typename T, typename Order, typename Wait, typename Allocator>
+inline auto _striped_channel<T, Order, Wait, Allocator>::_freed(const size_type stripe, const size_type count) noexcept
+    -> void
+{
+    // the others wait on not_full_, which _channel_ops wakes
+    if (!keep_producer_order_) { return; }
+
+    if (count == 1U) {
+        room_[stripe].notify_one();
+    } else {
+        room_[stripe].notify_all();
+    }
+}
+
+template<typename T, typename Order, typename Wait, typename Allocator>
+[[nodiscard]] inline auto _striped_channel<T, Order, Wait, Allocator>::_home() const noexcept -> size_type
+{
+    const auto serial = _thread_serial();
+    const auto count = stripes_.size();
+    auto &entry = homes_[serial % _home_entries];
+
+    auto claimed = entry.load(std::memory_order_acquire);
+    if (claimed == 0U) {
+        const auto home = next_home_.fetch_add(1U, std::memory_order_relaxed) % count;
+        // a thread whose entry we lost the race for keeps its entry, and we fall back below
+        if (entry.compare_exchange_strong(claimed, (serial + 1U) * count + home, std::memory_order_acq_rel)) {
+            return home;
+        }
+    }
+    if (claimed / count == serial + 1U) { return claimed % count; }
+    return serial % count;
+}
+
+template<typename T, typename Order, typename Wait, typename Allocator>
+[[nodiscard]] inline auto _striped_channel<T, Order, Wait, Allocator>::_pick() const noexcept -> size_type
+{
+    const auto next = next_.load(std::memory_order_relaxed) % stripes_.size();
+    if constexpr (!_timestamped) {
+        return next;
+    } else {
+        auto oldest = next;
+        auto oldest_time = UINT64_MAX;
+        for (size_type i = 0U; i < stripes_.size(); i++) {
+            const auto stripe = (next + i) % stripes_.size();
+            // the time may belong to a newer value once another consumer takes the front, which
+            // only makes the pick less exact
+            if (const auto front = stripes_[stripe]->_front()) {
+                const auto time = sent_[stripe][*front].load(std::memory_order_relaxed);
+                if (time < oldest_time) {
+                    oldest = stripe;
+                    oldest_time = time;
+                }
+            }
+        }
+        return oldest;
+    }
+}
+
+template<typename T, typename Order, typename Wait, typename Allocator>
+[[nodiscard]] inline auto _striped_channel<T, Order, Wait, Allocator>::_now() noexcept -> std::uint64_t
+{
+    return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+}
+
+}// namespace nrws
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "narrows/_internal/_arch.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace nrws {
+
+// A set of threads waiting for some condition on a channel to become true (e.g. "not empty").
+//
+// Waiters announce themselves in waiters_ before their final check of the condition, so a
+// notifier that changed the condition either sees the waiter or the waiter sees the change. This
+// lets notify_one/notify_all skip the syscall entirely when nobody is parked.
+//
+// std::atomic::wait can't time out, so waiters with a deadline sleep on a condition variable
+// instead. They are counted separately, and notifiers only touch the condition variable when one
+// of them is actually asleep.
+class _waiter_set
+{
+  public:
+    // Blocks until ready() returns true
+    template<typename Pred>
+    inline auto wait(Pred ready) -> void;
+
+    // Blocks until ready() returns true or the deadline passes, returns the last ready()
+    template<typename Pred, typename Clock, typename Duration>
+    inline auto wait_until(Pred ready, const std::chrono::time_point<Clock, Duration> &deadline) -> bool;
+
+    // Must be called after the state ready() looks at has been changed
+    inline auto notify_one() noexcept -> void;
+    inline auto notify_all() noexcept -> void;
+
+  private:
+    // number of times the condition is re-checked before yielding, then before parking
+    constexpr static int _spin_limit = 64;
+    constexpr static int _yield_limit = 8;
+
+    template<typename Pred>
+    inline auto _spin(Pred ready) -> bool;
+    inline auto _wake_timed() noexcept -> void;
+
+    std::atomic<std::uint32_t> epoch_{ 0U };
+    std::atomic<std::uint32_t> waiters_{ 0U };
+    std::atomic<std::uint32_t> timed_waiters_{ 0U };
+
+    std::mutex timed_mutex_;
+    std::condition_variable timed_cv_;
+};
+
+template<typename Pred>
+inline auto _waiter_set::_spin(Pred ready) -> bool
+{
+    for (int spin = 0; spin < _spin_limit; spin++) {
+        if (ready()) { return true; }
+        _cpu_relax();
+    }
+
+    for (int yield = 0; yield < _yield_limit; yield++) {
+        if (ready()) { return true; }
+        std::this_thread::yield();
+    }
+
+    return false;
+}
+
+template<typename Pred>
+inline auto _waiter_set::wait(Pred ready) -> void
+{
+    if (_spin(ready)) { return; }
+
+    while (!ready()) {
+        waiters_.fetch_add(1U, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        // read the epoch before the last check, any notify after that check bumps it
+        const auto epoch = epoch_.load(std::memory_order_acquire);
+        if (!ready()) { epoch_.wait(epoch, std::memory_order_acquire); }
+
+        waiters_.fetch_sub(1U, std::memory_order_relaxed);
+    }
+}
+
+template<typename Pred, typename Clock, typename Duration>
+inline auto _waiter_set::wait_until(Pred ready, const std::chrono::time_point<Clock, Duration> &deadline) -> bool
+{
+    if (_spin(ready)) { return true; }
+
+    std::unique_lock lock{ timed_mutex_ };
+    while (!ready()) {
+        waiters_.fetch_add(1U, std::memory_order_seq_cst);
+        timed_waiters_.fetch_add(1U, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        // a notifier bumps the epoch before taking timed_mutex_, so it can't slip in between
+        // this check and the condition variable releasing the lock
+        const auto epoch = epoch_.load(std::memory_order_acquire);
+        auto timed_out = false;
+        if (!ready()) {
+            timed_out = !timed_cv_.wait_until(
+                lock, deadline, [this, epoch]() { return epoch_.load(std::memory_order_acquire) != epoch; });
+        }
+
+        timed_waiters_.fetch_sub(1U, std::memory_order_relaxed);
+        waiters_.fetch_sub(1U, std::memory_order_relaxed);
+
+        if (timed_out) { return ready(); }
+    }
+
+    return true;
+}
+
+inline auto _waiter_set::notify_one() noexcept -> void
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters_.load(std::memory_order_relaxed) != 0U) {
+        epoch_.fetch_add(1U, std::memory_order_seq_cst);
+        epoch_.notify_one();
+        _wake_timed();
+    }
+}
+
+inline auto _waiter_set::notify_all() noexcept -> void
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters_.load(std::memory_order_relaxed) != 0U) {
+        epoch_.fetch_add(1U, std::memory_order_seq_cst);
+        epoch_.notify_all();
+        _wake_timed();
+    }
+}
+
+inline auto _waiter_set::_wake_timed() noexcept -> void
+{
+    // timed waiters can't be picked out individually, they all re-check and the losers go back
+    // to sleep. Ordered after the epoch bump, so a timed waiter we miss here sees the new epoch.
+    if (timed_waiters_.load(std::memory_order_seq_cst) != 0U) {
+        { std::lock_guard lock{ timed_mutex_ }; }
+        timed_cv_.notify_all();
+    }
+}
+
+}// namespace nrws
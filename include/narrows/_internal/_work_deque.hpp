@@ -0,0 +1,166 @@
+#pragma once
+
+#include "narrows/_internal/_arch.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace nrws {
+
+// Fixed capacity Chase-Lev work stealing deque.
+//
+// The owning thread pushes and pops at the bottom without any read-modify-write unless it races
+// a thief for the very last value. Other threads steal from the top with a single CAS. This is the
+// bounded variant from "Correct and Efficient Work-Stealing for Weak Memory Models" (Lê et al.).
+//
+// The textbook deque lets a thief read its value before the CAS that claims it, which only works
+// for trivially copyable values. Here a thief claims first and moves the value out after, and
+// every slot carries an occupied flag so the owner never constructs into a slot a thief is still
+// moving out of. It treats such a slot as full instead of waiting.
+template<typename T>
+class _work_deque
+{
+  public:
+    using value_type = std::decay_t<T>;
+    using size_type = std::size_t;
+
+    // The capacity is rounded up to a power of two
+    explicit _work_deque(size_type capacity);
+    ~_work_deque();
+
+    _work_deque(const _work_deque &) = delete;
+    _work_deque &operator=(const _work_deque &) = delete;
+
+    // Owner only, false if the deque is full
+    template<typename... Args>
+    [[nodiscard]] inline auto push(Args &&...args) -> bool;
+    // Owner only, takes the value pushed last
+    [[nodiscard]] inline auto pop() -> std::optional<value_type>;
+
+    // Any thread, takes the value pushed first
+    [[nodiscard]] inline auto steal() -> std::optional<value_type>;
+
+    [[nodiscard]] inline auto size() const noexcept -> size_type;
+    [[nodiscard]] inline auto empty() const noexcept -> bool { return size() == 0U; }
+    [[nodiscard]] inline auto capacity() const noexcept -> size_type { return capacity_; }
+
+  private:
+    struct _slot
+    {
+        std::atomic<bool> occupied{ false };
+        alignas(value_type) std::byte data[sizeof(value_type)];
+
+        [[nodiscard]] inline auto get() noexcept -> value_type *
+        {
+            return std::launder(reinterpret_cast<value_type *>(data));
+        }
+    };
+
+    // moves the value out of a slot this thread claimed and frees the slot
+    [[nodiscard]] static inline auto _take(_slot &slot) -> value_type;
+
+    size_type capacity_;
+    std::unique_ptr<_slot[]> slots_;
+
+    // thieves
+    alignas(_cache_line_size) std::atomic<std::int64_t> top_{ 0 };
+
+    // owner
+    alignas(_cache_line_size) std::atomic<std::int64_t> bottom_{ 0 };
+};
+
+template<typename T>
+_work_deque<T>::_work_deque(const size_type capacity)
+    : capacity_(_next_power_of_two(capacity)), slots_(std::make_unique<_slot[]>(capacity_))
+{}
+
+template<typename T>
+_work_deque<T>::~_work_deque()
+{
+    for (size_type i = 0U; i < capacity_; i++) {
+        if (slots_[i].occupied.load(std::memory_order_relaxed)) { std::destroy_at(slots_[i].get()); }
+    }
+}
+
+template<typename T>
+template<typename... Args>
+[[nodiscard]] inline auto _work_deque<T>::push(Args &&...args) -> bool
+{
+    const auto bottom = bottom_.load(std::memory_order_relaxed);
+    const auto top = top_.load(std::memory_order_acquire);
+    if (static_cast<size_type>(bottom - top) >= capacity_) { return false; }
+
+    // a thief that claimed this slot a lap ago may still be moving out of it
+    auto &slot = slots_[static_cast<size_type>(bottom) & (capacity_ - 1U)];
+    if (slot.occupied.load(std::memory_order_acquire)) { return false; }
+
+    std::construct_at(slot.get(), std::forward<Args>(args)...);
+    slot.occupied.store(true, std::memory_order_relaxed);
+    bottom_.store(bottom + 1, std::memory_order_release);
+    return true;
+}
+
+template<typename T>
+[[nodiscard]] inline auto _work_deque<T>::pop() -> std::optional<value_type>
+{
+    const auto bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    bottom_.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto top = top_.load(std::memory_order_relaxed);
+
+    if (top > bottom) {
+        // empty
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+        return std::nullopt;
+    }
+
+    if (top == bottom) {
+        // the last value, a thief may be after it as well
+        const auto won = top_.compare_exchange_strong(
+            top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+        if (!won) { return std::nullopt; }
+    }
+
+    return _take(slots_[static_cast<size_type>(bottom) & (capacity_ - 1U)]);
+}
+
+template<typename T>
+[[nodiscard]] inline auto _work_deque<T>::steal() -> std::optional<value_type>
+{
+    auto top = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const auto bottom = bottom_.load(std::memory_order_acquire);
+
+    if (top >= bottom) { return std::nullopt; }
+    if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return std::nullopt;
+    }
+
+    return _take(slots_[static_cast<size_type>(top) & (capacity_ - 1U)]);
+}
+
+template<typename T>
+[[nodiscard]] inline auto _work_deque<T>::size() const noexcept -> size_type
+{
+    const auto bottom = bottom_.load(std::memory_order_acquire);
+    const auto top = top_.load(std::memory_order_acquire);
+    return bottom > top ? static_cast<size_type>(bottom - top) : 0U;
+}
+
+template<typename T>
+[[nodiscard]] inline auto _work_deque<T>::_take(_slot &slot) -> value_type
+{
+    value_type value = std::move(*slot.get());
+    std::destroy_at(slot.get());
+    slot.occupied.store(false, std::memory_order_release);
+    return value;
+}
+
+}// namespace nrws
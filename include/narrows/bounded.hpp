@@ -1,231 +1,407 @@
 #pragma once
 
+#include "_internal/_array_channel.hpp"
+#include "_internal/_batch.hpp"
+#include "_internal/_channel_ops.hpp"
 #include "_internal/_multi_channel.hpp"
+#include "_internal/_overflow.hpp"
+#include "_internal/_striped_channel.hpp"
+#include "wait.hpp"
 
+#include <algorithm>
 #include <atomic>
-#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
 #include <optional>
 #include <vector>
 
 namespace nrws {
 
-template<typename T>
-using bounded_channel = _multi_channel<T, std::vector>;
+// Bounded channel guarded by a single mutex. Overflow selects what happens to a value sent while
+// the channel is full, see block_on_full, drop_newest, overwrite_oldest and conflate.
+template<typename T,
+    typename Wait = park_wait,
+    typename Allocator = std::allocator<std::decay_t<T>>,
+    typename Overflow = block_on_full>
+using bounded_channel = _multi_channel<T, std::vector, Wait, Allocator, Overflow>;
+
+// Lock-free bounded channel, producers and consumers claim slots with atomic tickets
+template<typename T, typename Wait = park_wait, typename Allocator = std::allocator<std::decay_t<T>>>
+using array_channel = _array_channel<T, Wait, Allocator>;
+
+// Lock-free bounded channel split into stripes, each producer thread pushes into its own stripe
+// so producers don't contend, and receivers visit the stripes in turn. Extra constructor arguments
+// set the number of stripes and whether a producer may spill into other stripes when its own is
+// full, e.g. nrws::bounded<int, nrws::striped_channel>(4096, 32U). By default there is one stripe
+// per hardware thread, but never fewer than 16 slots per stripe.
+//
+// While producers keep their order (the default), full() and try_send answer for the calling
+// thread's home stripe: one sender can see the channel as full while another still has room.
+template<typename T, typename Wait = park_wait, typename Allocator = std::allocator<std::decay_t<T>>>
+using striped_channel = _striped_channel<T, round_robin_drain, Wait, Allocator>;
+
+// striped_channel whose receivers take the oldest value at the front of any stripe, so values
+// come out close to the order they were sent in across producers
+template<typename T, typename Wait = park_wait, typename Allocator = std::allocator<std::decay_t<T>>>
+using timestamp_striped_channel = _striped_channel<T, timestamp_drain, Wait, Allocator>;
+
+// array_channel with a capacity of N fixed at compile time and its slots stored inline, so it
+// needs no allocation and can be embedded in another object
+template<typename T, std::size_t N, typename Wait = park_wait>
+using static_channel = _array_channel<T, Wait, std::allocator<std::decay_t<T>>, N>;
+
+// binds N so a static_channel can be used where a backend takes only the value type
+template<std::size_t N>
+struct _static_backend
+{
+    template<typename T, typename Wait = park_wait>
+    using type = static_channel<T, N, Wait>;
+};
 
-template<typename T>
-class _multi_channel<T, std::vector>
+// binds an overflow policy so a lossy bounded_channel can be used where a backend takes only the
+// value type, e.g. nrws::bounded<quote, nrws::overflow_backend<nrws::overwrite_oldest>::type>(64)
+template<typename Overflow>
+struct overflow_backend
 {
+    template<typename T, typename Wait = park_wait>
+    using type = bounded_channel<T, Wait, std::allocator<std::decay_t<T>>, Overflow>;
+};
+
+// Channels that take their storage from a std::pmr::memory_resource
+namespace pmr {
+    template<typename T, typename Wait = park_wait>
+    using bounded_channel = nrws::bounded_channel<T, Wait, std::pmr::polymorphic_allocator<std::decay_t<T>>>;
+
+    template<typename T, typename Wait = park_wait>
+    using array_channel = nrws::array_channel<T, Wait, std::pmr::polymorphic_allocator<std::decay_t<T>>>;
+}// namespace pmr
+
+// The ring is raw storage, values are constructed in place when sent and destroyed when they
+// are received, so an idle channel holds no live values and T needs no default constructor.
+// The mutex only guards the ring itself, waiting for room or for a value happens outside of it
+// through the Wait policy. A slot handed out by reserve() or pop_ref() holds the mutex until it
+// is committed or released, so keep those short and hold at most one per thread.
+//
+// A lossy channel has one spare slot past the end of the ring. A value that can't go straight to
+// the head is constructed there and sorted out on commit, where it is dropped, evicts the oldest
+// value or replaces the pending value with its key, so a send never waits. Conflation keeps the
+// slot of every pending key in a hash map, which needs a hashable key and a move assignable T.
+template<typename T, typename Wait, typename Allocator, typename Overflow>
+class _multi_channel<T, std::vector, Wait, Allocator, Overflow>
+    : public _channel_ops<_multi_channel<T, std::vector, Wait, Allocator, Overflow>, T, Wait>
+{
+    using _base = _channel_ops<_multi_channel<T, std::vector, Wait, Allocator, Overflow>, T, Wait>;
+    friend _base;
+
   public:
     using value_type = std::decay_t<T>;
-    using container_type = std::vector<value_type>;
-    using size_type = container_type::size_type;
+    using allocator_type = Allocator;
+    using overflow_type = Overflow;
+    using size_type = std::size_t;
 
-    constexpr explicit _multi_channel(const std::size_t capacity) : size_(0U), vec_(capacity), head_(0U), tail_(0U) {}
-    constexpr _multi_channel(_multi_channel &&other) = default;
+    explicit _multi_channel(const std::size_t capacity, const Allocator &alloc = Allocator());
+    ~_multi_channel();
 
     _multi_channel(const _multi_channel &) = delete;
     _multi_channel &operator=(const _multi_channel &) = delete;
 
-    // Push/Pop API
-    inline auto push(const value_type &value) -> void;
-    inline auto push(value_type &&value) -> void;
-
-    [[nodiscard]] inline auto pop() -> std::optional<value_type>;
-
-    // Closing a channel
-    inline auto close() -> void;
-
     // Channel status
     [[nodiscard]] inline auto size() const noexcept -> size_type;
     [[nodiscard]] inline auto empty() const noexcept -> bool;
     [[nodiscard]] inline auto full() const noexcept -> bool;
-    [[nodiscard]] inline auto closed() const noexcept -> bool;
+    [[nodiscard]] inline auto capacity() const noexcept -> size_type;
 
-    // Iterator type
-    class _iter
+    // Values a lossy channel dropped, or replaced with a newer value for the same key
+    [[nodiscard]] inline auto dropped() const noexcept -> std::uint64_t
     {
-      public:
-        using value_type = value_type;
-
-        explicit _iter(_multi_channel &mc) : mc_(mc) {}
-
-        value_type operator*();
-        _iter &operator++();
-        void operator++(int);
-
-        bool operator==(const _iter &other) const noexcept;
-        bool operator!=(const _iter &other) const noexcept;
+        return dropped_.load(std::memory_order_relaxed);
+    }
+    [[nodiscard]] inline auto conflated() const noexcept -> std::uint64_t
+    {
+        return conflated_.load(std::memory_order_relaxed);
+    }
 
-      private:
-        _multi_channel &mc_;
+  private:
+    // a reserved or acquired slot keeps the channel locked until it is committed or released
+    struct _handle
+    {
+        value_type *value;
+        std::unique_lock<std::mutex> lock;
     };
 
-    // range functions
-    [[nodiscard]] inline auto begin() -> _iter;
-    [[nodiscard]] inline auto end() -> _iter;
+    using _value_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<value_type>;
+    using _value_traits = std::allocator_traits<_value_allocator>;
+
+    using _keys = typename _key_index<Overflow, value_type, Allocator>::type;
+    using _entry_time_type = typename _base::_entry_time_type;
+    using _entry_times = std::conditional_t<_base::_instrumented,
+        std::vector<_entry_time_type,
+            typename std::allocator_traits<Allocator>::template rebind_alloc<_entry_time_type>>,
+        _no_entry_times>;
+
+    constexpr static bool _bounded = true;
+    constexpr static bool _lossy = _overflow_traits<Overflow>::lossy;
+    constexpr static bool _conflating = _overflow_traits<Overflow>::conflating;
+
+    template<typename... Args>
+    inline auto _try_reserve(Args &&...args) -> std::optional<_handle>;
+    inline auto _commit(_handle &&handle) -> void;
+    inline auto _try_acquire() -> std::optional<_handle>;
+    inline auto _release(_handle &&handle) -> void;
+
+    template<typename It, typename S>
+    inline auto _try_push_many(It &first, const S &last) -> size_type;
+    template<typename Out>
+    inline auto _try_pop_many(Out &out, const size_type max) -> size_type;
+
+    // advances a head or tail index by count, wrapping around the end of the vector
+    [[nodiscard]] inline auto _advance(const size_type index, const size_type count) const noexcept -> size_type;
+
+    // lossy channels only
+    [[nodiscard]] inline auto _spare() const noexcept -> value_type * { return buffer_ + capacity_; }
+    // constructs a value where it can be committed right away, the spare slot if it must be sorted out
+    template<typename... Args>
+    [[nodiscard]] inline auto _construct(Args &&...args) -> value_type *;
+    // moves a constructed value into the ring, or applies the overflow policy to the spare slot
+    inline auto _place(value_type *value) -> void;
+    // evicts the oldest value if the ring is full
+    inline auto _make_room() -> void;
+    // conflating channels only
+    [[nodiscard]] static inline auto _key(const value_type &value);
 
-  private:
-    std::atomic<bool> closed_{ false };
     std::atomic<size_type> size_;
-    container_type vec_;
+    _value_allocator alloc_;
+    size_type capacity_;
+    value_type *buffer_;
 
     size_type head_;
     size_type tail_;
 
     std::mutex mutex_;
-    std::condition_variable cv_;
+
+    [[no_unique_address]] _keys keys_;
+    // when the value in each slot was sent, instrumented channels only
+    [[no_unique_address]] _entry_times entered_;
+    std::atomic<std::uint64_t> dropped_{ 0U };
+    std::atomic<std::uint64_t> conflated_{ 0U };
 };
 
-template<typename T>
-inline auto _multi_channel<T, std::vector>::push(const value_type &value) -> void
+template<typename T, typename Wait, typename Allocator, typename Overflow>
+_multi_channel<T, std::vector, Wait, Allocator, Overflow>::_multi_channel(const std::size_t capacity, const Allocator &alloc)
+    : size_(0U), alloc_(alloc), capacity_(capacity),
+      buffer_(_value_traits::allocate(alloc_, capacity + (_lossy ? 1U : 0U))), head_(0U), tail_(0U), keys_(alloc),
+      entered_(capacity + (_lossy ? 1U : 0U), alloc)
+{}
+
+template<typename T, typename Wait, typename Allocator, typename Overflow>
+_multi_channel<T, std::vector, Wait, Allocator, Overflow>::~_multi_channel()
 {
-    {
-        // obtain a lock, then wait for the channel to not be full
-        std::unique_lock lock{ mutex_ };
-        cv_.wait(lock, [this]() { return !full(); });
-
-        // place the value in the vector
-        vec_[head_] = value;
-        size_++;
-
-        // update the head pointer by either incrementing to the next point
-        // or by reseting to the front of the vector
-        if (head_ == vec_.size() - 1) {
-            head_ = 0U;
-        } else {
-            head_++;
-        }
+    // destroy anything that was never received
+    for (size_type i = 0U, index = tail_; i < size_; i++, index = _advance(index, 1U)) {
+        std::destroy_at(buffer_ + index);
     }
 
-    cv_.notify_one();
+    _value_traits::deallocate(alloc_, buffer_, capacity_ + (_lossy ? 1U : 0U));
 }
 
-template<typename T>
-inline auto _multi_channel<T, std::vector>::push(value_type &&value) -> void
+template<typename T, typename Wait, typename Allocator, typename Overflow>
+template<typename... Args>
+inline auto _multi_channel<T, std::vector, Wait, Allocator, Overflow>::_try_reserve(Args &&...args) -> std::optional<_handle>
 {
-    {
-        // obtain a lock, then wait for the channel to not be full
-        std::unique_lock lock{ mutex_ };
-        cv_.wait(lock, [this]() { return !full(); });
-
-        // place the value in the vector
-        vec_[head_] = std::forward<value_type>(value);
-        size_++;
-
-        // update the head pointer by either incrementing to the next point
-        // or by reseting to the front of the vector
-        if (head_ == vec_.size() - 1) {
-            head_ = 0U;
-        } else {
-            head_++;
-        }
+    auto lock = this->_lock(mutex_);
+    if constexpr (!_lossy) {
+        if (full()) { return std::nullopt; }
     }
 
-    cv_.notify_one();
+    auto *value = _construct(std::forward<Args>(args)...);
+    return _handle{ value, std::move(lock) };
+}
+
+template<typename T, typename Wait, typename Allocator, typename Overflow>
+inline auto _multi_channel<T, std::vector, Wait, Allocator, Overflow>::_commit(_handle &&handle) -> void
+{
+    _place(handle.value);
+    handle.lock.unlock();
 }
 
-template<typename T>
-[[nodiscard]] inline auto _multi_channel<T, std::vector>::pop() -> std::optional<value_type>
+template<typename T, typename Wait, typename Allocator, typename Overflow>
+inline auto _multi_channel<T, std::vector, Wait, Allocator, Overflow>::_try_acquire() -> std::optional<_handle>
 {
-    std::optional<value_type> value{ std::nullopt };
+    auto lock = this->_lock(mutex_);
+    if (empty()) { return std::nullopt; }
 
-    {
-        // obtain a lock and wait for the channel to not be empty or for the
-        // channel to close
-        std::unique_lock lock{ mutex_ };
-        cv_.wait(lock, [this]() { return !empty() || closed(); });
-
-        if (!empty()) { value = vec_[tail_]; }
-
-        // update the tail index
-        if (tail_ == vec_.size() - 1) {
-            tail_ = 0U;
-        } else {
-            tail_++;
-        }
+    // the value is on its way out, a newer one with its key has to be queued again
+    if constexpr (_conflating) { keys_.erase(_key(buffer_[tail_])); }
+    return _handle{ buffer_ + tail_, std::move(lock) };
+}
+
+template<typename T, typename Wait, typename Allocator, typename Overflow>
+inline auto _multi_channel<T, std::vector, Wait, Allocator, Overflow>::_release(_handle &&handle) -> void
+{
+    this->_leave(entered_[tail_]);
+    std::destroy_at(handle.value);
+    tail_ = _advance(tail_, 1U);
+    size_--;
 
-        // update the size
-        size_--;
+    handle.lock.unlock();
+}
+
+template<typename T, typename Wait, typename Allocator, typename Overflow>
+template<typename It, typename S>
+inline auto _multi_channel<T, std::vector, Wait, Allocator, Overflow>::_try_push_many(It &first, const S &last) -> size_type
+{
+    auto lock = this->_lock(mutex_);
+    if constexpr (_lossy) {
+        // every value is taken, one at a time as each may displace another
+        size_type pushed = 0U;
+        for (; first != last; ++first, pushed++) { _place(_construct(*first)); }
+        return pushed;
     }
 
-    cv_.notify_one();
+    const auto free = capacity_ - size_;
+
+    // the free space is at most two contiguous segments, one before and one after the wrap
+    size_type pushed = 0U;
+    while (pushed < free && first != last) {
+        const auto segment = std::min(free - pushed, capacity_ - head_);
+        const auto count = _construct_segment(first, last, buffer_ + head_, segment);
+        if constexpr (_base::_instrumented) {
+            for (size_type i = 0U; i < count; i++) { this->_enter(entered_[head_ + i]); }
+        }
+
+        head_ = _advance(head_, count);
+        pushed += count;
+        if (count < segment) { break; }
+    }
 
-    // return the value from the vector
-    return value;
+    size_ += pushed;
+    return pushed;
 }
 
-template<typename T>
-inline auto _multi_channel<T, std::vector>::close() -> void
+template<typename T, typename Wait, typename Allocator, typename Overflow>
+template<typename Out>
+inline auto _multi_channel<T, std::vector, Wait, Allocator, Overflow>::_try_pop_many(Out &out, const size_type max) -> size_type
 {
-    closed_ = true;
-    cv_.notify_all();
+    auto lock = this->_lock(mutex_);
+    const auto available = std::min(max, size_.load());
+
+    size_type popped = 0U;
+    while (popped < available) {
+        const auto segment = std::min(available - popped, capacity_ - tail_);
+
+        if constexpr (_conflating) {
+            for (size_type i = 0U; i < segment; i++) { keys_.erase(_key(buffer_[tail_ + i])); }
+        }
+        if constexpr (_base::_instrumented) {
+            for (size_type i = 0U; i < segment; i++) { this->_leave(entered_[tail_ + i]); }
+        }
+        _move_segment_out(buffer_ + tail_, segment, out);
+        std::destroy_n(buffer_ + tail_, segment);
+        tail_ = _advance(tail_, segment);
+        popped += segment;
+    }
+
+    size_ -= popped;
+    return popped;
 }
 
-template<typename T>
-[[nodiscard]] inline auto _multi_channel<T, std::vector>::size() const noexcept -> size_type
+template<typename T, typename Wait, typename Allocator, typename Overflow>
+[[nodiscard]] inline auto _multi_channel<T, std::vector, Wait, Allocator, Overflow>::size() const noexcept -> size_type
 {
     return size_;
 }
 
-template<typename T>
-[[nodiscard]] inline auto _multi_channel<T, std::vector>::empty() const noexcept -> bool
+template<typename T, typename Wait, typename Allocator, typename Overflow>
+[[nodiscard]] inline auto _multi_channel<T, std::vector, Wait, Allocator, Overflow>::empty() const noexcept -> bool
 {
     return size_ == 0;
 }
 
-template<typename T>
-[[nodiscard]] inline auto _multi_channel<T, std::vector>::full() const noexcept -> bool
+template<typename T, typename Wait, typename Allocator, typename Overflow>
+[[nodiscard]] inline auto _multi_channel<T, std::vector, Wait, Allocator, Overflow>::full() const noexcept -> bool
 {
-    return size_ == vec_.size();
+    return size_ == capacity_;
 }
 
-template<typename T>
-[[nodiscard]] inline auto _multi_channel<T, std::vector>::closed() const noexcept -> bool
+template<typename T, typename Wait, typename Allocator, typename Overflow>
+[[nodiscard]] inline auto _multi_channel<T, std::vector, Wait, Allocator, Overflow>::capacity() const noexcept -> size_type
 {
-    return closed_;
+    return capacity_;
 }
 
-template<typename T>
-_multi_channel<T, std::vector>::_iter::value_type _multi_channel<T, std::vector>::_iter::operator*()
+template<typename T, typename Wait, typename Allocator, typename Overflow>
+[[nodiscard]] inline auto _multi_channel<T, std::vector, Wait, Allocator, Overflow>::_advance(const size_type index,
+    const size_type count) const noexcept -> size_type
 {
-    return *mc_.pop();
+    const auto next = index + count;
+    return next >= capacity_ ? next - capacity_ : next;
 }
 
-template<typename T>
-_multi_channel<T, std::vector>::_iter &_multi_channel<T, std::vector>::_iter::operator++()
+template<typename T, typename Wait, typename Allocator, typename Overflow>
+template<typename... Args>
+[[nodiscard]] inline auto _multi_channel<T, std::vector, Wait, Allocator, Overflow>::_construct(Args &&...args)
+    -> value_type *
 {
-    return *this;
+    // a conflated value may replace a pending one, so it always waits in the spare slot
+    const auto spare = _conflating || (_lossy && full());
+    return std::construct_at(spare ? _spare() : buffer_ + head_, std::forward<Args>(args)...);
 }
 
-template<typename T>
-void _multi_channel<T, std::vector>::_iter::operator++(int)
-{}
-
-template<typename T>
-bool _multi_channel<T, std::vector>::_iter::operator==(const _iter &other) const noexcept
+template<typename T, typename Wait, typename Allocator, typename Overflow>
+inline auto _multi_channel<T, std::vector, Wait, Allocator, Overflow>::_place(value_type *value) -> void
 {
-    std::unique_lock lock{ mc_.mutex_ };
-    mc_.cv_.wait(lock, [this]() { return !mc_.empty() || mc_.closed(); });
+    if constexpr (_lossy) {
+        if (value == _spare()) {
+            if constexpr (_conflating) {
+                auto key = _key(*value);
+                if (auto pending = keys_.find(key); pending != keys_.end()) {
+                    buffer_[pending->second] = std::move(*value);
+                    std::destroy_at(value);
+                    this->_enter(entered_[pending->second]);
+                    conflated_.fetch_add(1U, std::memory_order_relaxed);
+                    return;
+                }
+
+                _make_room();
+                keys_.emplace(std::move(key), head_);
+            } else if constexpr (std::is_same_v<Overflow, drop_newest>) {
+                std::destroy_at(value);
+                dropped_.fetch_add(1U, std::memory_order_relaxed);
+                return;
+            } else {
+                _make_room();
+            }
+
+            std::construct_at(buffer_ + head_, std::move(*value));
+            std::destroy_at(value);
+        }
+    }
 
-    return mc_.empty() || mc_.closed();
+    // move the head to the next slot
+    this->_enter(entered_[head_]);
+    head_ = _advance(head_, 1U);
+    size_++;
 }
 
-template<typename T>
-bool _multi_channel<T, std::vector>::_iter::operator!=(const _iter &other) const noexcept
+template<typename T, typename Wait, typename Allocator, typename Overflow>
+inline auto _multi_channel<T, std::vector, Wait, Allocator, Overflow>::_make_room() -> void
 {
-    return not(this->operator==(other));
-}
+    if (!full()) { return; }
 
-template<typename T>
-[[nodiscard]] inline auto _multi_channel<T, std::vector>::begin() -> _iter
-{
-    return _iter(*this);
+    if constexpr (_conflating) { keys_.erase(_key(buffer_[tail_])); }
+    std::destroy_at(buffer_ + tail_);
+    tail_ = _advance(tail_, 1U);
+    size_--;
+    dropped_.fetch_add(1U, std::memory_order_relaxed);
 }
 
-template<typename T>
-[[nodiscard]] inline auto _multi_channel<T, std::vector>::end() -> _iter
+template<typename T, typename Wait, typename Allocator, typename Overflow>
+[[nodiscard]] inline auto _multi_channel<T, std::vector, Wait, Allocator, Overflow>::_key(const value_type &value)
 {
-    return _iter(*this);
+    return typename Overflow::key_of{}(value);
 }
 
 }// namespace nrws
@@ -0,0 +1,189 @@
+#pragma once
+
+#include "narrows/_internal/_broadcast_channel.hpp"
+#include "narrows/concepts.hpp"
+#include "narrows/single_bounded.hpp"
+#include "narrows/wait.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <expected>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace nrws {
+
+template<typename T, lag_policy Policy, typename Wait>
+class broadcast_receiver;
+
+// Sending end of a broadcast channel, every value it sends is received by every subscriber. Copies
+// share the channel, so several threads can send.
+template<typename T, lag_policy Policy = lag_policy::block, typename Wait = park_wait>
+class broadcast_sender
+{
+  public:
+    using value_type = std::decay_t<T>;
+    using error_type = sender_error_t;
+    using result_type = std::expected<void, error_type>;
+    using channel_type = _broadcast_channel<T, Wait, Policy>;
+    using receiver_type = broadcast_receiver<T, Policy, Wait>;
+
+    explicit broadcast_sender(std::shared_ptr<channel_type> channel) : channel_(std::move(channel)) {}
+
+    // Blocks while the slowest subscriber is a whole ring behind, unless lagging subscribers
+    // are dropped
+    [[nodiscard]] inline auto send(const value_type &val) -> result_type { return _to_result(_push(val)); }
+    [[nodiscard]] inline auto send(value_type &&val) -> result_type { return _to_result(_push(std::move(val))); }
+
+    // Never blocks, returns ChannelFull if the slowest subscriber holds the ring
+    [[nodiscard]] inline auto try_send(const value_type &val) -> result_type
+    {
+        return _to_result(channel_->try_push(val));
+    }
+    [[nodiscard]] inline auto try_send(value_type &&val) -> result_type
+    {
+        return _to_result(channel_->try_push(std::move(val)));
+    }
+
+    template<typename Clock, typename Duration>
+    [[nodiscard]] inline auto send_until(const value_type &val, const std::chrono::time_point<Clock, Duration> &deadline)
+        -> result_type
+    {
+        return _to_result(channel_->push_until(val, deadline));
+    }
+    template<typename Clock, typename Duration>
+    [[nodiscard]] inline auto send_until(value_type &&val, const std::chrono::time_point<Clock, Duration> &deadline)
+        -> result_type
+    {
+        return _to_result(channel_->push_until(std::move(val), deadline));
+    }
+    template<typename Rep, typename Period>
+    [[nodiscard]] inline auto send_for(const value_type &val, const std::chrono::duration<Rep, Period> &timeout)
+        -> result_type
+    {
+        return send_until(val, std::chrono::steady_clock::now() + timeout);
+    }
+    template<typename Rep, typename Period>
+    [[nodiscard]] inline auto send_for(value_type &&val, const std::chrono::duration<Rep, Period> &timeout)
+        -> result_type
+    {
+        return send_until(std::move(val), std::chrono::steady_clock::now() + timeout);
+    }
+
+    // Joins at the head, the new receiver sees everything sent from now on
+    [[nodiscard]] inline auto subscribe() -> receiver_type { return receiver_type(channel_); }
+    [[nodiscard]] inline auto subscribers() -> std::size_t { return channel_->subscribers(); }
+
+    inline auto close() { channel_->close(); }
+
+  private:
+    template<typename V>
+    [[nodiscard]] inline auto _push(V &&val) -> channel_status
+    {
+        return channel_->push(std::forward<V>(val)) ? channel_status::success : channel_status::closed;
+    }
+
+    [[nodiscard]] static inline auto _to_result(channel_status status) -> result_type;
+
+    std::shared_ptr<channel_type> channel_;
+};
+static_assert(is_sender<broadcast_sender<int>>, "Must satisfy the sender concept.");
+
+// One subscription to a broadcast channel, with its own cursor. Leaves the channel when destroyed.
+template<typename T, lag_policy Policy = lag_policy::block, typename Wait = park_wait>
+class broadcast_receiver
+{
+  public:
+    using value_type = std::decay_t<T>;
+    using error_type = receiver_error_t;
+    using result_type = std::expected<value_type, error_type>;
+    using channel_type = _broadcast_channel<T, Wait, Policy>;
+
+    explicit broadcast_receiver(std::shared_ptr<channel_type> channel)
+        : channel_(std::move(channel)), cursor_(channel_->subscribe())
+    {}
+    ~broadcast_receiver()
+    {
+        if (cursor_) { channel_->unsubscribe(*cursor_); }
+    }
+
+    broadcast_receiver(const broadcast_receiver &) = delete;
+    broadcast_receiver &operator=(const broadcast_receiver &) = delete;
+    broadcast_receiver(broadcast_receiver &&) noexcept = default;
+    broadcast_receiver &operator=(broadcast_receiver &&) noexcept = delete;
+
+    // Returns ChannelClosed once the channel closed and everything sent before was received, or
+    // Lagged if the subscriber fell a whole ring behind and was dropped
+    [[nodiscard]] inline auto receive() -> result_type { return _to_result(channel_->pop(*cursor_)); }
+
+    // Never blocks, returns ChannelEmpty if nothing new was sent
+    [[nodiscard]] inline auto try_receive() -> result_type { return _to_result(channel_->try_pop(*cursor_)); }
+
+    template<typename Clock, typename Duration>
+    [[nodiscard]] inline auto receive_until(const std::chrono::time_point<Clock, Duration> &deadline) -> result_type
+    {
+        return _to_result(channel_->pop_until(*cursor_, deadline));
+    }
+    template<typename Rep, typename Period>
+    [[nodiscard]] inline auto receive_for(const std::chrono::duration<Rep, Period> &timeout) -> result_type
+    {
+        return receive_until(std::chrono::steady_clock::now() + timeout);
+    }
+
+  private:
+    [[nodiscard]] static inline auto _to_result(std::expected<value_type, channel_status> &&received) -> result_type;
+
+    std::shared_ptr<channel_type> channel_;
+    std::unique_ptr<typename channel_type::_cursor> cursor_;
+};
+static_assert(is_receiver<broadcast_receiver<int>>, "Must satisfy the receiver concept");
+
+// Creates a channel where every subscriber receives every value. The sender writes each value into
+// the ring once, and subscribers join with sender.subscribe() and leave by dropping the receiver.
+// The capacity is rounded up to a power of two.
+//
+//     auto tap = nrws::broadcast<packet, nrws::lag_policy::drop>(1024);
+//     auto audit = tap.subscribe();
+//     auto metrics = tap.subscribe();
+template<typename T, lag_policy Policy = lag_policy::block, typename Wait = park_wait>
+[[nodiscard]] auto broadcast(const std::size_t capacity) -> broadcast_sender<T, Policy, Wait>
+{
+    return broadcast_sender<T, Policy, Wait>(std::make_shared<_broadcast_channel<T, Wait, Policy>>(capacity));
+}
+
+template<typename T, lag_policy Policy, typename Wait>
+[[nodiscard]] inline auto broadcast_sender<T, Policy, Wait>::_to_result(const channel_status status) -> result_type
+{
+    switch (status) {
+    case channel_status::success:
+        return result_type{};
+    case channel_status::full:
+        return std::unexpected(sender_error_t::ChannelFull);
+    case channel_status::timeout:
+        return std::unexpected(sender_error_t::Timeout);
+    default:
+        return std::unexpected(sender_error_t::ChannelClosed);
+    }
+}
+
+template<typename T, lag_policy Policy, typename Wait>
+[[nodiscard]] inline auto broadcast_receiver<T, Policy, Wait>::_to_result(
+    std::expected<value_type, channel_status> &&received) -> result_type
+{
+    if (received.has_value()) { return std::move(*received); }
+
+    switch (received.error()) {
+    case channel_status::empty:
+        return std::unexpected(receiver_error_t::ChannelEmpty);
+    case channel_status::timeout:
+        return std::unexpected(receiver_error_t::Timeout);
+    case channel_status::full:
+        // the channel reports a dropped cursor as full
+        return std::unexpected(receiver_error_t::Lagged);
+    default:
+        return std::unexpected(receiver_error_t::ChannelClosed);
+    }
+}
+
+}// namespace nrws
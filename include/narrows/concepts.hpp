@@ -1,6 +1,7 @@
 #pragma once
 
-#include <__expected/expected.h>
+#include <expected>
+#include <chrono>
 #include <concepts>
 #include <iterator>
 
@@ -24,7 +25,7 @@ concept is_sender = requires(S sender) {
     typename S::result_type;
 
     // result types must be convertible to expected
-    std::convertible_to<typename S::result_type, std::expected<void, typename S::result_type>>;
+    requires std::convertible_to<typename S::result_type, std::expected<void, typename S::error_type>>;
 } && requires(S sender, const S::value_type &val) {
     { sender.send(val) } -> std::same_as<typename S::result_type>;
 } && requires(S sender, S::value_type &&val) {
@@ -38,9 +39,22 @@ concept is_receiver = requires(R receiver) {
     typename R::result_type;
 
     // result type must be convertible to expected
-    std::convertible_to<typename R::result_type, std::expected<typename R::value_type, typename R::result_type>>;
+    requires std::convertible_to<typename R::result_type, std::expected<typename R::value_type, typename R::error_type>>;
 } && requires(R receiver) {
     { receiver.receive() } -> std::same_as<typename R::result_type>;
 };
 
+template<typename W>
+concept is_wait_policy = requires(typename W::waiter_set waiters) {
+    waiters.wait([]() { return true; });
+    { waiters.wait_until([]() { return true; }, std::chrono::steady_clock::now()) } -> std::same_as<bool>;
+    { waiters.notify_one() } noexcept;
+    { waiters.notify_all() } noexcept;
+};
+
+// Runs posted work at some later point, on some thread. Suspended coroutines are resumed through
+// one, so post() must never run the work inline.
+template<typename E>
+concept is_executor = requires(E executor) { executor.post([]() {}); };
+
 }// namespace nrws
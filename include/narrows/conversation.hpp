@@ -0,0 +1,234 @@
+#pragma once
+
+#include "narrows/_internal/_arch.hpp"
+#include "narrows/_internal/_errors.hpp"
+#include "narrows/wait.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <expected>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace nrws {
+
+// Zero capacity channel, a push only completes once a receiver has taken the value.
+//
+// There is no buffer. A sender offers its value by publishing a pointer to it in a single exchange
+// slot, and the receiver that claims the slot moves the value straight out of the sender's stack
+// frame. Claiming and withdrawing an offer are a single atomic exchange or CAS each, and waiting
+// goes through the Wait policy like every other channel:
+//
+//   - senders wait for the slot to be free (only one offer is out at a time),
+//   - the offering sender waits for its value to be taken,
+//   - receivers wait for an offer.
+//
+// A sender that times out or sees the channel close withdraws its offer, unless a receiver claimed
+// it first, in which case the push still completes.
+template<typename T, typename Wait = park_wait>
+class conversation
+{
+  public:
+    using value_type = std::decay_t<T>;
+
+    conversation() = default;
+
+    conversation(const conversation &) = delete;
+    conversation &operator=(const conversation &) = delete;
+
+    // Blocks until a receiver took the value, returns false if the channel closed first
+    inline auto push(const value_type &value) -> bool;
+    inline auto push(value_type &&value) -> bool;
+
+    // Gives up with timeout once the deadline passed without a receiver taking the value
+    template<typename Clock, typename Duration>
+    inline auto push_until(const value_type &value, const std::chrono::time_point<Clock, Duration> &deadline)
+        -> channel_status;
+    template<typename Clock, typename Duration>
+    inline auto push_until(value_type &&value, const std::chrono::time_point<Clock, Duration> &deadline)
+        -> channel_status;
+
+    // Blocks until a sender offers a value, nullopt once the channel is closed
+    [[nodiscard]] inline auto pop() -> std::optional<value_type>;
+    // Takes a value only if a sender is offering one right now
+    [[nodiscard]] inline auto try_pop() -> std::expected<value_type, channel_status>;
+    template<typename Clock, typename Duration>
+    [[nodiscard]] inline auto pop_until(const std::chrono::time_point<Clock, Duration> &deadline)
+        -> std::expected<value_type, channel_status>;
+
+    inline auto close() -> void;
+    [[nodiscard]] inline auto closed() const noexcept -> bool { return closed_.load(std::memory_order_acquire); }
+
+  private:
+    // lives on the sender's stack until the receiver set taken
+    struct _offer
+    {
+        value_type *value;
+        bool movable;
+        std::atomic<bool> taken{ false };
+    };
+
+    template<typename Clock, typename Duration>
+    inline auto _push(_offer &offer, const std::chrono::time_point<Clock, Duration> *deadline) -> channel_status;
+    [[nodiscard]] inline auto _claim() noexcept -> _offer *;
+    [[nodiscard]] inline auto _take(_offer *offer) -> value_type;
+
+    alignas(_cache_line_size) std::atomic<_offer *> offer_{ nullptr };
+    alignas(_cache_line_size) std::atomic<bool> closed_{ false };
+    typename Wait::waiter_set free_;
+    typename Wait::waiter_set taken_;
+    typename Wait::waiter_set offered_;
+};
+
+template<typename T, typename Wait>
+inline auto conversation<T, Wait>::push(const value_type &value) -> bool
+{
+    // the receiver copies out of a const offer
+    _offer offer{ const_cast<value_type *>(&value), false };
+    return _push(offer, static_cast<const std::chrono::steady_clock::time_point *>(nullptr)) == channel_status::success;
+}
+
+template<typename T, typename Wait>
+inline auto conversation<T, Wait>::push(value_type &&value) -> bool
+{
+    _offer offer{ &value, true };
+    return _push(offer, static_cast<const std::chrono::steady_clock::time_point *>(nullptr)) == channel_status::success;
+}
+
+template<typename T, typename Wait>
+template<typename Clock, typename Duration>
+inline auto conversation<T, Wait>::push_until(
+    const value_type &value, const std::chrono::time_point<Clock, Duration> &deadline) -> channel_status
+{
+    _offer offer{ const_cast<value_type *>(&value), false };
+    return _push(offer, &deadline);
+}
+
+template<typename T, typename Wait>
+template<typename Clock, typename Duration>
+inline auto conversation<T, Wait>::push_until(
+    value_type &&value, const std::chrono::time_point<Clock, Duration> &deadline) -> channel_status
+{
+    _offer offer{ &value, true };
+    return _push(offer, &deadline);
+}
+
+template<typename T, typename Wait>
+[[nodiscard]] inline auto conversation<T, Wait>::pop() -> std::optional<value_type>
+{
+    while (true) {
+        if (auto *offer = _claim()) { return _take(offer); }
+        if (closed()) { return std::nullopt; }
+
+        offered_.wait([this]() { return offer_.load(std::memory_order_acquire) != nullptr || closed(); });
+    }
+}
+
+template<typename T, typename Wait>
+[[nodiscard]] inline auto conversation<T, Wait>::try_pop() -> std::expected<value_type, channel_status>
+{
+    if (auto *offer = _claim()) { return _take(offer); }
+    if (closed()) { return std::unexpected(channel_status::closed); }
+    return std::unexpected(channel_status::empty);
+}
+
+template<typename T, typename Wait>
+template<typename Clock, typename Duration>
+[[nodiscard]] inline auto conversation<T, Wait>::pop_until(const std::chrono::time_point<Clock, Duration> &deadline)
+    -> std::expected<value_type, channel_status>
+{
+    while (true) {
+        if (auto *offer = _claim()) { return _take(offer); }
+        if (closed()) { return std::unexpected(channel_status::closed); }
+
+        if (!offered_.wait_until(
+                [this]() { return offer_.load(std::memory_order_acquire) != nullptr || closed(); }, deadline)) {
+            return std::unexpected(channel_status::timeout);
+        }
+    }
+}
+
+template<typename T, typename Wait>
+inline auto conversation<T, Wait>::close() -> void
+{
+    closed_.store(true, std::memory_order_seq_cst);
+    free_.notify_all();
+    taken_.notify_all();
+    offered_.notify_all();
+}
+
+template<typename T, typename Wait>
+template<typename Clock, typename Duration>
+inline auto conversation<T, Wait>::_push(_offer &offer, const std::chrono::time_point<Clock, Duration> *deadline)
+    -> channel_status
+{
+    // wait for the exchange slot
+    while (true) {
+        if (closed()) { return channel_status::closed; }
+
+        _offer *expected = nullptr;
+        if (offer_.compare_exchange_weak(expected, &offer, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+            break;
+        }
+
+        const auto free = [this]() { return offer_.load(std::memory_order_acquire) == nullptr || closed(); };
+        if (deadline == nullptr) {
+            free_.wait(free);
+        } else if (!free_.wait_until(free, *deadline)) {
+            return channel_status::timeout;
+        }
+    }
+    offered_.notify_one();
+
+    // wait for a receiver
+    const auto done = [this, &offer]() { return offer.taken.load(std::memory_order_acquire) || closed(); };
+    auto in_time = true;
+    if (deadline == nullptr) {
+        taken_.wait(done);
+    } else {
+        in_time = taken_.wait_until(done, *deadline);
+    }
+    if (offer.taken.load(std::memory_order_acquire)) { return channel_status::success; }
+
+    // withdraw the offer, unless a receiver claimed it in the meantime
+    auto *expected = &offer;
+    if (offer_.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel)) {
+        free_.notify_one();
+        return in_time ? channel_status::closed : channel_status::timeout;
+    }
+
+    // the receiver is moving the value out of our frame right now
+    taken_.wait([&offer]() { return offer.taken.load(std::memory_order_acquire); });
+    return channel_status::success;
+}
+
+template<typename T, typename Wait>
+[[nodiscard]] inline auto conversation<T, Wait>::_claim() noexcept -> _offer *
+{
+    // only pay for the exchange when there is something to claim
+    if (offer_.load(std::memory_order_relaxed) == nullptr) { return nullptr; }
+    return offer_.exchange(nullptr, std::memory_order_acq_rel);
+}
+
+template<typename T, typename Wait>
+[[nodiscard]] inline auto conversation<T, Wait>::_take(_offer *offer) -> value_type
+{
+    // the slot is free again as soon as we claimed it
+    free_.notify_one();
+
+    // only copyable values can have been offered through the const push
+    auto value = [offer]() -> value_type {
+        if constexpr (std::is_copy_constructible_v<value_type>) {
+            if (!offer->movable) { return *offer->value; }
+        }
+        return std::move(*offer->value);
+    }();
+
+    // the sender may return and destroy the offer as soon as this is visible
+    offer->taken.store(true, std::memory_order_release);
+    taken_.notify_all();
+    return value;
+}
+
+}// namespace nrws
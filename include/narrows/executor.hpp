@@ -0,0 +1,177 @@
+#pragma once
+
+#include "narrows/concepts.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace nrws {
+
+// Runs posted work on whichever thread calls run() or poll(). Useful to drive many coroutines
+// from a single thread.
+class run_loop
+{
+  public:
+    run_loop() = default;
+
+    run_loop(const run_loop &) = delete;
+    run_loop &operator=(const run_loop &) = delete;
+
+    // Thread safe, the work runs later on the loop's thread
+    template<typename F>
+    inline auto post(F &&work) -> void;
+
+    // Runs posted work until stop() is called, waiting for more while the queue is empty
+    inline auto run() -> void;
+    // Runs the work that is queued right now and returns how much that was, never waits
+    inline auto poll() -> std::size_t;
+    inline auto stop() -> void;
+
+  private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::move_only_function<void()>> queue_;
+    bool stopped_{ false };
+};
+static_assert(is_executor<run_loop>, "Must satisfy the executor concept");
+
+// Runs posted work on a fixed set of threads. The destructor finishes everything that was posted
+// before joining them.
+class thread_pool
+{
+  public:
+    explicit thread_pool(std::size_t threads = std::thread::hardware_concurrency());
+    ~thread_pool();
+
+    thread_pool(const thread_pool &) = delete;
+    thread_pool &operator=(const thread_pool &) = delete;
+
+    template<typename F>
+    inline auto post(F &&work) -> void;
+
+    [[nodiscard]] inline auto size() const noexcept -> std::size_t { return threads_.size(); }
+
+  private:
+    inline auto _work() -> void;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::move_only_function<void()>> queue_;
+    bool stopping_{ false };
+    std::vector<std::thread> threads_;
+};
+static_assert(is_executor<thread_pool>, "Must satisfy the executor concept");
+
+/* Run Loop Implementations */
+
+template<typename F>
+inline auto run_loop::post(F &&work) -> void
+{
+    {
+        std::lock_guard lock{ mutex_ };
+        queue_.emplace_back(std::forward<F>(work));
+    }
+    cv_.notify_one();
+}
+
+inline auto run_loop::run() -> void
+{
+    std::unique_lock lock{ mutex_ };
+    while (true) {
+        cv_.wait(lock, [this]() { return stopped_ || !queue_.empty(); });
+        if (stopped_) {
+            stopped_ = false;
+            return;
+        }
+
+        auto work = std::move(queue_.front());
+        queue_.pop_front();
+
+        lock.unlock();
+        work();
+        lock.lock();
+    }
+}
+
+inline auto run_loop::poll() -> std::size_t
+{
+    std::unique_lock lock{ mutex_ };
+    auto count = queue_.size();
+
+    // work posted while polling waits for the next poll
+    for (std::size_t i = 0U; i < count; i++) {
+        auto work = std::move(queue_.front());
+        queue_.pop_front();
+
+        lock.unlock();
+        work();
+        lock.lock();
+    }
+
+    return count;
+}
+
+inline auto run_loop::stop() -> void
+{
+    {
+        std::lock_guard lock{ mutex_ };
+        stopped_ = true;
+    }
+    cv_.notify_all();
+}
+
+/* Thread Pool Implementations */
+
+inline thread_pool::thread_pool(const std::size_t threads)
+{
+    const auto count = threads == 0U ? 1U : threads;
+    threads_.reserve(count);
+    for (std::size_t i = 0U; i < count; i++) {
+        threads_.emplace_back([this]() { _work(); });
+    }
+}
+
+inline thread_pool::~thread_pool()
+{
+    {
+        std::lock_guard lock{ mutex_ };
+        stopping_ = true;
+    }
+    cv_.notify_all();
+
+    for (auto &thread : threads_) { thread.join(); }
+}
+
+template<typename F>
+inline auto thread_pool::post(F &&work) -> void
+{
+    {
+        std::lock_guard lock{ mutex_ };
+        queue_.emplace_back(std::forward<F>(work));
+    }
+    cv_.notify_one();
+}
+
+inline auto thread_pool::_work() -> void
+{
+    std::unique_lock lock{ mutex_ };
+    while (true) {
+        cv_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+        if (queue_.empty()) { return; }
+
+        auto work = std::move(queue_.front());
+        queue_.pop_front();
+
+        lock.unlock();
+        work();
+        lock.lock();
+    }
+}
+
+}// namespace nrws
@@ -0,0 +1,296 @@
+#pragma once
+
+#include "narrows/_internal/_arch.hpp"
+#include "narrows/concepts.hpp"
+#include "narrows/single_bounded.hpp"
+#include "narrows/wait.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <expected>
+#include <memory>
+#include <utility>
+
+namespace nrws {
+
+// Link a message type carries to be sent through a mailbox, by deriving from it:
+//
+//     struct request : nrws::mailbox_hook { ... };
+//
+// A message can be in one mailbox at a time, and may be sent again once it was received. Copying
+// a message doesn't copy its link, the copy starts out unlinked.
+struct mailbox_hook
+{
+    mailbox_hook() = default;
+    mailbox_hook(const mailbox_hook &) noexcept {}
+    mailbox_hook &operator=(const mailbox_hook &) noexcept { return *this; }
+    ~mailbox_hook() = default;
+
+    std::atomic<mailbox_hook *> _next{ nullptr };
+};
+
+// Intrusive multi producer/single consumer queue of messages that derive from mailbox_hook.
+//
+// This is Dmitry Vyukov's intrusive MPSC queue. The queue never allocates or copies, it only links
+// the messages it is given, so it doesn't own them either: a message must stay alive until it was
+// received. Producers link a message with a single exchange on head_. The consumer owns tail_ and
+// pops with plain loads and stores. The one exception is taking the last message, where it puts
+// the stub back in with an exchange so the queue never runs out of nodes.
+//
+// A producer that has exchanged head_ but not linked its message yet hides everything behind it
+// for a moment. pop() treats that as empty, and the producer's notify wakes the consumer once the
+// link is in place.
+template<typename T, typename Wait = park_wait>
+    requires std::derived_from<T, mailbox_hook>
+class _mailbox
+{
+  public:
+    _mailbox() = default;
+
+    _mailbox(const _mailbox &) = delete;
+    _mailbox &operator=(const _mailbox &) = delete;
+
+    // Any thread, false once the mailbox is closed
+    inline auto push(T &message) -> bool;
+
+    // Consumer only
+    [[nodiscard]] inline auto try_pop() noexcept -> T *;
+    [[nodiscard]] inline auto pop() -> T *;
+    template<typename Clock, typename Duration>
+    [[nodiscard]] inline auto pop_until(const std::chrono::time_point<Clock, Duration> &deadline) -> T *;
+    // true if try_pop() would return a message
+    [[nodiscard]] inline auto ready() const noexcept -> bool;
+    // true if no message is queued, or being linked
+    [[nodiscard]] inline auto empty() const noexcept -> bool
+    {
+        return tail_ == &stub_ && head_.load(std::memory_order_acquire) == &stub_;
+    }
+
+    inline auto close() -> void;
+    [[nodiscard]] inline auto closed() const noexcept -> bool { return closed_.load(std::memory_order_acquire); }
+
+  private:
+    inline auto _link(mailbox_hook &hook) noexcept -> void;
+    // after close, waits out producers that are still linking
+    [[nodiscard]] inline auto _drain() noexcept -> T *;
+
+    // producer side
+    alignas(_cache_line_size) std::atomic<mailbox_hook *> head_{ &stub_ };
+    alignas(_cache_line_size) std::atomic<bool> closed_{ false };
+
+    // consumer side
+    alignas(_cache_line_size) mailbox_hook *tail_{ &stub_ };
+    mailbox_hook stub_;
+
+    typename Wait::waiter_set not_empty_;
+};
+
+// Sending end of a mailbox, copies share it
+template<typename T, typename Wait = park_wait>
+class mailbox_sender
+{
+  public:
+    using value_type = T *;
+    using error_type = sender_error_t;
+    using result_type = std::expected<void, error_type>;
+    using channel_type = _mailbox<T, Wait>;
+
+    explicit mailbox_sender(std::shared_ptr<channel_type> mailbox) : mailbox_(std::move(mailbox)) {}
+
+    // Never blocks or allocates. On ChannelClosed the message was not linked and still belongs to
+    // the caller.
+    [[nodiscard]] inline auto send(T &message) -> result_type { return _send(message); }
+    [[nodiscard]] inline auto send(T *const &message) -> result_type { return _send(*message); }
+    [[nodiscard]] inline auto send(T *&&message) -> result_type { return _send(*message); }
+
+    inline auto close() { mailbox_->close(); }
+
+  private:
+    [[nodiscard]] inline auto _send(T &message) -> result_type
+    {
+        if (!mailbox_->push(message)) { return std::unexpected(sender_error_t::ChannelClosed); }
+        return result_type{};
+    }
+
+    std::shared_ptr<channel_type> mailbox_;
+};
+
+// Receiving end of a mailbox. There is only one consumer, so it can be moved but not copied.
+template<typename T, typename Wait = park_wait>
+class mailbox_receiver
+{
+  public:
+    using value_type = T *;
+    using error_type = receiver_error_t;
+    using result_type = std::expected<value_type, error_type>;
+    using channel_type = _mailbox<T, Wait>;
+
+    explicit mailbox_receiver(std::shared_ptr<channel_type> mailbox) : mailbox_(std::move(mailbox)) {}
+
+    mailbox_receiver(const mailbox_receiver &) = delete;
+    mailbox_receiver &operator=(const mailbox_receiver &) = delete;
+    mailbox_receiver(mailbox_receiver &&) noexcept = default;
+    mailbox_receiver &operator=(mailbox_receiver &&) noexcept = default;
+
+    // Returns ChannelClosed once the mailbox is closed and every message was received
+    [[nodiscard]] inline auto receive() -> result_type { return _to_result(mailbox_->pop()); }
+
+    // Never blocks, returns ChannelEmpty if there is no message right now
+    [[nodiscard]] inline auto try_receive() -> result_type { return _to_result(mailbox_->try_pop()); }
+
+    template<typename Clock, typename Duration>
+    [[nodiscard]] inline auto receive_until(const std::chrono::time_point<Clock, Duration> &deadline) -> result_type
+    {
+        return _to_result(mailbox_->pop_until(deadline), receiver_error_t::Timeout);
+    }
+    template<typename Rep, typename Period>
+    [[nodiscard]] inline auto receive_for(const std::chrono::duration<Rep, Period> &timeout) -> result_type
+    {
+        return receive_until(std::chrono::steady_clock::now() + timeout);
+    }
+
+    inline auto close() { mailbox_->close(); }
+
+  private:
+    [[nodiscard]] inline auto _to_result(T *message, receiver_error_t missing = receiver_error_t::ChannelEmpty)
+        -> result_type;
+
+    std::shared_ptr<channel_type> mailbox_;
+};
+
+// Creates an allocation free mailbox for messages that derive from mailbox_hook. Messages are sent
+// by reference and received as pointers, the mailbox never copies or owns them.
+//
+//     auto [s, r] = nrws::mailbox<request>();
+//     s.send(pooled_request);
+//     request *received = r.receive().value();
+template<typename T, typename Wait = park_wait>
+[[nodiscard]] auto mailbox() -> std::pair<mailbox_sender<T, Wait>, mailbox_receiver<T, Wait>>
+{
+    auto box = std::make_shared<_mailbox<T, Wait>>();
+    return { mailbox_sender<T, Wait>(box), mailbox_receiver<T, Wait>(box) };
+}
+
+/* Mailbox Implementations */
+
+template<typename T, typename Wait>
+    requires std::derived_from<T, mailbox_hook>
+inline auto _mailbox<T, Wait>::push(T &message) -> bool
+{
+    if (closed()) { return false; }
+
+    _link(message);
+    not_empty_.notify_one();
+    return true;
+}
+
+template<typename T, typename Wait>
+    requires std::derived_from<T, mailbox_hook>
+[[nodiscard]] inline auto _mailbox<T, Wait>::try_pop() noexcept -> T *
+{
+    auto *tail = tail_;
+    auto *next = tail->_next.load(std::memory_order_acquire);
+
+    // step over the stub
+    if (tail == &stub_) {
+        if (next == nullptr) { return nullptr; }
+        tail_ = next;
+        tail = next;
+        next = next->_next.load(std::memory_order_acquire);
+    }
+
+    if (next != nullptr) {
+        tail_ = next;
+        return static_cast<T *>(tail);
+    }
+
+    // tail may be the last message, or a producer is still linking the one after it
+    if (tail != head_.load(std::memory_order_acquire)) { return nullptr; }
+
+    // put the stub behind the last message so it can be taken
+    _link(stub_);
+    next = tail->_next.load(std::memory_order_acquire);
+    if (next != nullptr) {
+        tail_ = next;
+        return static_cast<T *>(tail);
+    }
+    return nullptr;
+}
+
+template<typename T, typename Wait>
+    requires std::derived_from<T, mailbox_hook>
+[[nodiscard]] inline auto _mailbox<T, Wait>::pop() -> T *
+{
+    while (true) {
+        if (auto *message = try_pop()) { return message; }
+        if (closed()) { return _drain(); }
+
+        not_empty_.wait([this]() { return ready() || closed(); });
+    }
+}
+
+template<typename T, typename Wait>
+    requires std::derived_from<T, mailbox_hook>
+template<typename Clock, typename Duration>
+[[nodiscard]] inline auto _mailbox<T, Wait>::pop_until(const std::chrono::time_point<Clock, Duration> &deadline) -> T *
+{
+    while (true) {
+        if (auto *message = try_pop()) { return message; }
+        if (closed()) { return _drain(); }
+
+        if (!not_empty_.wait_until([this]() { return ready() || closed(); }, deadline)) { return nullptr; }
+    }
+}
+
+template<typename T, typename Wait>
+    requires std::derived_from<T, mailbox_hook>
+[[nodiscard]] inline auto _mailbox<T, Wait>::ready() const noexcept -> bool
+{
+    const auto *tail = tail_;
+    const auto *next = tail->_next.load(std::memory_order_acquire);
+
+    if (tail == &stub_) { return next != nullptr; }
+    return next != nullptr || tail == head_.load(std::memory_order_acquire);
+}
+
+template<typename T, typename Wait>
+    requires std::derived_from<T, mailbox_hook>
+inline auto _mailbox<T, Wait>::close() -> void
+{
+    closed_.store(true, std::memory_order_seq_cst);
+    not_empty_.notify_all();
+}
+
+template<typename T, typename Wait>
+    requires std::derived_from<T, mailbox_hook>
+inline auto _mailbox<T, Wait>::_link(mailbox_hook &hook) noexcept -> void
+{
+    hook._next.store(nullptr, std::memory_order_relaxed);
+    auto *previous = head_.exchange(&hook, std::memory_order_acq_rel);
+    previous->_next.store(&hook, std::memory_order_release);
+}
+
+template<typename T, typename Wait>
+    requires std::derived_from<T, mailbox_hook>
+[[nodiscard]] inline auto _mailbox<T, Wait>::_drain() noexcept -> T *
+{
+    while (!empty()) {
+        if (auto *message = try_pop()) { return message; }
+        _cpu_relax();
+    }
+    return nullptr;
+}
+
+/* Mailbox Receiver Implementations */
+
+template<typename T, typename Wait>
+[[nodiscard]] inline auto mailbox_receiver<T, Wait>::_to_result(T *message, const receiver_error_t missing)
+    -> result_type
+{
+    if (message != nullptr) { return message; }
+    if (mailbox_->closed() && mailbox_->empty()) { return std::unexpected(receiver_error_t::ChannelClosed); }
+    return std::unexpected(missing);
+}
+
+}// namespace nrws
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "narrows/bounded.hpp"
+#include "narrows/broadcast.hpp"
+#include "narrows/concepts.hpp"
+#include "narrows/conversation.hpp"
+#include "narrows/executor.hpp"
+#include "narrows/mailbox.hpp"
+#include "narrows/oneshot.hpp"
+#include "narrows/page_allocator.hpp"
+#include "narrows/ready_fd.hpp"
+#include "narrows/records.hpp"
+#include "narrows/select.hpp"
+#include "narrows/shared_memory.hpp"
+#include "narrows/single_bounded.hpp"
+#include "narrows/unbounded.hpp"
+#include "narrows/wait.hpp"
+#include "narrows/worker_pool.hpp"
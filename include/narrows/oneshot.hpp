@@ -0,0 +1,324 @@
+#pragma once
+
+#include "narrows/concepts.hpp"
+#include "narrows/single_bounded.hpp"
+#include "narrows/wait.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace nrws {
+
+template<typename T, typename Wait>
+class oneshot_sender;
+template<typename T, typename Wait>
+class oneshot_receiver;
+
+// Shared by the two ends of a oneshot: raw storage for exactly one value, a state word and the
+// waiters, all in a single allocation.
+//
+// The state word doubles as the reference count. Each end sets its _gone bit as the very last
+// thing it does with the block, and whichever end sets the second one deletes it. The sender
+// publishes a value (or _closed when it is dropped unused) and notifies while it still holds its
+// reference, so the receiver can't free the block underneath a notify.
+template<typename T, typename Wait>
+class _oneshot_state
+{
+    friend oneshot_sender<T, Wait>;
+    friend oneshot_receiver<T, Wait>;
+
+    using value_type = std::decay_t<T>;
+
+    enum _bits : std::uint32_t {
+        _value = 1U << 0U,        // the value was constructed in storage_
+        _closed = 1U << 1U,       // the sender was dropped without sending
+        _taken = 1U << 2U,        // the receiver moved the value out and destroyed it
+        _sender_gone = 1U << 3U,  // the sender no longer touches the block
+        _receiver_gone = 1U << 4U,// the receiver no longer touches the block
+    };
+
+  public:
+    _oneshot_state() = default;
+
+  private:
+    ~_oneshot_state()
+    {
+        const auto state = state_.load(std::memory_order_relaxed);
+        if ((state & _value) != 0U && (state & _taken) == 0U) { std::destroy_at(_get()); }
+    }
+
+    [[nodiscard]] inline auto _get() noexcept -> value_type *
+    {
+        return std::launder(reinterpret_cast<value_type *>(storage_));
+    }
+
+    [[nodiscard]] inline auto _published() const noexcept -> bool
+    {
+        return (state_.load(std::memory_order_acquire) & (_value | _closed)) != 0U;
+    }
+
+    // sets gone for one end and deletes the block if the other end is already gone
+    static inline auto _release(_oneshot_state *state, const std::uint32_t gone, const std::uint32_t other) -> void
+    {
+        if ((state->state_.fetch_or(gone, std::memory_order_acq_rel) & other) != 0U) { delete state; }
+    }
+
+    alignas(value_type) std::byte storage_[sizeof(value_type)];
+    std::atomic<std::uint32_t> state_{ 0U };
+    typename Wait::waiter_set waiters_;
+};
+
+// Sending end of a oneshot, sends at most one value. Dropping it without sending closes the
+// oneshot, and the receiver gets ChannelClosed.
+template<typename T, typename Wait = park_wait>
+class oneshot_sender
+{
+  public:
+    using value_type = std::decay_t<T>;
+    using error_type = sender_error_t;
+    using result_type = std::expected<void, error_type>;
+
+    oneshot_sender() = default;
+    explicit oneshot_sender(_oneshot_state<T, Wait> *state) : state_(state) {}
+    ~oneshot_sender() { _close(); }
+
+    oneshot_sender(const oneshot_sender &) = delete;
+    oneshot_sender &operator=(const oneshot_sender &) = delete;
+    oneshot_sender(oneshot_sender &&other) noexcept : state_(std::exchange(other.state_, nullptr)) {}
+    oneshot_sender &operator=(oneshot_sender &&other) noexcept;
+
+    // Never blocks. Returns ChannelClosed if the receiver is gone or a value was already sent, in
+    // which case the value is dropped.
+    [[nodiscard]] inline auto send(const value_type &val) -> result_type { return _send(val); }
+    [[nodiscard]] inline auto send(value_type &&val) -> result_type { return _send(std::move(val)); }
+
+    // false once a value was sent or the receiver is gone
+    [[nodiscard]] inline auto is_open() const noexcept -> bool;
+
+  private:
+    using _state = _oneshot_state<T, Wait>;
+
+    template<typename V>
+    [[nodiscard]] inline auto _send(V &&val) -> result_type;
+    inline auto _close() -> void;
+
+    _state *state_{ nullptr };
+};
+static_assert(is_sender<oneshot_sender<int, park_wait>>, "Must satisfy the sender concept.");
+
+// Receiving end of a oneshot, receives at most one value
+template<typename T, typename Wait = park_wait>
+class oneshot_receiver
+{
+  public:
+    using value_type = std::decay_t<T>;
+    using error_type = receiver_error_t;
+    using result_type = std::expected<value_type, error_type>;
+
+    oneshot_receiver() = default;
+    explicit oneshot_receiver(_oneshot_state<T, Wait> *state) : state_(state) {}
+    ~oneshot_receiver() { _drop(); }
+
+    oneshot_receiver(const oneshot_receiver &) = delete;
+    oneshot_receiver &operator=(const oneshot_receiver &) = delete;
+    oneshot_receiver(oneshot_receiver &&other) noexcept : state_(std::exchange(other.state_, nullptr)) {}
+    oneshot_receiver &operator=(oneshot_receiver &&other) noexcept;
+
+    // Blocks until the value was sent, returns ChannelClosed if the sender was dropped without
+    // sending or the value was already received
+    [[nodiscard]] inline auto receive() -> result_type;
+
+    // Never blocks, returns ChannelEmpty if the value was not sent yet
+    [[nodiscard]] inline auto try_receive() -> result_type;
+
+    template<typename Clock, typename Duration>
+    [[nodiscard]] inline auto receive_until(const std::chrono::time_point<Clock, Duration> &deadline) -> result_type;
+    template<typename Rep, typename Period>
+    [[nodiscard]] inline auto receive_for(const std::chrono::duration<Rep, Period> &timeout) -> result_type;
+
+  private:
+    using _state = _oneshot_state<T, Wait>;
+
+    [[nodiscard]] inline auto _take() -> result_type;
+    inline auto _drop() -> void;
+
+    _state *state_{ nullptr };
+};
+static_assert(is_receiver<oneshot_receiver<int, park_wait>>, "Must satisfy the receiver concept");
+
+// Creates a channel for exactly one value. Both ends share a single allocation and synchronize with
+// a few atomic operations, so it is much cheaper than a bounded channel of capacity 1.
+template<typename T, typename Wait = park_wait>
+[[nodiscard]] auto oneshot() -> std::pair<oneshot_sender<T, Wait>, oneshot_receiver<T, Wait>>
+{
+    auto *state = new _oneshot_state<T, Wait>();
+    return { oneshot_sender<T, Wait>(state), oneshot_receiver<T, Wait>(state) };
+}
+
+// A request that carries the sender for its own reply. Send it over any channel, the serving side
+// answers through reply.
+//
+//     auto [s, r] = nrws::bounded<nrws::request<arp_packet, arp_reply>>(16);
+//
+//     // client
+//     auto reply = nrws::send_request(s, packet);
+//     auto answer = reply->receive();
+//
+//     // server
+//     auto req = r.receive();
+//     static_cast<void>(req->reply.send(handle(req->value)));
+template<typename Req, typename Resp, typename Wait = park_wait>
+struct request
+{
+    using request_type = Req;
+    using response_type = Resp;
+    using wait_type = Wait;
+
+    Req value;
+    oneshot_sender<Resp, Wait> reply;
+};
+
+// Sends value over sender together with a fresh reply sender, and returns the receiver for the
+// reply. If the request can't be sent, its error is returned instead.
+template<is_sender S>
+[[nodiscard]] auto send_request(S &sender, typename S::value_type::request_type value)
+    -> std::expected<oneshot_receiver<typename S::value_type::response_type, typename S::value_type::wait_type>,
+        typename S::error_type>
+{
+    using request_type = typename S::value_type;
+
+    auto [reply, receiver] = oneshot<typename request_type::response_type, typename request_type::wait_type>();
+    auto sent = sender.send(request_type{ std::move(value), std::move(reply) });
+    if (!sent.has_value()) { return std::unexpected(sent.error()); }
+    return std::move(receiver);
+}
+
+/* Oneshot Sender Implementations */
+
+template<typename T, typename Wait>
+inline auto oneshot_sender<T, Wait>::operator=(oneshot_sender &&other) noexcept -> oneshot_sender &
+{
+    if (this != &other) {
+        _close();
+        state_ = std::exchange(other.state_, nullptr);
+    }
+    return *this;
+}
+
+template<typename T, typename Wait>
+[[nodiscard]] inline auto oneshot_sender<T, Wait>::is_open() const noexcept -> bool
+{
+    return state_ != nullptr && (state_->state_.load(std::memory_order_acquire) & _state::_receiver_gone) == 0U;
+}
+
+template<typename T, typename Wait>
+template<typename V>
+[[nodiscard]] inline auto oneshot_sender<T, Wait>::_send(V &&val) -> result_type
+{
+    if (state_ == nullptr) { return std::unexpected(sender_error_t::ChannelClosed); }
+    auto *state = std::exchange(state_, nullptr);
+
+    // don't bother constructing a value nobody will receive
+    if ((state->state_.load(std::memory_order_acquire) & _state::_receiver_gone) != 0U) {
+        _state::_release(state, _state::_sender_gone, _state::_receiver_gone);
+        return std::unexpected(sender_error_t::ChannelClosed);
+    }
+
+    std::construct_at(state->_get(), std::forward<V>(val));
+    const auto previous = state->state_.fetch_or(_state::_value, std::memory_order_acq_rel);
+    if ((previous & _state::_receiver_gone) == 0U) { state->waiters_.notify_one(); }
+
+    _state::_release(state, _state::_sender_gone, _state::_receiver_gone);
+    if ((previous & _state::_receiver_gone) != 0U) { return std::unexpected(sender_error_t::ChannelClosed); }
+    return result_type{};
+}
+
+template<typename T, typename Wait>
+inline auto oneshot_sender<T, Wait>::_close() -> void
+{
+    if (state_ == nullptr) { return; }
+    auto *state = std::exchange(state_, nullptr);
+
+    state->state_.fetch_or(_state::_closed, std::memory_order_acq_rel);
+    state->waiters_.notify_one();
+    _state::_release(state, _state::_sender_gone, _state::_receiver_gone);
+}
+
+/* Oneshot Receiver Implementations */
+
+template<typename T, typename Wait>
+inline auto oneshot_receiver<T, Wait>::operator=(oneshot_receiver &&other) noexcept -> oneshot_receiver &
+{
+    if (this != &other) {
+        _drop();
+        state_ = std::exchange(other.state_, nullptr);
+    }
+    return *this;
+}
+
+template<typename T, typename Wait>
+[[nodiscard]] inline auto oneshot_receiver<T, Wait>::receive() -> result_type
+{
+    if (state_ == nullptr) { return std::unexpected(receiver_error_t::ChannelClosed); }
+
+    state_->waiters_.wait([state = state_]() { return state->_published(); });
+    return _take();
+}
+
+template<typename T, typename Wait>
+[[nodiscard]] inline auto oneshot_receiver<T, Wait>::try_receive() -> result_type
+{
+    if (state_ == nullptr) { return std::unexpected(receiver_error_t::ChannelClosed); }
+    if (!state_->_published()) { return std::unexpected(receiver_error_t::ChannelEmpty); }
+    return _take();
+}
+
+template<typename T, typename Wait>
+template<typename Clock, typename Duration>
+[[nodiscard]] inline auto oneshot_receiver<T, Wait>::receive_until(
+    const std::chrono::time_point<Clock, Duration> &deadline) -> result_type
+{
+    if (state_ == nullptr) { return std::unexpected(receiver_error_t::ChannelClosed); }
+
+    if (!state_->waiters_.wait_until([state = state_]() { return state->_published(); }, deadline)) {
+        return std::unexpected(receiver_error_t::Timeout);
+    }
+    return _take();
+}
+
+template<typename T, typename Wait>
+template<typename Rep, typename Period>
+[[nodiscard]] inline auto oneshot_receiver<T, Wait>::receive_for(const std::chrono::duration<Rep, Period> &timeout)
+    -> result_type
+{
+    return receive_until(std::chrono::steady_clock::now() + timeout);
+}
+
+template<typename T, typename Wait>
+[[nodiscard]] inline auto oneshot_receiver<T, Wait>::_take() -> result_type
+{
+    auto *state = std::exchange(state_, nullptr);
+    if ((state->state_.load(std::memory_order_acquire) & _state::_value) == 0U) {
+        _state::_release(state, _state::_receiver_gone, _state::_sender_gone);
+        return std::unexpected(receiver_error_t::ChannelClosed);
+    }
+
+    result_type received{ std::move(*state->_get()) };
+    std::destroy_at(state->_get());
+    _state::_release(state, _state::_taken | _state::_receiver_gone, _state::_sender_gone);
+    return received;
+}
+
+template<typename T, typename Wait>
+inline auto oneshot_receiver<T, Wait>::_drop() -> void
+{
+    if (state_ == nullptr) { return; }
+    _state::_release(std::exchange(state_, nullptr), _state::_receiver_gone, _state::_sender_gone);
+}
+
+}// namespace nrws
@@ -0,0 +1,220 @@
+#pragma once
+
+#include "narrows/bounded.hpp"
+#include "narrows/wait.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+#if defined(__linux__)
+#include <climits>
+
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace nrws {
+
+// Where and how a page_allocator places the memory of a channel
+struct page_options
+{
+    constexpr static int any_node = -1;
+    // the node of the thread that constructs the channel
+    constexpr static int local_node = -2;
+
+    // Back allocations of at least a huge page with huge pages. Reserved huge pages are tried
+    // first, then transparent huge pages, then the allocation makes do with regular pages.
+    bool huge_pages{ true };
+    // NUMA node to place the pages on, e.g. current_numa_node() on the consumer thread. If the
+    // node is out of memory or doesn't exist, the pages come from another node.
+    int node{ any_node };
+    // Fault every page in while allocating, so the first values sent don't pay for it
+    bool prefault{ true };
+
+    friend auto operator==(const page_options &, const page_options &) -> bool = default;
+};
+
+// The NUMA node the calling thread is running on, 0 if that can't be told
+[[nodiscard]] inline auto current_numa_node() noexcept -> int;
+
+// Allocator that maps the storage of a channel straight from the kernel, see page_options. Meant
+// for the rings of bounded backends, which make one large allocation up front:
+//
+//     nrws::page_options options{ .node = 1 };
+//     auto [s, r] = nrws::bounded<packet, nrws::paged::array_channel>(1 << 20, nrws::page_allocator<packet>(options));
+//
+// Allocations smaller than a page go to operator new, so a rebound copy used for small nodes
+// doesn't map a page per node. Without Linux every allocation goes to operator new.
+template<typename T>
+class page_allocator
+{
+  public:
+    using value_type = T;
+
+    page_allocator() noexcept = default;
+    explicit page_allocator(const page_options &options) noexcept : options_(options) {}
+    template<typename U>
+    explicit(false) page_allocator(const page_allocator<U> &other) noexcept : options_(other.options())
+    {}
+
+    // Throws std::bad_alloc if the memory can't be mapped
+    [[nodiscard]] inline auto allocate(std::size_t n) -> T *;
+    inline auto deallocate(T *ptr, std::size_t n) noexcept -> void;
+
+    [[nodiscard]] inline auto options() const noexcept -> const page_options & { return options_; }
+
+    // memory from one allocator can be freed by any other with the same options
+    template<typename U>
+    friend auto operator==(const page_allocator &lhs, const page_allocator<U> &rhs) noexcept -> bool
+    {
+        return lhs.options() == rhs.options();
+    }
+
+  private:
+    page_options options_{};
+};
+
+// Channels that take their storage from a page_allocator
+namespace paged {
+    template<typename T, typename Wait = park_wait>
+    using bounded_channel = nrws::bounded_channel<T, Wait, page_allocator<std::decay_t<T>>>;
+
+    template<typename T, typename Wait = park_wait>
+    using array_channel = nrws::array_channel<T, Wait, page_allocator<std::decay_t<T>>>;
+
+    template<typename T, typename Wait = park_wait>
+    using striped_channel = nrws::striped_channel<T, Wait, page_allocator<std::decay_t<T>>>;
+}// namespace paged
+
+// The mapping behind an allocation of bytes, the same for allocate and deallocate
+struct _pages
+{
+    // the size of the huge pages that are asked for, 2MiB on x86-64 and on aarch64 with 4KiB pages
+    constexpr static std::size_t huge_page_size = std::size_t{ 2U } << 20U;
+
+    std::size_t length;
+    bool huge;
+
+    [[nodiscard]] static inline auto page_size() noexcept -> std::size_t;
+    // nullopt-like length 0 for allocations that go to operator new
+    [[nodiscard]] static inline auto of(std::size_t bytes, const page_options &options) noexcept -> _pages;
+
+    [[nodiscard]] inline auto map(const page_options &options) const -> void *;
+    inline auto unmap(void *memory) const noexcept -> void;
+};
+
+/* Page Implementations */
+
+[[nodiscard]] inline auto current_numa_node() noexcept -> int
+{
+#if defined(__linux__)
+    unsigned cpu = 0U;
+    unsigned node = 0U;
+    if (::syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) { return static_cast<int>(node); }
+#endif
+    return 0;
+}
+
+[[nodiscard]] inline auto _pages::page_size() noexcept -> std::size_t
+{
+#if defined(__linux__)
+    static const auto size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    return size;
+#else
+    return 0U;
+#endif
+}
+
+[[nodiscard]] inline auto _pages::of(const std::size_t bytes, const page_options &options) noexcept -> _pages
+{
+    const auto page = page_size();
+    if (page == 0U || bytes < page) { return { 0U, false }; }
+
+    const auto huge = options.huge_pages && bytes >= huge_page_size;
+    const auto unit = huge ? huge_page_size : page;
+    return { (bytes + unit - 1U) / unit * unit, huge };
+}
+
+[[nodiscard]] inline auto _pages::map([[maybe_unused]] const page_options &options) const -> void *
+{
+#if defined(__linux__)
+    constexpr auto protection = PROT_READ | PROT_WRITE;
+    constexpr auto flags = MAP_PRIVATE | MAP_ANONYMOUS;
+
+    void *memory = MAP_FAILED;
+    if (huge) {
+        // only works if the administrator reserved huge pages
+        memory = ::mmap(nullptr, length, protection, flags | MAP_HUGETLB, -1, 0);
+
+        if (memory == MAP_FAILED) {
+            // transparent huge pages need the range aligned to a huge page, so map one more and
+            // trim the ends
+            auto *raw = static_cast<std::byte *>(::mmap(nullptr, length + huge_page_size, protection, flags, -1, 0));
+            if (raw == MAP_FAILED) { throw std::bad_alloc(); }
+
+            const auto address = reinterpret_cast<std::uintptr_t>(raw);
+            const auto lead = (huge_page_size - address % huge_page_size) % huge_page_size;
+            if (lead != 0U) { ::munmap(raw, lead); }
+            ::munmap(raw + lead + length, huge_page_size - lead);
+
+            memory = raw + lead;
+            ::madvise(memory, length, MADV_HUGEPAGE);
+        }
+    } else {
+        memory = ::mmap(nullptr, length, protection, flags, -1, 0);
+    }
+    if (memory == MAP_FAILED) { throw std::bad_alloc(); }
+
+    // a preference rather than a binding, so a node that is full or gone means remote memory
+    // instead of a failed allocation. Kernels without NUMA refuse it, which is fine as well.
+    const auto node = options.node == page_options::local_node ? current_numa_node() : options.node;
+    if (node >= 0 && node < static_cast<int>(sizeof(unsigned long) * CHAR_BIT)) {
+        const auto mask = 1UL << static_cast<unsigned>(node);
+        ::syscall(SYS_mbind, memory, length, MPOL_PREFERRED, &mask, sizeof(mask) * CHAR_BIT + 1U, 0U);
+    }
+
+    // after mbind, so every page is faulted in on the node it was placed on
+    if (options.prefault) {
+        auto *bytes = static_cast<volatile std::byte *>(memory);
+        for (std::size_t offset = 0U; offset < length; offset += page_size()) { bytes[offset] = std::byte{ 0U }; }
+    }
+
+    return memory;
+#else
+    throw std::bad_alloc();
+#endif
+}
+
+inline auto _pages::unmap([[maybe_unused]] void *memory) const noexcept -> void
+{
+#if defined(__linux__)
+    ::munmap(memory, length);
+#endif
+}
+
+/* Page Allocator Implementations */
+
+template<typename T>
+[[nodiscard]] inline auto page_allocator<T>::allocate(const std::size_t n) -> T *
+{
+    const auto pages = _pages::of(n * sizeof(T), options_);
+    if (pages.length == 0U) { return std::allocator<T>{}.allocate(n); }
+    return static_cast<T *>(pages.map(options_));
+}
+
+template<typename T>
+inline auto page_allocator<T>::deallocate(T *ptr, const std::size_t n) noexcept -> void
+{
+    const auto pages = _pages::of(n * sizeof(T), options_);
+    if (pages.length == 0U) {
+        std::allocator<T>{}.deallocate(ptr, n);
+    } else {
+        pages.unmap(ptr);
+    }
+}
+
+}// namespace nrws
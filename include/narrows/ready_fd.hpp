@@ -0,0 +1,112 @@
+#pragma once
+
+#if defined(__linux__)
+
+#include "narrows/_internal/_select.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <system_error>
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace nrws {
+
+// Pollable readiness handle for a Receiver, Linux only.
+//
+// fd() is an eventfd that becomes readable once the channel has a value or is closed, so a thread
+// that sits in epoll_wait can multiplex sockets and channels in one loop. Signaling is edge
+// coalesced: only the first change after a reset() writes to the eventfd, a burst of sends costs
+// a single write and the receiving side a single wakeup.
+//
+// Once fd() is readable, call reset() and then drain the receiver with try_receive() until it
+// returns ChannelEmpty. Anything sent after reset() makes fd() readable again.
+//
+//     nrws::ready_fd ready(receiver);
+//     epoll_ctl(epoll, EPOLL_CTL_ADD, ready.fd(), &event);
+//     ...
+//     ready.reset();
+//     while (auto value = receiver.try_receive()) { ... }
+//
+// The handle watches the channel for as long as it lives, and the Receiver must outlive it.
+template<typename R>
+class ready_fd
+{
+  public:
+    // Throws std::system_error if the eventfd can't be created
+    explicit ready_fd(R &receiver);
+    ~ready_fd();
+
+    ready_fd(const ready_fd &) = delete;
+    ready_fd &operator=(const ready_fd &) = delete;
+
+    [[nodiscard]] inline auto fd() const noexcept -> int { return fd_; }
+
+    // Clears the readiness, must be called before draining the receiver
+    inline auto reset() noexcept -> void;
+
+  private:
+    static inline auto _wake(void *context) noexcept -> bool;
+    inline auto _signal() noexcept -> void;
+
+    R *receiver_;
+    int fd_;
+    std::atomic<bool> signaled_{ false };
+    _observer_list::node node_;
+};
+
+template<typename R>
+ready_fd<R>::ready_fd(R &receiver) : receiver_(&receiver), fd_(::eventfd(0U, EFD_CLOEXEC | EFD_NONBLOCK))
+{
+    if (fd_ < 0) { throw std::system_error(errno, std::system_category(), "eventfd"); }
+
+    node_.wake = &_wake;
+    node_.context = this;
+    receiver_->_watch(node_);
+
+    // anything that was sent before we started watching
+    if (receiver_->_ready()) { _signal(); }
+}
+
+template<typename R>
+ready_fd<R>::~ready_fd()
+{
+    receiver_->_unwatch(node_);
+    ::close(fd_);
+}
+
+template<typename R>
+inline auto ready_fd<R>::reset() noexcept -> void
+{
+    std::uint64_t count = 0U;
+    static_cast<void>(::read(fd_, &count, sizeof(count)));
+
+    // ordered before the receiver is drained, anything sent after that signals again
+    signaled_.store(false, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+template<typename R>
+inline auto ready_fd<R>::_wake(void *context) noexcept -> bool
+{
+    auto *self = static_cast<ready_fd *>(context);
+    if (!self->signaled_.load(std::memory_order_relaxed) && self->receiver_->_ready()) { self->_signal(); }
+
+    // the event loop behind the fd may not take the value, so coroutines are woken as well
+    return false;
+}
+
+template<typename R>
+inline auto ready_fd<R>::_signal() noexcept -> void
+{
+    if (signaled_.exchange(true, std::memory_order_acq_rel)) { return; }
+
+    const std::uint64_t one = 1U;
+    static_cast<void>(::write(fd_, &one, sizeof(one)));
+}
+
+}// namespace nrws
+
+#endif
@@ -0,0 +1,655 @@
+#pragma once
+
+#include "narrows/_internal/_arch.hpp"
+#include "narrows/concepts.hpp"
+#include "narrows/single_bounded.hpp"
+#include "narrows/wait.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <memory>
+#include <new>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace nrws {
+
+// Multi producer/single consumer channel of variable length byte records in one contiguous ring.
+//
+// This is the many-to-one ring buffer of Agrona, the log buffer layout of Aeron and LMAX. Every
+// record starts with an 8 byte header, the size it takes up in the ring and the length of its
+// payload, and records are aligned to 8 bytes. A producer claims header and payload with a single
+// CAS on tail_, writes the payload in place and commits by storing the size with release. Until
+// then the header reads 0 and the consumer waits for it. A record that doesn't fit before the end
+// of the ring is preceded by a padding record filling up that end, and starts at the front.
+//
+// The consumer zeroes every record it read before handing its bytes back to the producers, so a
+// header that hasn't been committed yet always reads 0. A record is at most half the ring, so a
+// record and the padding in front of it always fit once the consumer caught up.
+template<typename Wait = park_wait>
+class _record_ring
+{
+  public:
+    using size_type = std::size_t;
+
+    class _write_guard;
+    class _read_guard;
+
+    // The capacity in bytes is rounded up to a power of two
+    explicit _record_ring(size_type capacity);
+
+    _record_ring(const _record_ring &) = delete;
+    _record_ring &operator=(const _record_ring &) = delete;
+
+    // Any thread. Claims room for a payload of length bytes, which must be at most max_record().
+    // reserve() returns nullopt once the ring is closed, the others closed, full or timeout.
+    [[nodiscard]] inline auto reserve(size_type length) -> std::optional<_write_guard>;
+    [[nodiscard]] inline auto try_reserve(size_type length) -> std::expected<_write_guard, channel_status>;
+    template<typename Clock, typename Duration>
+    [[nodiscard]] inline auto reserve_until(size_type length, const std::chrono::time_point<Clock, Duration> &deadline)
+        -> std::expected<_write_guard, channel_status>;
+
+    // Consumer only, and the record handed out must be released before the next one is read.
+    // pop_ref() returns nullopt once the ring is closed and drained, the others closed, empty or
+    // timeout.
+    [[nodiscard]] inline auto pop_ref() -> std::optional<_read_guard>;
+    [[nodiscard]] inline auto try_pop_ref() -> std::expected<_read_guard, channel_status>;
+    template<typename Clock, typename Duration>
+    [[nodiscard]] inline auto pop_ref_until(const std::chrono::time_point<Clock, Duration> &deadline)
+        -> std::expected<_read_guard, channel_status>;
+
+    // Consumer only. Waits for at least one record, then calls read(std::span<const std::byte>)
+    // for up to max records and frees all of them at once. Returns the number read, 0 once the
+    // ring is closed and drained.
+    template<typename F>
+    [[nodiscard]] inline auto pop_many(F &&read, size_type max) -> size_type;
+
+    // Ring status
+    [[nodiscard]] inline auto empty() const noexcept -> bool
+    {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+    [[nodiscard]] inline auto capacity() const noexcept -> size_type { return buffer_.size(); }
+    [[nodiscard]] inline auto max_record() const noexcept -> size_type { return capacity() / 2U - _header_size; }
+
+    inline auto close() -> void;
+    [[nodiscard]] inline auto closed() const noexcept -> bool { return closed_.load(std::memory_order_acquire); }
+
+    // Handed out by reserve(), the record is only visible to the consumer once committed
+    class _write_guard
+    {
+      public:
+        _write_guard(_record_ring *ring, std::byte *record, const size_type length)
+            : ring_(ring), record_(record), length_(length)
+        {}
+        _write_guard(_write_guard &&other) noexcept
+            : ring_(std::exchange(other.ring_, nullptr)), record_(other.record_), length_(other.length_)
+        {}
+        ~_write_guard() { commit(); }
+
+        _write_guard(const _write_guard &) = delete;
+        _write_guard &operator=(const _write_guard &) = delete;
+        _write_guard &operator=(_write_guard &&) = delete;
+
+        // the payload to be written, as long as was reserved
+        [[nodiscard]] auto bytes() const noexcept -> std::span<std::byte>
+        {
+            return { record_ + _header_size, length_ };
+        }
+
+        // Sends the record, commit(length) sends only the first length bytes of the payload
+        inline auto commit() -> void { commit(length_); }
+        inline auto commit(size_type length) -> void;
+
+      private:
+        _record_ring *ring_;
+        std::byte *record_;
+        size_type length_;
+    };
+
+    // Handed out by pop_ref(), the record is freed on release
+    class _read_guard
+    {
+      public:
+        explicit _read_guard(_record_ring *ring, std::byte *record) : ring_(ring), record_(record) {}
+        _read_guard(_read_guard &&other) noexcept
+            : ring_(std::exchange(other.ring_, nullptr)), record_(other.record_)
+        {}
+        ~_read_guard() { release(); }
+
+        _read_guard(const _read_guard &) = delete;
+        _read_guard &operator=(const _read_guard &) = delete;
+        _read_guard &operator=(_read_guard &&) = delete;
+
+        [[nodiscard]] auto bytes() const noexcept -> std::span<const std::byte>
+        {
+            return { record_ + _header_size, _length(record_) };
+        }
+
+        inline auto release() -> void;
+
+      private:
+        _record_ring *ring_;
+        std::byte *record_;
+    };
+
+  private:
+    constexpr static size_type _header_size = 8U;
+    constexpr static size_type _min_capacity = 64U;
+    // sizes are kept in 32 bits
+    constexpr static size_type _max_capacity = size_type{ 1U } << 30U;
+    // the length of a padding record
+    constexpr static std::uint32_t _padding = UINT32_MAX;
+
+    static_assert(__STDCPP_DEFAULT_NEW_ALIGNMENT__ >= _header_size, "Records must be aligned to their header");
+
+    [[nodiscard]] constexpr static auto _aligned(const size_type length) noexcept -> size_type
+    {
+        return (_header_size + length + _header_size - 1U) & ~(_header_size - 1U);
+    }
+
+    // the header of a record, its size is the only part the other side reads before it is
+    // published
+    [[nodiscard]] static inline auto _size(std::byte *record) noexcept -> std::atomic_ref<std::int32_t>
+    {
+        return std::atomic_ref<std::int32_t>(*std::launder(reinterpret_cast<std::int32_t *>(record)));
+    }
+    [[nodiscard]] static inline auto _length(const std::byte *record) noexcept -> std::uint32_t
+    {
+        std::uint32_t length = 0U;
+        std::memcpy(&length, record + sizeof(std::int32_t), sizeof(length));
+        return length;
+    }
+    static inline auto _publish(std::byte *record, size_type size, std::uint32_t length) noexcept -> void;
+
+    [[nodiscard]] inline auto _at(const size_type position) noexcept -> std::byte *
+    {
+        return buffer_.data() + (position & mask_);
+    }
+
+    // the padding a record of size bytes claimed at tail needs in front of it, 0 if it fits before
+    // the end of the ring
+    [[nodiscard]] inline auto _padding_for(size_type tail, size_type size) const noexcept -> size_type;
+    [[nodiscard]] inline auto _fits(size_type length) const noexcept -> bool;
+    [[nodiscard]] inline auto _try_claim(size_type length) -> std::byte *;
+
+    // the next committed record at position, stepping over padding. nullptr if there is none yet.
+    [[nodiscard]] inline auto _next(size_type &position) noexcept -> std::byte *;
+    [[nodiscard]] inline auto _ready() noexcept -> bool;
+    [[nodiscard]] inline auto _try_acquire() -> std::optional<_read_guard>;
+    inline auto _free(std::byte *record) -> void;
+
+    // read only after construction
+    std::vector<std::byte> buffer_;
+    size_type mask_;
+
+    // producer side
+    alignas(_cache_line_size) std::atomic<size_type> tail_{ 0U };
+
+    // consumer side
+    alignas(_cache_line_size) std::atomic<size_type> head_{ 0U };
+
+    // rarely written, read by both sides
+    alignas(_cache_line_size) std::atomic<bool> closed_{ false };
+    typename Wait::waiter_set not_full_;
+    typename Wait::waiter_set not_empty_;
+};
+
+// Sending end of a record channel, copies share it
+template<typename Wait = park_wait>
+class record_sender
+{
+  public:
+    using value_type = std::span<const std::byte>;
+    using error_type = sender_error_t;
+    using result_type = std::expected<void, error_type>;
+    using channel_type = _record_ring<Wait>;
+    using slot_type = typename channel_type::_write_guard;
+
+    explicit record_sender(std::shared_ptr<channel_type> ring) : ring_(std::move(ring)) {}
+
+    // Copies the record into the ring, waiting for room
+    [[nodiscard]] inline auto send(const value_type &record) -> result_type;
+    // Never blocks, returns ChannelFull if there is no room right now
+    [[nodiscard]] inline auto try_send(const value_type &record) -> result_type;
+
+    // Claims room for a payload of length bytes to be written in place, it is sent on
+    // slot.commit() or when the slot is destroyed. Every overload returns TooLarge if length is
+    // more than max_record().
+    [[nodiscard]] inline auto reserve(std::size_t length) -> std::expected<slot_type, error_type>;
+    [[nodiscard]] inline auto try_reserve(std::size_t length) -> std::expected<slot_type, error_type>;
+    template<typename Rep, typename Period>
+    [[nodiscard]] inline auto reserve_for(std::size_t length, const std::chrono::duration<Rep, Period> &timeout)
+        -> std::expected<slot_type, error_type>;
+
+    [[nodiscard]] inline auto max_record() const noexcept -> std::size_t { return ring_->max_record(); }
+    inline auto close() { ring_->close(); }
+
+  private:
+    [[nodiscard]] static inline auto _to_result(std::expected<slot_type, channel_status> &&slot)
+        -> std::expected<slot_type, error_type>;
+
+    std::shared_ptr<channel_type> ring_;
+};
+static_assert(is_sender<record_sender<>>, "Must satisfy the sender concept.");
+
+// Receiving end of a record channel. There is only one consumer, so it can be moved but not
+// copied, and a record must be released before the next one is received.
+template<typename Wait = park_wait>
+class record_receiver
+{
+  public:
+    using error_type = receiver_error_t;
+    using channel_type = _record_ring<Wait>;
+    using ref_type = typename channel_type::_read_guard;
+    using result_type = std::expected<ref_type, error_type>;
+    using batch_result_type = std::expected<std::size_t, error_type>;
+
+    explicit record_receiver(std::shared_ptr<channel_type> ring) : ring_(std::move(ring)) {}
+
+    record_receiver(const record_receiver &) = delete;
+    record_receiver &operator=(const record_receiver &) = delete;
+    record_receiver(record_receiver &&) noexcept = default;
+    record_receiver &operator=(record_receiver &&) noexcept = default;
+
+    // Hands out the next record in place, ref.bytes() is its payload. Returns ChannelClosed once
+    // the channel is closed and every record was received.
+    [[nodiscard]] inline auto receive() -> result_type;
+
+    // Never blocks, returns ChannelEmpty if no record is ready right now
+    [[nodiscard]] inline auto try_receive() -> result_type;
+
+    template<typename Clock, typename Duration>
+    [[nodiscard]] inline auto receive_until(const std::chrono::time_point<Clock, Duration> &deadline) -> result_type;
+    template<typename Rep, typename Period>
+    [[nodiscard]] inline auto receive_for(const std::chrono::duration<Rep, Period> &timeout) -> result_type
+    {
+        return receive_until(std::chrono::steady_clock::now() + timeout);
+    }
+
+    // Waits for at least one record, then calls read(std::span<const std::byte>) on up to max of
+    // the records that are ready and frees them together. Returns the number read, or
+    // ChannelClosed once the channel is closed and drained.
+    template<typename F>
+    [[nodiscard]] inline auto receive_many(F &&read, std::size_t max) -> batch_result_type;
+
+    inline auto close() { ring_->close(); }
+
+  private:
+    std::shared_ptr<channel_type> ring_;
+};
+
+// Creates a channel of variable length byte records in a ring of capacity bytes. Producers write
+// each record in place and the consumer reads it in place, so nothing is allocated per record.
+//
+//     auto [s, r] = nrws::records(64 * 1024);
+//
+//     auto slot = s.reserve(1500).value();
+//     const auto length = ::recv(socket, slot.bytes().data(), slot.bytes().size(), 0);
+//     slot.commit(length);
+//
+//     auto record = r.receive().value();
+//     parse(record.bytes());
+template<typename Wait = park_wait>
+[[nodiscard]] auto records(const std::size_t capacity) -> std::pair<record_sender<Wait>, record_receiver<Wait>>
+{
+    auto ring = std::make_shared<_record_ring<Wait>>(capacity);
+    return { record_sender<Wait>(ring), record_receiver<Wait>(ring) };
+}
+
+/* Record Ring Implementations */
+
+template<typename Wait>
+_record_ring<Wait>::_record_ring(const size_type capacity)
+    : buffer_(_next_power_of_two(std::clamp(capacity, _min_capacity, _max_capacity))), mask_(buffer_.size() - 1U)
+{}
+
+template<typename Wait>
+inline auto _record_ring<Wait>::_publish(std::byte *record, const size_type size, const std::uint32_t length) noexcept
+    -> void
+{
+    std::memcpy(record + sizeof(std::int32_t), &length, sizeof(length));
+    _size(record).store(static_cast<std::int32_t>(size), std::memory_order_release);
+}
+
+template<typename Wait>
+[[nodiscard]] inline auto _record_ring<Wait>::_padding_for(const size_type tail, const size_type size) const noexcept
+    -> size_type
+{
+    const auto to_end = capacity() - (tail & mask_);
+    return size > to_end ? to_end : 0U;
+}
+
+template<typename Wait>
+[[nodiscard]] inline auto _record_ring<Wait>::_fits(const size_type length) const noexcept -> bool
+{
+    const auto size = _aligned(length);
+    const auto head = head_.load(std::memory_order_acquire);
+    const auto tail = tail_.load(std::memory_order_acquire);
+    return tail + _padding_for(tail, size) + size - head <= capacity();
+}
+
+template<typename Wait>
+[[nodiscard]] inline auto _record_ring<Wait>::_try_claim(const size_type length) -> std::byte *
+{
+    const auto size = _aligned(length);
+    auto tail = tail_.load(std::memory_order_relaxed);
+
+    while (true) {
+        // the consumer zeroed everything before head, so the claimed bytes are ours to write
+        const auto head = head_.load(std::memory_order_acquire);
+        const auto padding = _padding_for(tail, size);
+        if (tail + padding + size - head > capacity()) { return nullptr; }
+
+        if (tail_.compare_exchange_weak(tail, tail + padding + size, std::memory_order_relaxed)) {
+            if (padding != 0U) { _publish(_at(tail), padding, _padding); }
+            return _at(tail + padding);
+        }
+    }
+}
+
+template<typename Wait>
+[[nodiscard]] inline auto _record_ring<Wait>::reserve(const size_type length) -> std::optional<_write_guard>
+{
+    while (!closed()) {
+        if (auto *record = _try_claim(length)) {
+            return std::optional<_write_guard>{ std::in_place, this, record, length };
+        }
+
+        not_full_.wait([this, length]() { return _fits(length) || closed(); });
+    }
+
+    return std::nullopt;
+}
+
+template<typename Wait>
+[[nodiscard]] inline auto _record_ring<Wait>::try_reserve(const size_type length)
+    -> std::expected<_write_guard, channel_status>
+{
+    if (closed()) { return std::unexpected(channel_status::closed); }
+
+    auto *record = _try_claim(length);
+    if (record == nullptr) { return std::unexpected(channel_status::full); }
+    return std::expected<_write_guard, channel_status>{ std::in_place, this, record, length };
+}
+
+template<typename Wait>
+template<typename Clock, typename Duration>
+[[nodiscard]] inline auto _record_ring<Wait>::reserve_until(
+    const size_type length, const std::chrono::time_point<Clock, Duration> &deadline)
+    -> std::expected<_write_guard, channel_status>
+{
+    while (!closed()) {
+        if (auto *record = _try_claim(length)) {
+            return std::expected<_write_guard, channel_status>{ std::in_place, this, record, length };
+        }
+
+        if (!not_full_.wait_until([this, length]() { return _fits(length) || closed(); }, deadline)) {
+            return std::unexpected(channel_status::timeout);
+        }
+    }
+
+    return std::unexpected(channel_status::closed);
+}
+
+template<typename Wait>
+inline auto _record_ring<Wait>::_write_guard::commit(const size_type length) -> void
+{
+    if (ring_ == nullptr) { return; }
+
+    // the record keeps the size it was reserved with, only the payload gets shorter
+    _publish(record_, _aligned(length_), static_cast<std::uint32_t>(std::min(length, length_)));
+    ring_->not_empty_.notify_one();
+    ring_ = nullptr;
+}
+
+template<typename Wait>
+[[nodiscard]] inline auto _record_ring<Wait>::_next(size_type &position) noexcept -> std::byte *
+{
+    while (true) {
+        auto *record = _at(position);
+        const auto size = _size(record).load(std::memory_order_acquire);
+        if (size <= 0) { return nullptr; }
+        if (_length(record) != _padding) { return record; }
+
+        // only the header of a padding record was ever written
+        std::memset(record, 0, _header_size);
+        position += static_cast<size_type>(size);
+    }
+}
+
+template<typename Wait>
+[[nodiscard]] inline auto _record_ring<Wait>::_ready() noexcept -> bool
+{
+    return _size(_at(head_.load(std::memory_order_relaxed))).load(std::memory_order_acquire) > 0;
+}
+
+template<typename Wait>
+[[nodiscard]] inline auto _record_ring<Wait>::_try_acquire() -> std::optional<_read_guard>
+{
+    const auto head = head_.load(std::memory_order_relaxed);
+    auto position = head;
+    auto *record = _next(position);
+
+    // hand the padding that was stepped over back to the producers
+    if (position != head) {
+        head_.store(position, std::memory_order_release);
+        not_full_.notify_all();
+    }
+
+    if (record == nullptr) { return std::nullopt; }
+    return std::optional<_read_guard>{ std::in_place, this, record };
+}
+
+template<typename Wait>
+inline auto _record_ring<Wait>::_free(std::byte *record) -> void
+{
+    const auto size = static_cast<size_type>(_size(record).load(std::memory_order_relaxed));
+    std::memset(record, 0, size);
+    head_.store(head_.load(std::memory_order_relaxed) + size, std::memory_order_release);
+
+    // one freed record may be enough for one producer but not another, wake them all
+    not_full_.notify_all();
+}
+
+template<typename Wait>
+inline auto _record_ring<Wait>::_read_guard::release() -> void
+{
+    if (ring_ == nullptr) { return; }
+
+    ring_->_free(record_);
+    ring_ = nullptr;
+}
+
+template<typename Wait>
+[[nodiscard]] inline auto _record_ring<Wait>::pop_ref() -> std::optional<_read_guard>
+{
+    while (true) {
+        if (auto record = _try_acquire()) { return record; }
+
+        // a producer that reserved before the close still commits, so wait until it did
+        if (closed() && empty()) { return std::nullopt; }
+
+        not_empty_.wait([this]() { return _ready() || closed(); });
+    }
+}
+
+template<typename Wait>
+[[nodiscard]] inline auto _record_ring<Wait>::try_pop_ref() -> std::expected<_read_guard, channel_status>
+{
+    if (auto record = _try_acquire()) { return std::expected<_read_guard, channel_status>{ std::move(*record) }; }
+
+    if (closed() && empty()) { return std::unexpected(channel_status::closed); }
+    return std::unexpected(channel_status::empty);
+}
+
+template<typename Wait>
+template<typename Clock, typename Duration>
+[[nodiscard]] inline auto _record_ring<Wait>::pop_ref_until(const std::chrono::time_point<Clock, Duration> &deadline)
+    -> std::expected<_read_guard, channel_status>
+{
+    while (true) {
+        if (auto record = _try_acquire()) { return std::expected<_read_guard, channel_status>{ std::move(*record) }; }
+
+        if (closed() && empty()) { return std::unexpected(channel_status::closed); }
+
+        if (!not_empty_.wait_until([this]() { return _ready() || closed(); }, deadline)) {
+            return std::unexpected(channel_status::timeout);
+        }
+    }
+}
+
+template<typename Wait>
+template<typename F>
+[[nodiscard]] inline auto _record_ring<Wait>::pop_many(F &&read, const size_type max) -> size_type
+{
+    if (max == 0U) { return 0U; }
+
+    while (true) {
+        const auto head = head_.load(std::memory_order_relaxed);
+        auto position = head;
+        size_type count = 0U;
+
+        while (count < max) {
+            auto *record = _next(position);
+            if (record == nullptr) { break; }
+
+            const auto size = static_cast<size_type>(_size(record).load(std::memory_order_relaxed));
+            read(std::span<const std::byte>{ record + _header_size, _length(record) });
+            std::memset(record, 0, size);
+            position += size;
+            count++;
+        }
+
+        // every record read is handed back with a single store
+        if (position != head) {
+            head_.store(position, std::memory_order_release);
+            not_full_.notify_all();
+        }
+        if (count != 0U) { return count; }
+
+        if (closed() && empty()) { return 0U; }
+        not_empty_.wait([this]() { return _ready() || closed(); });
+    }
+}
+
+template<typename Wait>
+inline auto _record_ring<Wait>::close() -> void
+{
+    closed_.store(true, std::memory_order_seq_cst);
+    not_full_.notify_all();
+    not_empty_.notify_all();
+}
+
+/* Record Sender Implementations */
+
+template<typename Wait>
+[[nodiscard]] inline auto record_sender<Wait>::send(const value_type &record) -> result_type
+{
+    auto slot = reserve(record.size());
+    if (!slot.has_value()) { return std::unexpected(slot.error()); }
+
+    std::ranges::copy(record, slot->bytes().begin());
+    return result_type{};
+}
+
+template<typename Wait>
+[[nodiscard]] inline auto record_sender<Wait>::try_send(const value_type &record) -> result_type
+{
+    auto slot = try_reserve(record.size());
+    if (!slot.has_value()) { return std::unexpected(slot.error()); }
+
+    std::ranges::copy(record, slot->bytes().begin());
+    return result_type{};
+}
+
+template<typename Wait>
+[[nodiscard]] inline auto record_sender<Wait>::reserve(const std::size_t length) -> std::expected<slot_type, error_type>
+{
+    if (length > max_record()) { return std::unexpected(sender_error_t::TooLarge); }
+
+    auto slot = ring_->reserve(length);
+    if (!slot.has_value()) { return std::unexpected(sender_error_t::ChannelClosed); }
+    return std::expected<slot_type, error_type>{ std::in_place, std::move(*slot) };
+}
+
+template<typename Wait>
+[[nodiscard]] inline auto record_sender<Wait>::try_reserve(const std::size_t length)
+    -> std::expected<slot_type, error_type>
+{
+    if (length > max_record()) { return std::unexpected(sender_error_t::TooLarge); }
+    return _to_result(ring_->try_reserve(length));
+}
+
+template<typename Wait>
+template<typename Rep, typename Period>
+[[nodiscard]] inline auto record_sender<Wait>::reserve_for(
+    const std::size_t length, const std::chrono::duration<Rep, Period> &timeout) -> std::expected<slot_type, error_type>
+{
+    if (length > max_record()) { return std::unexpected(sender_error_t::TooLarge); }
+    return _to_result(ring_->reserve_until(length, std::chrono::steady_clock::now() + timeout));
+}
+
+template<typename Wait>
+[[nodiscard]] inline auto record_sender<Wait>::_to_result(std::expected<slot_type, channel_status> &&slot)
+    -> std::expected<slot_type, error_type>
+{
+    if (slot.has_value()) { return std::expected<slot_type, error_type>{ std::in_place, std::move(*slot) }; }
+
+    switch (slot.error()) {
+    case channel_status::full:
+        return std::unexpected(sender_error_t::ChannelFull);
+    case channel_status::timeout:
+        return std::unexpected(sender_error_t::Timeout);
+    default:
+        return std::unexpected(sender_error_t::ChannelClosed);
+    }
+}
+
+/* Record Receiver Implementations */
+
+template<typename Wait>
+[[nodiscard]] inline auto record_receiver<Wait>::receive() -> result_type
+{
+    auto record = ring_->pop_ref();
+    if (!record.has_value()) { return std::unexpected(receiver_error_t::ChannelClosed); }
+    return result_type{ std::in_place, std::move(*record) };
+}
+
+template<typename Wait>
+[[nodiscard]] inline auto record_receiver<Wait>::try_receive() -> result_type
+{
+    auto record = ring_->try_pop_ref();
+    if (record.has_value()) { return result_type{ std::in_place, std::move(*record) }; }
+    if (record.error() == channel_status::closed) { return std::unexpected(receiver_error_t::ChannelClosed); }
+    return std::unexpected(receiver_error_t::ChannelEmpty);
+}
+
+template<typename Wait>
+template<typename Clock, typename Duration>
+[[nodiscard]] inline auto record_receiver<Wait>::receive_until(
+    const std::chrono::time_point<Clock, Duration> &deadline) -> result_type
+{
+    auto record = ring_->pop_ref_until(deadline);
+    if (record.has_value()) { return result_type{ std::in_place, std::move(*record) }; }
+    if (record.error() == channel_status::closed) { return std::unexpected(receiver_error_t::ChannelClosed); }
+    return std::unexpected(receiver_error_t::Timeout);
+}
+
+template<typename Wait>
+template<typename F>
+[[nodiscard]] inline auto record_receiver<Wait>::receive_many(F &&read, const std::size_t max) -> batch_result_type
+{
+    const auto received = ring_->pop_many(std::forward<F>(read), max);
+    if (received == 0U && max != 0U) { return std::unexpected(receiver_error_t::ChannelClosed); }
+    return received;
+}
+
+}// namespace nrws
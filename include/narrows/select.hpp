@@ -0,0 +1,378 @@
+#pragma once
+
+#include "narrows/_internal/_select.hpp"
+#include "narrows/single_bounded.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <optional>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace nrws {
+
+enum class select_error_t : uint8_t { Timeout, NoCases };
+
+// Which case a Selector tries first when several of them are ready
+enum class select_order : uint8_t {
+    in_order,   // always the first registered one, earlier cases take priority
+    round_robin,// the one after the case that fired last
+    random,     // a random one
+};
+
+// Fires once the receiver has a value or its channel is closed and drained. The handler is called
+// with the Receiver's result_type.
+template<typename R, typename F>
+class _receive_case
+{
+  public:
+    _receive_case(R &receiver, F handler) : receiver_(&receiver), handler_(std::move(handler)) {}
+
+    [[nodiscard]] inline auto active() const noexcept -> bool { return true; }
+    inline auto try_fire() -> bool;
+
+    inline auto watch(_select_signal &signal) -> void;
+    inline auto unwatch() -> void;
+
+  private:
+    R *receiver_;
+    F handler_;
+    _observer_list::node node_;
+};
+
+// Fires once there is room for its value or the channel is closed, and sends the value. The
+// handler is called with the Sender's result_type. A send case only fires once.
+template<typename S, typename F>
+class _send_case
+{
+  public:
+    _send_case(S &sender, typename S::value_type value, F handler)
+        : sender_(&sender), value_(std::move(value)), handler_(std::move(handler))
+    {}
+
+    [[nodiscard]] inline auto active() const noexcept -> bool { return value_.has_value(); }
+    inline auto try_fire() -> bool;
+
+    inline auto watch(_select_signal &signal) -> void;
+    inline auto unwatch() -> void;
+
+  private:
+    S *sender_;
+    std::optional<typename S::value_type> value_;
+    F handler_;
+    _observer_list::node node_;
+};
+
+// Case builders for select(), e.g.
+//
+//     nrws::select(nrws::on_receive(data, [](auto value) { ... }),
+//                  nrws::on_receive(shutdown, [](auto) { ... }));
+template<typename R, typename F>
+[[nodiscard]] auto on_receive(R &receiver, F handler) -> _receive_case<R, F>
+{
+    return { receiver, std::move(handler) };
+}
+
+template<typename S, typename F>
+[[nodiscard]] auto on_send(S &sender, typename S::value_type value, F handler) -> _send_case<S, F>
+{
+    return { sender, std::move(value), std::move(handler) };
+}
+
+// Waits on several channels at once and runs the handler of the first case that is ready.
+//
+// Ready cases are fired without registering anything, so a select loop that keeps finding values
+// never touches the channels' observer lists. Only once nothing is ready does the select watch
+// every channel, check them all again and park on a single signal until one of them changes.
+//
+// Cases are registered once and the Selector is reused for every wait.
+class Selector
+{
+  public:
+    explicit Selector(const select_order order = select_order::round_robin) : order_(order) {}
+
+    // Both return the index of the new case, which wait() returns when the case fired
+    template<typename R, typename F>
+    inline auto receive(R &receiver, F handler) -> std::size_t;
+    template<typename S, typename F>
+    inline auto send(S &sender, typename S::value_type value, F handler) -> std::size_t;
+
+    // The index of a removed case is not reused
+    inline auto remove(const std::size_t index) -> void { cases_.at(index).reset(); }
+
+    // Fires exactly one case and returns its index, or NoCases once there is nothing left to
+    // wait on (or Timeout once the deadline passed)
+    [[nodiscard]] inline auto wait() -> std::expected<std::size_t, select_error_t>;
+    template<typename Clock, typename Duration>
+    [[nodiscard]] inline auto wait_until(const std::chrono::time_point<Clock, Duration> &deadline)
+        -> std::expected<std::size_t, select_error_t>;
+    template<typename Rep, typename Period>
+    [[nodiscard]] inline auto wait_for(const std::chrono::duration<Rep, Period> &timeout)
+        -> std::expected<std::size_t, select_error_t>;
+
+  private:
+    struct _case
+    {
+        virtual ~_case() = default;
+
+        [[nodiscard]] virtual auto active() const noexcept -> bool = 0;
+        virtual auto try_fire() -> bool = 0;
+        virtual auto watch(_select_signal &signal) -> void = 0;
+        virtual auto unwatch() -> void = 0;
+    };
+
+    template<typename Case>
+    struct _erased_case final : _case
+    {
+        explicit _erased_case(Case &&c) : inner(std::move(c)) {}
+
+        [[nodiscard]] auto active() const noexcept -> bool override { return inner.active(); }
+        auto try_fire() -> bool override { return inner.try_fire(); }
+        auto watch(_select_signal &signal) -> void override { inner.watch(signal); }
+        auto unwatch() -> void override { inner.unwatch(); }
+
+        Case inner;
+    };
+
+    template<typename Clock, typename Duration>
+    inline auto _wait(const std::chrono::time_point<Clock, Duration> *deadline)
+        -> std::expected<std::size_t, select_error_t>;
+
+    std::vector<std::unique_ptr<_case>> cases_;
+    select_order order_;
+    std::size_t next_{ 0U };
+    std::minstd_rand random_{ std::random_device{}() };
+};
+
+/* Select loop */
+
+// Fires the first ready case, trying them from start on, and parks until one is ready otherwise.
+// visit(index, f) calls f with the case at index and returns what f returned, false for a
+// missing case. No deadline waits forever.
+template<typename Visit, typename Clock, typename Duration>
+auto _select(const std::size_t count,
+    const std::size_t start,
+    Visit visit,
+    const std::chrono::time_point<Clock, Duration> *deadline) -> std::expected<std::size_t, select_error_t>
+{
+    auto any_active = false;
+    const auto fire_first = [&]() -> std::optional<std::size_t> {
+        any_active = false;
+        for (std::size_t offset = 0U; offset < count; offset++) {
+            const auto index = (start + offset) % count;
+            if (!visit(index, [](auto &c) { return c.active(); })) { continue; }
+
+            any_active = true;
+            if (visit(index, [](auto &c) { return c.try_fire(); })) { return index; }
+        }
+        return std::nullopt;
+    };
+
+    _select_signal signal;
+    auto expired = false;
+
+    while (true) {
+        if (const auto fired = fire_first()) { return *fired; }
+        if (!any_active) { return std::unexpected(select_error_t::NoCases); }
+        if (expired) { return std::unexpected(select_error_t::Timeout); }
+
+        // watch everything before the last check, so a change after it raises the signal
+        const auto epoch = signal.epoch();
+        for (std::size_t index = 0U; index < count; index++) {
+            visit(index, [&signal](auto &c) {
+                if (c.active()) { c.watch(signal); }
+                return true;
+            });
+        }
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        const auto fired = fire_first();
+        if (!fired) {
+            if (deadline != nullptr) {
+                expired = !signal.wait_until(epoch, *deadline);
+            } else {
+                signal.wait(epoch);
+            }
+        }
+
+        for (std::size_t index = 0U; index < count; index++) {
+            visit(index, [](auto &c) {
+                c.unwatch();
+                return true;
+            });
+        }
+
+        if (fired) { return *fired; }
+    }
+}
+
+template<typename Tuple, typename F>
+auto _visit_case(Tuple &cases, const std::size_t index, F &&f) -> bool
+{
+    return [&]<std::size_t... I>(std::index_sequence<I...>) {
+        auto result = false;
+        static_cast<void>(((I == index ? (result = f(std::get<I>(cases)), true) : false) || ...));
+        return result;
+    }(std::make_index_sequence<std::tuple_size_v<Tuple>>{});
+}
+
+// Blocks until one of the cases is ready, fires it and returns its index. When several cases are
+// ready the earliest one wins, use a Selector for fairness.
+template<typename... Cases>
+[[nodiscard]] auto select(Cases &&...cases) -> std::size_t
+{
+    static_assert(sizeof...(Cases) != 0U, "select needs at least one case");
+
+    auto tuple = std::tuple<std::decay_t<Cases>...>(std::forward<Cases>(cases)...);
+    const auto visit = [&tuple](const std::size_t index, auto &&f) { return _visit_case(tuple, index, f); };
+    return _select(sizeof...(Cases), 0U, visit, static_cast<const std::chrono::steady_clock::time_point *>(nullptr))
+        .value();
+}
+
+// Like select(), but gives up with Timeout once the timeout passed
+template<typename Rep, typename Period, typename... Cases>
+[[nodiscard]] auto select_for(const std::chrono::duration<Rep, Period> &timeout, Cases &&...cases)
+    -> std::expected<std::size_t, select_error_t>
+{
+    static_assert(sizeof...(Cases) != 0U, "select needs at least one case");
+
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    auto tuple = std::tuple<std::decay_t<Cases>...>(std::forward<Cases>(cases)...);
+    const auto visit = [&tuple](const std::size_t index, auto &&f) { return _visit_case(tuple, index, f); };
+    return _select(sizeof...(Cases), 0U, visit, &deadline);
+}
+
+/* Case Implementations */
+
+template<typename R, typename F>
+inline auto _receive_case<R, F>::try_fire() -> bool
+{
+    auto received = receiver_->try_receive();
+    if (!received.has_value() && received.error() == receiver_error_t::ChannelEmpty) { return false; }
+
+    handler_(std::move(received));
+    return true;
+}
+
+template<typename R, typename F>
+inline auto _receive_case<R, F>::watch(_select_signal &signal) -> void
+{
+    node_.wake = [](void *context) noexcept {
+        static_cast<_select_signal *>(context)->notify();
+        return false;
+    };
+    node_.context = &signal;
+    receiver_->_watch(node_);
+}
+
+template<typename R, typename F>
+inline auto _receive_case<R, F>::unwatch() -> void
+{
+    if (node_.context == nullptr) { return; }
+
+    receiver_->_unwatch(node_);
+    node_.context = nullptr;
+}
+
+template<typename S, typename F>
+inline auto _send_case<S, F>::try_fire() -> bool
+{
+    if (!value_.has_value()) { return false; }
+
+    // try_send only moves the value out when it was sent
+    auto sent = sender_->try_send(std::move(*value_));
+    if (!sent.has_value() && sent.error() == sender_error_t::ChannelFull) { return false; }
+
+    value_.reset();
+    handler_(std::move(sent));
+    return true;
+}
+
+template<typename S, typename F>
+inline auto _send_case<S, F>::watch(_select_signal &signal) -> void
+{
+    node_.wake = [](void *context) noexcept {
+        static_cast<_select_signal *>(context)->notify();
+        return false;
+    };
+    node_.context = &signal;
+    sender_->_watch(node_);
+}
+
+template<typename S, typename F>
+inline auto _send_case<S, F>::unwatch() -> void
+{
+    if (node_.context == nullptr) { return; }
+
+    sender_->_unwatch(node_);
+    node_.context = nullptr;
+}
+
+/* Selector Implementations */
+
+template<typename R, typename F>
+inline auto Selector::receive(R &receiver, F handler) -> std::size_t
+{
+    using case_type = _receive_case<R, F>;
+    cases_.push_back(std::make_unique<_erased_case<case_type>>(case_type(receiver, std::move(handler))));
+    return cases_.size() - 1U;
+}
+
+template<typename S, typename F>
+inline auto Selector::send(S &sender, typename S::value_type value, F handler) -> std::size_t
+{
+    using case_type = _send_case<S, F>;
+    cases_.push_back(std::make_unique<_erased_case<case_type>>(case_type(sender, std::move(value), std::move(handler))));
+    return cases_.size() - 1U;
+}
+
+[[nodiscard]] inline auto Selector::wait() -> std::expected<std::size_t, select_error_t>
+{
+    return _wait(static_cast<const std::chrono::steady_clock::time_point *>(nullptr));
+}
+
+template<typename Clock, typename Duration>
+[[nodiscard]] inline auto Selector::wait_until(const std::chrono::time_point<Clock, Duration> &deadline)
+    -> std::expected<std::size_t, select_error_t>
+{
+    return _wait(&deadline);
+}
+
+template<typename Rep, typename Period>
+[[nodiscard]] inline auto Selector::wait_for(const std::chrono::duration<Rep, Period> &timeout)
+    -> std::expected<std::size_t, select_error_t>
+{
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    return _wait(&deadline);
+}
+
+template<typename Clock, typename Duration>
+inline auto Selector::_wait(const std::chrono::time_point<Clock, Duration> *deadline)
+    -> std::expected<std::size_t, select_error_t>
+{
+    if (cases_.empty()) { return std::unexpected(select_error_t::NoCases); }
+
+    auto start = std::size_t{ 0U };
+    if (order_ == select_order::round_robin) {
+        start = next_ % cases_.size();
+    } else if (order_ == select_order::random) {
+        start = random_() % cases_.size();
+    }
+
+    const auto visit = [this](const std::size_t index, auto &&f) -> bool {
+        auto &c = cases_[index];
+        return c != nullptr && f(*c);
+    };
+
+    const auto fired = _select(cases_.size(), start, visit, deadline);
+    if (fired) { next_ = *fired + 1U; }
+    return fired;
+}
+
+}// namespace nrws
@@ -0,0 +1,73 @@
+#pragma once
+
+#if defined(__linux__)
+
+#include "narrows/_internal/_shm_channel.hpp"
+#include "narrows/single_bounded.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace nrws {
+
+// Bounded channel whose ring lives in a named POSIX shared memory segment, so Senders and
+// Receivers in different processes can talk to each other without a syscall per value. Linux
+// only, and only for trivially copyable T.
+//
+// One process creates the segment by passing a capacity, every other one attaches by name:
+//
+//     // capture process
+//     auto sender = nrws::shm_sender<packet>("/narrows-capture", 4096);
+//     sender.send(p);
+//
+//     // processing process
+//     auto receiver = nrws::shm_receiver<packet>("/narrows-capture");
+//     for (const auto &p : receiver) { ... }
+//
+// Both ends have the usual Sender/Receiver interface and may be copied to any number of threads,
+// and any number of processes may attach to either side. close() closes the channel for every
+// process. A process that dies or drops its end without closing is noticed by the other side
+// within about 50ms of waiting, then the channel closes and peer_lost() returns true.
+//
+// select, coroutines and ready_fd only hear about what happens in their own process, wait on a
+// shared memory channel with the blocking or timed operations instead.
+template<typename T>
+using shm_channel = _shm_channel<T>;
+
+// Creates the segment and attaches a Sender. Throws std::system_error if it can't be created.
+template<typename T>
+[[nodiscard]] auto shm_sender(const std::string &name, const std::size_t capacity) -> Sender<T, shm_channel>
+{
+    return Sender<T, shm_channel>(std::make_shared<shm_channel<T>>(name, capacity, _shm_side::sender));
+}
+
+// Attaches a Sender to an existing segment. Throws std::system_error if there is none under name
+// or it was created for another type.
+template<typename T>
+[[nodiscard]] auto shm_sender(const std::string &name) -> Sender<T, shm_channel>
+{
+    return Sender<T, shm_channel>(std::make_shared<shm_channel<T>>(name, _shm_side::sender));
+}
+
+// Creates the segment and attaches a Receiver. Throws std::system_error if it can't be created.
+template<typename T>
+[[nodiscard]] auto shm_receiver(const std::string &name, const std::size_t capacity) -> Receiver<T, shm_channel>
+{
+    return Receiver<T, shm_channel>(std::make_shared<shm_channel<T>>(name, capacity, _shm_side::receiver));
+}
+
+// Attaches a Receiver to an existing segment. Throws std::system_error if there is none under
+// name or it was created for another type.
+template<typename T>
+[[nodiscard]] auto shm_receiver(const std::string &name) -> Receiver<T, shm_channel>
+{
+    return Receiver<T, shm_channel>(std::make_shared<shm_channel<T>>(name, _shm_side::receiver));
+}
+
+static_assert(is_sender<Sender<int, shm_channel>>, "Must satisfy the sender concept.");
+static_assert(is_receiver<Receiver<int, shm_channel>>, "Must satisfy the receiver concept");
+
+}// namespace nrws
+
+#endif
@@ -1,16 +1,24 @@
 #pragma once
 
 #include "concepts.hpp"
+#include "narrows/_internal/_awaitable.hpp"
+#include "narrows/_internal/_channel.hpp"
+#include "narrows/_internal/_spsc_ring.hpp"
 #include "narrows/bounded.hpp"
 
+#include <chrono>
+#include <cstddef>
 #include <expected>
+#include <iterator>
 #include <memory>
+#include <ranges>
+#include <span>
 #include <type_traits>
 
 namespace nrws {
 
-enum class sender_error_t : uint8_t { ChannelClosed, ChannelFull };
-enum class receiver_error_t : uint8_t { ChannelClosed, ChannelFull };
+enum class sender_error_t : uint8_t { ChannelClosed, ChannelFull, Timeout, TooLarge };
+enum class receiver_error_t : uint8_t { ChannelClosed, ChannelFull, Timeout, ChannelEmpty, Lagged };
 
 template<typename T, template<typename V = T> typename Backend>
 class Sender
@@ -20,18 +28,105 @@ class Sender
     using error_type = sender_error_t;
     using result_type = std::expected<void, error_type>;
     using channel_type = std::decay_t<Backend<T>>;
+    using batch_result_type = std::expected<std::size_t, error_type>;
+    using slot_type = typename channel_type::_write_guard;
 
     explicit Sender(std::shared_ptr<channel_type> backend) : backend_(backend) {}
 
     [[nodiscard]] inline auto send(const value_type &val) -> result_type;
     [[nodiscard]] inline auto send(value_type &&val) -> result_type;
 
+    // Never blocks, returns ChannelFull if there is no room right now. The value is only moved
+    // from if it was sent.
+    [[nodiscard]] inline auto try_send(const value_type &val) -> result_type;
+    [[nodiscard]] inline auto try_send(value_type &&val) -> result_type;
+
+    // Waits for room until the deadline or for at most the timeout, returns Timeout if none came up
+    template<typename Clock, typename Duration>
+    [[nodiscard]] inline auto send_until(const value_type &val, const std::chrono::time_point<Clock, Duration> &deadline)
+        -> result_type;
+    template<typename Clock, typename Duration>
+    [[nodiscard]] inline auto send_until(value_type &&val, const std::chrono::time_point<Clock, Duration> &deadline)
+        -> result_type;
+    template<typename Rep, typename Period>
+    [[nodiscard]] inline auto send_for(const value_type &val, const std::chrono::duration<Rep, Period> &timeout)
+        -> result_type;
+    template<typename Rep, typename Period>
+    [[nodiscard]] inline auto send_for(value_type &&val, const std::chrono::duration<Rep, Period> &timeout)
+        -> result_type;
+
+    // Constructs the value from args directly in the channel
+    template<typename... Args>
+    [[nodiscard]] inline auto emplace(Args &&...args) -> result_type;
+
+    // Constructs a value from args in a slot of the channel and hands it out to be filled in
+    // place. The value is sent on slot.commit() or when the slot is destroyed.
+    template<typename... Args>
+    [[nodiscard]] inline auto reserve(Args &&...args) -> std::expected<slot_type, error_type>;
+
+    // Sends a whole batch, as many values per synchronization as there is room for. The values are
+    // copied, unless the range is a container handed over as an rvalue, e.g.
+    // send_many(std::move(values)). To move out of values the caller keeps, pass move iterators:
+    // send_many(std::make_move_iterator(v.begin()), std::make_move_iterator(v.end())). Returns
+    // the number of values sent, or ChannelClosed if the channel closed before all were placed.
+    template<std::ranges::input_range R>
+    [[nodiscard]] inline auto send_many(R &&values) -> batch_result_type;
+    template<std::input_iterator It, std::sentinel_for<It> S>
+    [[nodiscard]] inline auto send_many(It first, S last) -> batch_result_type;
+
     inline auto close() { backend_->close(); }
 
+    // Values a lossy bounded_channel dropped or conflated instead of waiting for room
+    [[nodiscard]] inline auto dropped() const noexcept
+        requires requires(const channel_type &channel) { channel.dropped(); }
+    {
+        return backend_->dropped();
+    }
+    [[nodiscard]] inline auto conflated() const noexcept
+        requires requires(const channel_type &channel) { channel.conflated(); }
+    {
+        return backend_->conflated();
+    }
+
+    // Statistics of an instrumented channel, see nrws::instrumented
+    [[nodiscard]] inline auto stats() const noexcept
+        requires requires(const channel_type &channel) { channel.stats(); }
+    {
+        return backend_->stats();
+    }
+
+    // True once a shared memory channel was closed because the other side went away, see shm_channel
+    [[nodiscard]] inline auto peer_lost() const noexcept
+        requires requires(const channel_type &channel) { channel.peer_lost(); }
+    {
+        return backend_->peer_lost();
+    }
+
+    // Awaitable send for coroutines. A coroutine that has to wait for room is suspended without
+    // blocking its thread and resumed through executor once the value was sent (or the channel
+    // closed). The Sender must outlive the co_await.
+    template<is_executor Executor>
+    [[nodiscard]] inline auto async_send(value_type val, Executor &executor) -> _send_awaitable<Sender, Executor>
+    {
+        return { *this, std::move(val), executor };
+    }
+
+    // used by select and coroutines to wait for room in the channel
+    inline auto _watch(_observer_list::node &observer) { backend_->_watch_room(observer); }
+    inline auto _unwatch(_observer_list::node &observer) { backend_->_unwatch_room(observer); }
+    inline auto _pass_on() noexcept { backend_->_pass_room_on(); }
+
   private:
+    [[nodiscard]] static inline auto _to_result(channel_status status) -> result_type;
+
+    // pushes [first, last), ChannelClosed if a close cut it short
+    template<typename It, typename S>
+    [[nodiscard]] inline auto _send_many(It first, S last) -> batch_result_type;
+
     std::shared_ptr<channel_type> backend_;
 };
 static_assert(is_sender<Sender<int, bounded_channel>>, "Must satisfy the sender concept.");
+static_assert(is_sender<Sender<int, array_channel>>, "Must satisfy the sender concept.");
 
 template<typename T, template<typename V = T> typename Backend>
 class Receiver
@@ -41,48 +136,353 @@ class Receiver
     using error_type = receiver_error_t;
     using result_type = std::expected<value_type, error_type>;
     using channel_type = std::decay_t<Backend<T>>;
+    using batch_result_type = std::expected<std::size_t, error_type>;
+    using ref_type = typename channel_type::_read_guard;
 
     explicit Receiver(std::shared_ptr<channel_type> backend) : backend_(backend) {}
 
     [[nodiscard]] inline auto receive() -> result_type;
 
+    // Never blocks, returns ChannelEmpty if no value is ready right now
+    [[nodiscard]] inline auto try_receive() -> result_type;
+
+    // Waits for a value until the deadline or for at most the timeout, returns Timeout if none came
+    template<typename Clock, typename Duration>
+    [[nodiscard]] inline auto receive_until(const std::chrono::time_point<Clock, Duration> &deadline) -> result_type;
+    template<typename Rep, typename Period>
+    [[nodiscard]] inline auto receive_for(const std::chrono::duration<Rep, Period> &timeout) -> result_type;
+
+    // Hands out the next value in place instead of moving it out of the channel. Its slot is
+    // freed on ref.release() or when the ref is destroyed.
+    [[nodiscard]] inline auto receive_ref() -> std::expected<ref_type, error_type>;
+
+    // Waits for at least one value, then writes up to max of the values that are ready to out.
+    // Returns the number written, ChannelClosed once the channel is closed and drained, or
+    // Timeout if nothing arrived in time.
+    template<std::output_iterator<value_type> Out>
+    [[nodiscard]] inline auto receive_many(Out out, std::size_t max) -> batch_result_type;
+    template<std::output_iterator<value_type> Out, typename Rep, typename Period>
+    [[nodiscard]] inline auto receive_many(Out out, std::size_t max, const std::chrono::duration<Rep, Period> &timeout)
+        -> batch_result_type;
+
+    // Writes up to max of the values that are ready right now to out, ChannelEmpty if there are none
+    template<std::output_iterator<value_type> Out>
+    [[nodiscard]] inline auto try_receive_many(Out out, std::size_t max) -> batch_result_type;
+
     [[nodiscard]] inline auto begin();
     [[nodiscard]] inline auto end();
 
+    // Range over the received values that pulls up to batch_size values per synchronization
+    [[nodiscard]] inline auto batched(std::size_t batch_size);
+
     inline auto close() { backend_->close(); }
 
+    // Values a lossy bounded_channel dropped or conflated instead of waiting for room
+    [[nodiscard]] inline auto dropped() const noexcept
+        requires requires(const channel_type &channel) { channel.dropped(); }
+    {
+        return backend_->dropped();
+    }
+    [[nodiscard]] inline auto conflated() const noexcept
+        requires requires(const channel_type &channel) { channel.conflated(); }
+    {
+        return backend_->conflated();
+    }
+
+    // Statistics of an instrumented channel, see nrws::instrumented
+    [[nodiscard]] inline auto stats() const noexcept
+        requires requires(const channel_type &channel) { channel.stats(); }
+    {
+        return backend_->stats();
+    }
+
+    // True once a shared memory channel was closed because the other side went away, see shm_channel
+    [[nodiscard]] inline auto peer_lost() const noexcept
+        requires requires(const channel_type &channel) { channel.peer_lost(); }
+    {
+        return backend_->peer_lost();
+    }
+
+    // Awaitable receive for coroutines. A coroutine that has to wait for a value is suspended
+    // without blocking its thread and resumed through executor once it got one (or the channel
+    // closed and drained). The Receiver must outlive the co_await.
+    template<is_executor Executor>
+    [[nodiscard]] inline auto async_receive(Executor &executor) -> _receive_awaitable<Receiver, Executor>
+    {
+        return { *this, executor };
+    }
+
+    // used by select, coroutines and ready_fd to wait for a value in the channel
+    inline auto _watch(_observer_list::node &observer) { backend_->_watch_values(observer); }
+    inline auto _unwatch(_observer_list::node &observer) { backend_->_unwatch_values(observer); }
+    inline auto _pass_on() noexcept { backend_->_pass_values_on(); }
+    [[nodiscard]] inline auto _ready() const noexcept -> bool { return !backend_->empty() || backend_->closed(); }
+
   private:
+    [[nodiscard]] static inline auto _to_result(std::expected<value_type, channel_status> &&received) -> result_type;
+
     std::shared_ptr<channel_type> backend_;
 };
 static_assert(is_receiver<Receiver<int, bounded_channel>>, "Must satisfy the receiver concept");
+static_assert(is_receiver<Receiver<int, array_channel>>, "Must satisfy the receiver concept");
 
-template<typename T>
-[[nodiscard]] auto bounded(const std::size_t capacity)
-    -> std::pair<Sender<T, bounded_channel>, Receiver<T, bounded_channel>>
+// Backend selects the channel implementation, e.g. nrws::bounded<int, nrws::array_channel>(64).
+// Any further arguments are passed on to the backend, e.g. an allocator.
+template<typename T, template<typename V = T> typename Backend = bounded_channel, typename... Args>
+[[nodiscard]] auto bounded(const std::size_t capacity, Args &&...args)
+    -> std::pair<Sender<T, Backend>, Receiver<T, Backend>>
 {
-    auto bounded_ch = std::make_shared<bounded_channel<T>>(capacity);
-    return { Sender<T, bounded_channel>(bounded_ch), Receiver<T, bounded_channel>(bounded_ch) };
+    auto bounded_ch = std::make_shared<typename Sender<T, Backend>::channel_type>(capacity, std::forward<Args>(args)...);
+    return { Sender<T, Backend>(bounded_ch), Receiver<T, Backend>(bounded_ch) };
 }
 
+// Capacity fixed at compile time, the channel is a static_channel with its slots stored inline in
+// the shared block, e.g. nrws::bounded<int, 64>().
+template<typename T, std::size_t N>
+[[nodiscard]] auto bounded() -> std::pair<Sender<T, _static_backend<N>::template type>,
+    Receiver<T, _static_backend<N>::template type>>
+{
+    using sender_type = Sender<T, _static_backend<N>::template type>;
+    using receiver_type = Receiver<T, _static_backend<N>::template type>;
+
+    auto bounded_ch = std::make_shared<typename sender_type::channel_type>();
+    return { sender_type(bounded_ch), receiver_type(bounded_ch) };
+}
+
+namespace single {
+
+    // binds Wait so the ring can be used where an end takes only the value type
+    template<typename Wait>
+    struct _spsc_backend
+    {
+        template<typename V>
+        using type = _spsc_ring<V, Wait>;
+    };
+
+    // Single producer/single consumer channel backed by a lock-free ring. With nrws::instrumented<>
+    // as Wait both ends return the ring's statistics.
+    template<typename T, typename Wait = park_wait>
+    [[nodiscard]] auto bounded(const std::size_t capacity) -> std::pair<sender<T, _spsc_backend<Wait>::template type>,
+        receiver<T, _spsc_backend<Wait>::template type>>
+    {
+        using sender_type = sender<T, _spsc_backend<Wait>::template type>;
+        using receiver_type = receiver<T, _spsc_backend<Wait>::template type>;
+
+        auto ring = std::make_shared<typename sender_type::container_type>(capacity);
+        return { sender_type(ring), receiver_type(ring) };
+    }
+
+}// namespace single
+
 template<typename T, template<typename V = T> typename Backend>
 [[nodiscard]] inline auto Sender<T, Backend>::send(const value_type &val) -> result_type
 {
-    backend_->push(val);
+    if (!backend_->push(val)) { return std::unexpected(sender_error_t::ChannelClosed); }
     return result_type{};
 }
 
 template<typename T, template<typename V = T> typename Backend>
 [[nodiscard]] inline auto Sender<T, Backend>::send(value_type &&val) -> result_type
 {
-    backend_->push(std::forward<T>(val));
+    if (!backend_->push(std::forward<T>(val))) { return std::unexpected(sender_error_t::ChannelClosed); }
+    return result_type{};
+}
+
+template<typename T, template<typename V = T> typename Backend>
+[[nodiscard]] inline auto Sender<T, Backend>::try_send(const value_type &val) -> result_type
+{
+    return _to_result(backend_->try_push(val));
+}
+
+template<typename T, template<typename V = T> typename Backend>
+[[nodiscard]] inline auto Sender<T, Backend>::try_send(value_type &&val) -> result_type
+{
+    return _to_result(backend_->try_push(std::move(val)));
+}
+
+template<typename T, template<typename V = T> typename Backend>
+template<typename Clock, typename Duration>
+[[nodiscard]] inline auto Sender<T, Backend>::send_until(
+    const value_type &val, const std::chrono::time_point<Clock, Duration> &deadline) -> result_type
+{
+    return _to_result(backend_->push_until(val, deadline));
+}
+
+template<typename T, template<typename V = T> typename Backend>
+template<typename Clock, typename Duration>
+[[nodiscard]] inline auto Sender<T, Backend>::send_until(
+    value_type &&val, const std::chrono::time_point<Clock, Duration> &deadline) -> result_type
+{
+    return _to_result(backend_->push_until(std::move(val), deadline));
+}
+
+template<typename T, template<typename V = T> typename Backend>
+template<typename Rep, typename Period>
+[[nodiscard]] inline auto Sender<T, Backend>::send_for(
+    const value_type &val, const std::chrono::duration<Rep, Period> &timeout) -> result_type
+{
+    return send_until(val, std::chrono::steady_clock::now() + timeout);
+}
+
+template<typename T, template<typename V = T> typename Backend>
+template<typename Rep, typename Period>
+[[nodiscard]] inline auto Sender<T, Backend>::send_for(
+    value_type &&val, const std::chrono::duration<Rep, Period> &timeout) -> result_type
+{
+    return send_until(std::move(val), std::chrono::steady_clock::now() + timeout);
+}
+
+template<typename T, template<typename V = T> typename Backend>
+[[nodiscard]] inline auto Sender<T, Backend>::_to_result(const channel_status status) -> result_type
+{
+    switch (status) {
+    case channel_status::success:
+        return result_type{};
+    case channel_status::full:
+        return std::unexpected(sender_error_t::ChannelFull);
+    case channel_status::timeout:
+        return std::unexpected(sender_error_t::Timeout);
+    default:
+        return std::unexpected(sender_error_t::ChannelClosed);
+    }
+}
+
+template<typename T, template<typename V = T> typename Backend>
+template<typename... Args>
+[[nodiscard]] inline auto Sender<T, Backend>::emplace(Args &&...args) -> result_type
+{
+    if (!backend_->emplace(std::forward<Args>(args)...)) { return std::unexpected(sender_error_t::ChannelClosed); }
     return result_type{};
 }
 
+template<typename T, template<typename V = T> typename Backend>
+template<typename... Args>
+[[nodiscard]] inline auto Sender<T, Backend>::reserve(Args &&...args) -> std::expected<slot_type, error_type>
+{
+    auto slot = backend_->reserve(std::forward<Args>(args)...);
+    if (!slot.has_value()) { return std::unexpected(sender_error_t::ChannelClosed); }
+    return std::expected<slot_type, error_type>{ std::in_place, std::move(*slot) };
+}
+
+template<typename T, template<typename V = T> typename Backend>
+template<std::ranges::input_range R>
+[[nodiscard]] inline auto Sender<T, Backend>::send_many(R &&values) -> batch_result_type
+{
+    // only a container that was handed over is moved from, a view still refers to the caller's
+    // values. Moving a trivially copyable value is a copy anyway, and plain iterators keep the
+    // memcpy path open.
+    constexpr bool owned = !std::is_lvalue_reference_v<R> && !std::ranges::borrowed_range<R>;
+    if constexpr (owned && !std::is_trivially_copyable_v<value_type>) {
+        return _send_many(std::make_move_iterator(std::ranges::begin(values)),
+            std::move_sentinel(std::ranges::end(values)));
+    } else {
+        return _send_many(std::ranges::begin(values), std::ranges::end(values));
+    }
+}
+
+template<typename T, template<typename V = T> typename Backend>
+template<std::input_iterator It, std::sentinel_for<It> S>
+[[nodiscard]] inline auto Sender<T, Backend>::send_many(It first, S last) -> batch_result_type
+{
+    return _send_many(std::move(first), std::move(last));
+}
+
+template<typename T, template<typename V = T> typename Backend>
+template<typename It, typename S>
+[[nodiscard]] inline auto Sender<T, Backend>::_send_many(It first, S last) -> batch_result_type
+{
+    const auto sent = backend_->_push_many(first, last);
+    // a close that came after the last value was placed doesn't fail the batch
+    if (first != last) { return std::unexpected(sender_error_t::ChannelClosed); }
+    return sent;
+}
+
 template<typename T, template<typename V = T> typename Backend>
 [[nodiscard]] inline auto Receiver<T, Backend>::receive() -> result_type
 {
-    const auto received = backend_->pop();
-    if (received.has_value()) { return received.value(); }
+    auto received = backend_->pop();
+    if (received.has_value()) { return std::move(*received); }
+    return std::unexpected(receiver_error_t::ChannelClosed);
+}
+
+template<typename T, template<typename V = T> typename Backend>
+[[nodiscard]] inline auto Receiver<T, Backend>::try_receive() -> result_type
+{
+    return _to_result(backend_->try_pop());
+}
+
+template<typename T, template<typename V = T> typename Backend>
+template<typename Clock, typename Duration>
+[[nodiscard]] inline auto Receiver<T, Backend>::receive_until(const std::chrono::time_point<Clock, Duration> &deadline)
+    -> result_type
+{
+    return _to_result(backend_->pop_until(deadline));
+}
+
+template<typename T, template<typename V = T> typename Backend>
+template<typename Rep, typename Period>
+[[nodiscard]] inline auto Receiver<T, Backend>::receive_for(const std::chrono::duration<Rep, Period> &timeout)
+    -> result_type
+{
+    return receive_until(std::chrono::steady_clock::now() + timeout);
+}
+
+template<typename T, template<typename V = T> typename Backend>
+[[nodiscard]] inline auto Receiver<T, Backend>::_to_result(std::expected<value_type, channel_status> &&received)
+    -> result_type
+{
+    if (received.has_value()) { return std::move(received.value()); }
+
+    switch (received.error()) {
+    case channel_status::empty:
+        return std::unexpected(receiver_error_t::ChannelEmpty);
+    case channel_status::timeout:
+        return std::unexpected(receiver_error_t::Timeout);
+    default:
+        return std::unexpected(receiver_error_t::ChannelClosed);
+    }
+}
+
+template<typename T, template<typename V = T> typename Backend>
+[[nodiscard]] inline auto Receiver<T, Backend>::receive_ref() -> std::expected<ref_type, error_type>
+{
+    auto ref = backend_->pop_ref();
+    if (!ref.has_value()) { return std::unexpected(receiver_error_t::ChannelClosed); }
+    return std::expected<ref_type, error_type>{ std::in_place, std::move(*ref) };
+}
+
+template<typename T, template<typename V = T> typename Backend>
+template<std::output_iterator<typename Receiver<T, Backend>::value_type> Out>
+[[nodiscard]] inline auto Receiver<T, Backend>::receive_many(Out out, const std::size_t max) -> batch_result_type
+{
+    const auto received = backend_->pop_many(std::move(out), max);
+    if (received == 0U && max != 0U) { return std::unexpected(receiver_error_t::ChannelClosed); }
+    return received;
+}
+
+template<typename T, template<typename V = T> typename Backend>
+template<std::output_iterator<typename Receiver<T, Backend>::value_type> Out, typename Rep, typename Period>
+[[nodiscard]] inline auto Receiver<T, Backend>::receive_many(
+    Out out, const std::size_t max, const std::chrono::duration<Rep, Period> &timeout) -> batch_result_type
+{
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    const auto received = backend_->pop_many_until(std::move(out), max, deadline);
+
+    if (received == 0U && max != 0U) {
+        if (backend_->closed() && backend_->empty()) { return std::unexpected(receiver_error_t::ChannelClosed); }
+        return std::unexpected(receiver_error_t::Timeout);
+    }
+    return received;
+}
+
+template<typename T, template<typename V = T> typename Backend>
+template<std::output_iterator<typename Receiver<T, Backend>::value_type> Out>
+[[nodiscard]] inline auto Receiver<T, Backend>::try_receive_many(Out out, const std::size_t max) -> batch_result_type
+{
+    const auto received = backend_->try_pop_many(std::move(out), max);
+    if (received.has_value()) { return *received; }
+
+    if (received.error() == channel_status::empty) { return std::unexpected(receiver_error_t::ChannelEmpty); }
     return std::unexpected(receiver_error_t::ChannelClosed);
 }
 
@@ -98,4 +498,10 @@ template<typename T, template<typename V = T> typename Backend>
     return backend_->end();
 }
 
+template<typename T, template<typename V = T> typename Backend>
+[[nodiscard]] inline auto Receiver<T, Backend>::batched(const std::size_t batch_size)
+{
+    return backend_->batched(batch_size);
+}
+
 };// namespace nrws
@@ -1,117 +1,36 @@
 #pragma once
 
-#include <atomic>
-#include <condition_variable>
-#include <optional>
-#include <queue>
+#include "narrows/_internal/_list_channel.hpp"
+#include "narrows/single_bounded.hpp"
+#include "narrows/wait.hpp"
 
-namespace nrws {
-
-// This class is roughly based on Andrei Avram's excellent cpp channel
-// https://blog.andreiavram.ro/cpp-channel-thread-safe-container-share-data-threads/
-template<typename T>
-class channel
-{
-  public:
-    using value_type = std::decay<T>;
-    using size_type = std::size_t;
-
-    constexpr channel() = default;
-
-    inline auto push(const value_type &value) -> void;
-    inline auto push(value_type &&value) -> void;
-
-    [[nodiscard]] inline auto pop() -> std::optional<value_type>;
-
-    inline auto close() -> void;
-
-    [[nodiscard]] inline auto size() const noexcept -> size_type;
-    [[nodiscard]] inline auto empty() const noexcept -> bool;
-    [[nodiscard]] inline auto closed() const noexcept -> bool;
-
-  private:
-    std::atomic<size_type> size_{ 0 };
-    std::atomic<bool> closed_{ false };
-    std::queue<value_type> queue_{};
-    std::mutex mutex_;
-    std::condition_variable cv_;
-};
-}// namespace nrws
-
-/* Unbounded Channel Implementations */
-
-template<typename T>
-inline auto nrws::channel<T>::push(const value_type &value) -> void
-{
-    {
-        std::unique_lock<std::mutex> lock{ mutex_ };
-
-        queue_.push(value);
-        size_ += 1;
-    }
-
-    cv_.notify_one();
-}
-
-template<typename T>
-inline auto nrws::channel<T>::push(value_type &&value) -> void
-{
-    {
-        std::unique_lock<std::mutex> lock{ mutex_ };
+#include <memory>
+#include <memory_resource>
+#include <utility>
 
-        queue_.push(std::forward<T>(value));
-        size_ += 1;
-    }
-
-    cv_.notify_one();
-}
-
-template<typename T>
-[[nodiscard]] inline auto nrws::channel<T>::pop() -> std::optional<value_type>
-{
-    std::optional<value_type> value{ std::nullopt };
-
-    {
-        std::unique_lock lock{ mutex_ };
-        cv_.wait(lock, [this]() { return !empty() || closed(); });
-
-        if (!empty()) {
-            value = std::move(queue_.front());
-            queue_.pop();
-            size_ -= 1;
-        }
-    }
-
-    cv_.notify_one();
-
-    return value;
-}
+namespace nrws {
 
-template<typename T>
-inline auto nrws::channel<T>::close() -> void
-{
-    {
-        std::unique_lock<std::mutex> lock{ mutex_ };
-        closed_ = true;
-    }
+// Lock-free unbounded channel made of linked blocks of slots. The channel never fills up, so
+// only receivers ever wait, using the Wait policy.
+template<typename T, typename Wait = park_wait, typename Allocator = std::allocator<std::decay_t<T>>>
+using list_channel = _list_channel<T, Wait, Allocator>;
 
-    cv_.notify_all();
-}
+template<typename T, typename Wait = park_wait, typename Allocator = std::allocator<std::decay_t<T>>>
+using channel = list_channel<T, Wait, Allocator>;
 
-template<typename T>
-[[nodiscard]] inline auto nrws::channel<T>::size() const noexcept -> size_type
-{
-    return size_;
-}
+// Channels that take their storage from a std::pmr::memory_resource
+namespace pmr {
+    template<typename T, typename Wait = park_wait>
+    using list_channel = nrws::list_channel<T, Wait, std::pmr::polymorphic_allocator<std::decay_t<T>>>;
+}// namespace pmr
 
-template<typename T>
-[[nodiscard]] inline auto nrws::channel<T>::empty() const noexcept -> bool
+// Backend selects the channel implementation, e.g. nrws::unbounded<int, nrws::list_channel>().
+// Any arguments are passed on to the backend, e.g. an allocator or a block retention cap.
+template<typename T, template<typename V = T> typename Backend = list_channel, typename... Args>
+[[nodiscard]] auto unbounded(Args &&...args) -> std::pair<Sender<T, Backend>, Receiver<T, Backend>>
 {
-    return size_ == 0;
+    auto unbounded_ch = std::make_shared<typename Sender<T, Backend>::channel_type>(std::forward<Args>(args)...);
+    return { Sender<T, Backend>(unbounded_ch), Receiver<T, Backend>(unbounded_ch) };
 }
 
-template<typename T>
-[[nodiscard]] inline auto nrws::channel<T>::closed() const noexcept -> bool
-{
-    return closed_;
-}
+}// namespace nrws
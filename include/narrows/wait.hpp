@@ -0,0 +1,122 @@
+#pragma once
+
+#include "narrows/_internal/_arch.hpp"
+#include "narrows/_internal/_waiter.hpp"
+#include "narrows/concepts.hpp"
+
+#include <chrono>
+#include <thread>
+
+namespace nrws {
+
+// Wait policies decide what a thread does while a channel is full (senders) or empty
+// (receivers). Every backend takes one as a template parameter and keeps two independent
+// waiter sets, one for "not full" and one for "not empty", so a notification always goes to a
+// thread that can make progress. To use a policy with Sender/Receiver, alias the backend:
+//
+//     template<typename T>
+//     using spinning_channel = nrws::array_channel<T, nrws::spin_wait>;
+//     auto [s, r] = nrws::bounded<int, spinning_channel>(64);
+
+// Busy spins on the condition, lowest latency but burns a core per waiting thread
+struct spin_wait
+{
+    class waiter_set
+    {
+      public:
+        template<typename Pred>
+        inline auto wait(Pred ready) -> void
+        {
+            while (!ready()) { _cpu_relax(); }
+        }
+
+        template<typename Pred, typename Clock, typename Duration>
+        inline auto wait_until(Pred ready, const std::chrono::time_point<Clock, Duration> &deadline) -> bool
+        {
+            while (!ready()) {
+                if (Clock::now() >= deadline) { return ready(); }
+                _cpu_relax();
+            }
+
+            return true;
+        }
+
+        // spinning threads poll the condition, so there is no one to wake
+        inline auto notify_one() noexcept -> void {}
+        inline auto notify_all() noexcept -> void {}
+    };
+};
+
+// Spins briefly, then yields the rest of its time slice between checks
+struct yield_wait
+{
+    class waiter_set
+    {
+      public:
+        template<typename Pred>
+        inline auto wait(Pred ready) -> void
+        {
+            for (int spin = 0; spin < _spin_limit; spin++) {
+                if (ready()) { return; }
+                _cpu_relax();
+            }
+
+            while (!ready()) { std::this_thread::yield(); }
+        }
+
+        template<typename Pred, typename Clock, typename Duration>
+        inline auto wait_until(Pred ready, const std::chrono::time_point<Clock, Duration> &deadline) -> bool
+        {
+            while (!ready()) {
+                if (Clock::now() >= deadline) { return ready(); }
+                std::this_thread::yield();
+            }
+
+            return true;
+        }
+
+        inline auto notify_one() noexcept -> void {}
+        inline auto notify_all() noexcept -> void {}
+
+      private:
+        constexpr static int _spin_limit = 64;
+    };
+};
+
+// Spins, then yields, then parks on std::atomic::wait. Notifiers count waiters and skip the
+// syscall entirely while the other side is running. This is the default policy.
+struct park_wait
+{
+    using waiter_set = _waiter_set;
+};
+
+// Waits like Wait, and makes channels keep statistics about their traffic, which stats() returns
+// as a channel_stats snapshot. Channels with any other policy compile the bookkeeping away.
+//
+//     auto [s, r] = nrws::bounded<int, nrws::instrumented_backend<nrws::array_channel>::type>(64);
+//     const auto stats = s.stats();
+template<typename Wait = park_wait>
+struct instrumented
+{
+    using waiter_set = typename Wait::waiter_set;
+};
+
+// binds instrumented so a backend can be used where it takes only the value type
+template<template<typename, typename...> typename Backend>
+struct instrumented_backend
+{
+    template<typename T, typename Wait = park_wait>
+    using type = Backend<T, instrumented<Wait>>;
+};
+
+template<typename Wait>
+constexpr bool _is_instrumented = false;
+template<typename Wait>
+constexpr bool _is_instrumented<instrumented<Wait>> = true;
+
+static_assert(is_wait_policy<spin_wait>, "Must satisfy the wait policy concept");
+static_assert(is_wait_policy<yield_wait>, "Must satisfy the wait policy concept");
+static_assert(is_wait_policy<park_wait>, "Must satisfy the wait policy concept");
+static_assert(is_wait_policy<instrumented<>>, "Must satisfy the wait policy concept");
+
+}// namespace nrws
@@ -0,0 +1,334 @@
+#pragma once
+
+#include "narrows/_internal/_select.hpp"
+#include "narrows/_internal/_waiter.hpp"
+#include "narrows/_internal/_work_deque.hpp"
+#include "narrows/bounded.hpp"
+#include "narrows/concepts.hpp"
+#include "narrows/single_bounded.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace nrws {
+
+// Runs a handler on every value received from a channel, spread over a fixed set of threads.
+//
+// Workers don't pop the shared channel one value at a time. Each one pulls a batch into its own
+// work stealing deque and works through that, so the channel is synchronized on once per batch.
+// A worker that runs dry steals from the others before going back to the channel, so no worker
+// sits idle while another one still has a backlog.
+//
+// A worker with nothing to do parks on a waiter of the pool, not on the channel, so it can be
+// woken both by values arriving in the channel and by a batch landing in another worker's deque.
+// While any worker is parked, the pool watches the channel to learn about new values.
+//
+// The pool either drains a Receiver it was given, or owns a channel that is fed with submit().
+// It stops once the channel is closed and everything in it was handled; the destructor closes its
+// own channel and waits for that. The handler is called from every worker at once.
+//
+//     nrws::worker_pool<job> pool([](job &&j) { j.run(); });
+//     pool.submit(job{ ... });
+template<typename T, typename R = Receiver<T, array_channel>>
+class worker_pool
+{
+  public:
+    using value_type = std::decay_t<T>;
+    using receiver_type = R;
+    using sender_type = Sender<T, array_channel>;
+    using handler_type = std::move_only_function<void(value_type &&)>;
+    using size_type = std::size_t;
+
+    // number of values a worker pulls from the channel at once
+    constexpr static size_type default_batch = 32U;
+
+    // Owns a channel of the given capacity, fed with submit()
+    explicit worker_pool(handler_type handler,
+        size_type threads = std::thread::hardware_concurrency(),
+        size_type capacity = 1024U,
+        size_type batch = default_batch)
+        requires std::is_same_v<R, Receiver<T, array_channel>>;
+
+    // Drains receiver until its channel is closed
+    worker_pool(receiver_type receiver,
+        handler_type handler,
+        size_type threads = std::thread::hardware_concurrency(),
+        size_type batch = default_batch);
+
+    ~worker_pool();
+
+    worker_pool(const worker_pool &) = delete;
+    worker_pool &operator=(const worker_pool &) = delete;
+
+    // Blocks while the pool's channel is full, returns ChannelClosed after close() or if the pool
+    // drains a receiver instead
+    [[nodiscard]] inline auto submit(const value_type &value) -> typename sender_type::result_type;
+    [[nodiscard]] inline auto submit(value_type &&value) -> typename sender_type::result_type;
+
+    // Closes the pool's own channel, the workers finish what was submitted and stop
+    inline auto close() -> void;
+    // Waits for the workers to stop
+    inline auto join() -> void;
+
+    [[nodiscard]] inline auto size() const noexcept -> size_type { return workers_.size(); }
+
+  private:
+    struct _worker
+    {
+        explicit _worker(const size_type capacity, receiver_type source)
+            : deque(capacity), receiver(std::move(source))
+        {}
+
+        _work_deque<value_type> deque;
+        receiver_type receiver;
+        // values of the last batch that didn't fit into the deque
+        std::vector<value_type> overflow;
+    };
+
+    // pushes received values straight into a worker's deque. It has room for a whole batch, but a
+    // slot a thief is still moving out of can't be reused yet, such a value is set aside. The
+    // handler can't run here, the channel may still be locked or have slots claimed for the batch.
+    struct _deque_inserter
+    {
+        using difference_type = std::ptrdiff_t;
+
+        _work_deque<value_type> *deque;
+        std::vector<value_type> *overflow;
+
+        inline auto operator*() -> _deque_inserter & { return *this; }
+        inline auto operator++() -> _deque_inserter & { return *this; }
+        inline auto operator++(int) -> _deque_inserter { return *this; }
+        inline auto operator=(value_type &&value) -> _deque_inserter &
+        {
+            if (!deque->push(std::move(value))) { overflow->push_back(std::move(value)); }
+            return *this;
+        }
+        inline auto operator=(const value_type &value) -> _deque_inserter &
+        {
+            if (!deque->push(value)) { overflow->push_back(value); }
+            return *this;
+        }
+    };
+
+    inline auto _start(receiver_type &receiver, size_type threads) -> void;
+    inline auto _run(size_type index) -> void;
+    [[nodiscard]] inline auto _steal(size_type thief) -> std::optional<value_type>;
+
+    // parks a worker that found no work until some turns up
+    inline auto _idle(size_type index) -> void;
+    // whether another worker has a backlog to steal from
+    [[nodiscard]] inline auto _backlog(size_type thief) const noexcept -> bool;
+    // links or unlinks the channel watch as the first worker parks and the last one wakes up
+    inline auto _watch(receiver_type &receiver, bool parking) -> void;
+    // must be called after work turned up, wakes one parked worker or all of them
+    inline auto _announce(bool everyone) noexcept -> void;
+    static inline auto _wake(void *context) noexcept -> bool;
+
+    handler_type handler_;
+    size_type batch_;
+    std::optional<sender_type> sender_;
+    std::vector<std::unique_ptr<_worker>> workers_;
+    std::vector<std::thread> threads_;
+
+    // bumped whenever work turns up, parked workers wait for it to move on
+    std::atomic<std::uint64_t> work_{ 0U };
+    _waiter_set idle_;
+
+    std::mutex watch_mutex_;
+    size_type parked_{ 0U };
+    _observer_list::node node_;
+};
+
+template<typename T, typename R>
+worker_pool<T, R>::worker_pool(handler_type handler, size_type threads, size_type capacity, size_type batch)
+    requires std::is_same_v<R, Receiver<T, array_channel>>
+    : handler_(std::move(handler)), batch_(std::max(batch, size_type{ 1U }))
+{
+    auto [sender, receiver] = bounded<T, array_channel>(capacity);
+    sender_.emplace(std::move(sender));
+    _start(receiver, threads);
+}
+
+template<typename T, typename R>
+worker_pool<T, R>::worker_pool(receiver_type receiver, handler_type handler, size_type threads, size_type batch)
+    : handler_(std::move(handler)), batch_(std::max(batch, size_type{ 1U }))
+{
+    _start(receiver, threads);
+}
+
+template<typename T, typename R>
+worker_pool<T, R>::~worker_pool()
+{
+    close();
+    join();
+}
+
+template<typename T, typename R>
+[[nodiscard]] inline auto worker_pool<T, R>::submit(const value_type &value) -> typename sender_type::result_type
+{
+    if (!sender_) { return std::unexpected(sender_error_t::ChannelClosed); }
+    return sender_->send(value);
+}
+
+template<typename T, typename R>
+[[nodiscard]] inline auto worker_pool<T, R>::submit(value_type &&value) -> typename sender_type::result_type
+{
+    if (!sender_) { return std::unexpected(sender_error_t::ChannelClosed); }
+    return sender_->send(std::move(value));
+}
+
+template<typename T, typename R>
+inline auto worker_pool<T, R>::close() -> void
+{
+    if (sender_) { sender_->close(); }
+}
+
+template<typename T, typename R>
+inline auto worker_pool<T, R>::join() -> void
+{
+    for (auto &thread : threads_) {
+        if (thread.joinable()) { thread.join(); }
+    }
+}
+
+template<typename T, typename R>
+inline auto worker_pool<T, R>::_start(receiver_type &receiver, const size_type threads) -> void
+{
+    const auto count = threads == 0U ? 1U : threads;
+
+    node_.wake = &_wake;
+    node_.context = this;
+
+    // every worker has its own copy of the receiver, they all share the channel
+    workers_.reserve(count);
+    for (size_type i = 0U; i < count; i++) {
+        workers_.push_back(std::make_unique<_worker>(batch_, receiver));
+        workers_.back()->overflow.reserve(batch_);
+    }
+
+    threads_.reserve(count);
+    for (size_type i = 0U; i < count; i++) {
+        threads_.emplace_back([this, i]() { _run(i); });
+    }
+}
+
+template<typename T, typename R>
+inline auto worker_pool<T, R>::_run(const size_type index) -> void
+{
+    auto &self = *workers_[index];
+    while (true) {
+        if (auto value = self.deque.pop()) {
+            handler_(std::move(*value));
+            continue;
+        }
+
+        if (auto value = _steal(index)) {
+            handler_(std::move(*value));
+            continue;
+        }
+
+        // the deque is empty, so a whole batch fits
+        const auto received = self.receiver.try_receive_many(_deque_inserter{ &self.deque, &self.overflow }, batch_);
+        if (received.has_value()) {
+            // parked workers can steal the rest of the batch
+            if (*received > 1U) { _announce(true); }
+
+            for (auto &value : self.overflow) { handler_(std::move(value)); }
+            self.overflow.clear();
+            continue;
+        }
+
+        if (received.error() == receiver_type::error_type::ChannelClosed) {
+            // the others finish their own backlog
+            if (auto value = _steal(index)) {
+                handler_(std::move(*value));
+                continue;
+            }
+
+            // a parked worker may not have seen the close yet
+            _announce(true);
+            return;
+        }
+
+        _idle(index);
+    }
+}
+
+template<typename T, typename R>
+inline auto worker_pool<T, R>::_idle(const size_type index) -> void
+{
+    auto &self = *workers_[index];
+
+    // read before the last look for work, anything that turns up after that moves it on
+    const auto seen = work_.load(std::memory_order_seq_cst);
+    _watch(self.receiver, true);
+
+    if (!self.receiver._ready() && !_backlog(index)) {
+        idle_.wait([this, seen]() { return work_.load(std::memory_order_seq_cst) != seen; });
+    }
+
+    _watch(self.receiver, false);
+}
+
+template<typename T, typename R>
+[[nodiscard]] inline auto worker_pool<T, R>::_backlog(const size_type thief) const noexcept -> bool
+{
+    for (size_type i = 1U; i < workers_.size(); i++) {
+        if (!workers_[(thief + i) % workers_.size()]->deque.empty()) { return true; }
+    }
+    return false;
+}
+
+template<typename T, typename R>
+inline auto worker_pool<T, R>::_watch(receiver_type &receiver, const bool parking) -> void
+{
+    // every receiver shares the channel, so any of them can watch it for the pool
+    std::lock_guard lock{ watch_mutex_ };
+    if (parking) {
+        if (parked_++ == 0U) { receiver._watch(node_); }
+    } else {
+        if (--parked_ == 0U) { receiver._unwatch(node_); }
+    }
+}
+
+template<typename T, typename R>
+inline auto worker_pool<T, R>::_announce(const bool everyone) noexcept -> void
+{
+    work_.fetch_add(1U, std::memory_order_seq_cst);
+    if (everyone) {
+        idle_.notify_all();
+    } else {
+        idle_.notify_one();
+    }
+}
+
+template<typename T, typename R>
+inline auto worker_pool<T, R>::_wake(void *context) noexcept -> bool
+{
+    // a worker pulls in a whole batch and wakes the others if there is more than one value
+    static_cast<worker_pool *>(context)->_announce(false);
+    return false;
+}
+
+template<typename T, typename R>
+[[nodiscard]] inline auto worker_pool<T, R>::_steal(const size_type thief) -> std::optional<value_type>
+{
+    for (size_type i = 1U; i < workers_.size(); i++) {
+        if (auto value = workers_[(thief + i) % workers_.size()]->deque.steal()) { return value; }
+    }
+    return std::nullopt;
+}
+
+}// namespace nrws
@@ -0,0 +1,139 @@
+#include "narrows/bounded.hpp"
+#include "narrows/single_bounded.hpp"
+#include "narrows/unbounded.hpp"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <thread>
+
+namespace {
+
+// Forwards to the default resource and counts what goes through it
+class counting_resource : public std::pmr::memory_resource
+{
+  public:
+    std::atomic<std::size_t> allocations{ 0U };
+    std::atomic<std::size_t> deallocations{ 0U };
+
+  private:
+    auto do_allocate(std::size_t bytes, std::size_t alignment) -> void * override
+    {
+        allocations++;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    auto do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment) -> void override
+    {
+        deallocations++;
+        std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+    }
+
+    auto do_is_equal(const std::pmr::memory_resource &other) const noexcept -> bool override { return this == &other; }
+};
+
+}// namespace
+
+template<typename Channel>
+class Allocator : public ::testing::Test
+{
+};
+
+using PmrChannels = ::testing::Types<nrws::pmr::bounded_channel<std::string>,
+    nrws::pmr::array_channel<std::string>,
+    nrws::_spsc_ring<std::string, nrws::park_wait, std::pmr::polymorphic_allocator<std::string>>>;
+TYPED_TEST_SUITE(Allocator, PmrChannels);
+
+TYPED_TEST(Allocator, StorageComesFromResource)
+{
+    counting_resource resource;
+
+    {
+        TypeParam ch(8, &resource);
+        EXPECT_EQ(resource.allocations.load(), 1U);
+
+        ch.push(std::string("a"));
+        EXPECT_EQ(ch.pop().value(), "a");
+    }
+
+    EXPECT_EQ(resource.deallocations.load(), resource.allocations.load());
+}
+
+TEST(Allocator, ListChannelRecyclesBlocks)
+{
+    counting_resource resource;
+
+    {
+        nrws::pmr::list_channel<int> ch(4U, &resource);
+
+        // the first burst allocates, after that the pool covers bursts of up to 4 blocks
+        for (int i = 0; i < 100; i++) { ch.push(i); }
+        for (int i = 0; i < 100; i++) { EXPECT_EQ(ch.pop().value(), i); }
+        EXPECT_LE(ch.pooled_blocks(), 4U);
+
+        const auto warm = resource.allocations.load();
+        for (int burst = 0; burst < 10; burst++) {
+            for (int i = 0; i < 90; i++) { ch.push(i); }
+            for (int i = 0; i < 90; i++) { EXPECT_EQ(ch.pop().value(), i); }
+        }
+        EXPECT_EQ(resource.allocations.load(), warm);
+    }
+
+    EXPECT_EQ(resource.deallocations.load(), resource.allocations.load());
+}
+
+TEST(Allocator, ListChannelRetentionCap)
+{
+    nrws::list_channel<int> ch(2U);
+
+    for (int i = 0; i < 1000; i++) { ch.push(i); }
+    for (int i = 0; i < 1000; i++) { EXPECT_EQ(ch.pop().value(), i); }
+    EXPECT_EQ(ch.pooled_blocks(), 2U);
+}
+
+TEST(Allocator, ListChannelThreads)
+{
+    constexpr static int max = 20000;
+
+    counting_resource resource;
+
+    {
+        nrws::pmr::list_channel<int> ch(&resource);
+
+        std::thread producer([&ch]() {
+            for (int i = 0; i < max; i++) { ch.push(i); }
+            ch.close();
+        });
+
+        int expected = 0;
+        for (const auto actual : ch) {
+            EXPECT_EQ(actual, expected);
+            expected++;
+        }
+        EXPECT_EQ(expected, max);
+
+        producer.join();
+    }
+
+    EXPECT_EQ(resource.deallocations.load(), resource.allocations.load());
+}
+
+TEST(Allocator, FactoriesForwardAllocator)
+{
+    counting_resource resource;
+
+    {
+        auto [s, r] = nrws::bounded<int, nrws::pmr::array_channel>(16U, &resource);
+        EXPECT_TRUE(s.send(1).has_value());
+        EXPECT_EQ(r.receive().value(), 1);
+
+        auto [us, ur] = nrws::unbounded<int, nrws::pmr::list_channel>(&resource);
+        EXPECT_TRUE(us.send(2).has_value());
+        EXPECT_EQ(ur.receive().value(), 2);
+    }
+
+    EXPECT_EQ(resource.allocations.load(), 2U);
+    EXPECT_EQ(resource.deallocations.load(), resource.allocations.load());
+}
@@ -0,0 +1,168 @@
+#include "narrows/bounded.hpp"
+#include "narrows/single_bounded.hpp"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(ArrayChannel, IntConstruction)
+{
+    using namespace nrws;
+
+    array_channel<int> ch(15);
+    EXPECT_EQ(ch.size(), 0);
+    EXPECT_EQ(ch.capacity(), 15);
+    EXPECT_FALSE(ch.closed());
+}
+
+TEST(ArrayChannel, ZeroCapacityHoldsOne)
+{
+    using namespace nrws;
+
+    // there is no rendezvous mode, a zero capacity is rounded up to a single slot
+    array_channel<int> ch(0);
+    EXPECT_EQ(ch.capacity(), 1);
+
+    EXPECT_TRUE(ch.push(3));
+    EXPECT_TRUE(ch.full());
+    EXPECT_EQ(ch.pop(), std::optional<int>(3));
+    EXPECT_TRUE(ch.empty());
+}
+
+TEST(ArrayChannel, IntPushPop)
+{
+    using namespace nrws;
+
+    array_channel<int> ch(2);
+    EXPECT_TRUE(ch.push(1));
+    EXPECT_TRUE(ch.push(2));
+    EXPECT_EQ(ch.size(), 2);
+    EXPECT_TRUE(ch.full());
+
+    const auto _1 = ch.pop();
+    ASSERT_TRUE(_1.has_value());
+    EXPECT_EQ(_1.value(), 1);
+
+    // wrap around the ring a few times
+    for (int i = 3; i < 10; i++) {
+        EXPECT_TRUE(ch.push(i));
+        const auto value = ch.pop();
+        ASSERT_TRUE(value.has_value());
+        EXPECT_EQ(value.value(), i - 1);
+    }
+}
+
+TEST(ArrayChannel, IntClose)
+{
+    using namespace nrws;
+
+    array_channel<int> ch(15);
+    ch.push(1);
+    ch.push(2);
+    ch.close();
+
+    EXPECT_TRUE(ch.closed());
+    EXPECT_FALSE(ch.push(3));
+
+    EXPECT_EQ(ch.pop().value(), 1);
+    EXPECT_EQ(ch.pop().value(), 2);
+    EXPECT_FALSE(ch.pop().has_value());
+}
+
+TEST(ArrayChannel, StringNotReceivedIsDestroyed)
+{
+    using namespace nrws;
+
+    array_channel<std::string> ch(4);
+    ch.push(std::string(64, 'a'));
+    ch.push(std::string(64, 'b'));
+    EXPECT_EQ(ch.pop().value(), std::string(64, 'a'));
+}
+
+TEST(ArrayChannel, IntIterMultipleWriteReadThreads)
+{
+    using namespace nrws;
+
+    constexpr static int max = 20000;
+    constexpr static int producers = 4;
+    constexpr static int consumers = 4;
+
+    array_channel<int> ch(16);
+    std::atomic<long long> sum{ 0 };
+    std::atomic<int> count{ 0 };
+
+    std::vector<std::thread> producer_threads;
+    for (int p = 0; p < producers; p++) {
+        producer_threads.emplace_back([&ch]() {
+            for (int i = 1; i <= max; i++) { ch.push(i); }
+        });
+    }
+
+    std::vector<std::thread> consumer_threads;
+    for (int c = 0; c < consumers; c++) {
+        consumer_threads.emplace_back([&ch, &sum, &count]() {
+            for (const auto value : ch) {
+                sum += value;
+                count++;
+            }
+        });
+    }
+
+    for (auto &t : producer_threads) { t.join(); }
+    ch.close();
+    for (auto &t : consumer_threads) { t.join(); }
+
+    EXPECT_EQ(count.load(), producers * max);
+    EXPECT_EQ(sum.load(), static_cast<long long>(producers) * max * (max + 1) / 2);
+}
+
+TEST(ArrayChannel, SenderReceiver)
+{
+    using namespace nrws;
+
+    constexpr int max = 1000;
+
+    auto [s, r] = bounded<int, array_channel>(8U);
+
+    std::thread producer([&s]() {
+        for (int i = 0; i < max; i++) { EXPECT_TRUE(s.send(i).has_value()); }
+        s.close();
+    });
+
+    int expected = 0;
+    for (const auto actual : r) {
+        EXPECT_EQ(actual, expected);
+        expected++;
+    }
+    EXPECT_EQ(expected, max);
+
+    producer.join();
+
+    const auto status = s.send(max);
+    ASSERT_FALSE(status.has_value());
+    EXPECT_EQ(status.error(), sender_error_t::ChannelClosed);
+}
+
+TEST(ArrayChannel, CapacityOne)
+{
+    using namespace nrws;
+
+    array_channel<int> ch(1);
+
+    for (int i = 0; i < 4; i++) {
+        EXPECT_TRUE(ch.push(2 * i));
+        EXPECT_TRUE(ch.full());
+
+        // the written slot must not look free for the next lap, so this push has to wait
+        std::thread producer([&ch, i]() { EXPECT_TRUE(ch.push(2 * i + 1)); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+        EXPECT_EQ(ch.pop(), std::optional<int>(2 * i));
+        producer.join();
+        EXPECT_EQ(ch.pop(), std::optional<int>(2 * i + 1));
+    }
+}
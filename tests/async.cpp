@@ -0,0 +1,236 @@
+#include "narrows/bounded.hpp"
+#include "narrows/executor.hpp"
+#include "narrows/single_bounded.hpp"
+#include "narrows/unbounded.hpp"
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <span>
+#include <thread>
+#include <vector>
+
+// Fire and forget coroutine, starts right away and cleans up after itself
+struct detached
+{
+    struct promise_type
+    {
+        auto get_return_object() noexcept -> detached { return {}; }
+        auto initial_suspend() noexcept -> std::suspend_never { return {}; }
+        auto final_suspend() noexcept -> std::suspend_never { return {}; }
+        auto return_void() noexcept -> void {}
+        auto unhandled_exception() noexcept -> void { std::terminate(); }
+    };
+};
+
+// Coroutine that stays around until its owner destroys it, suspended or not
+struct owned
+{
+    struct promise_type
+    {
+        auto get_return_object() noexcept -> owned
+        {
+            return owned{ std::coroutine_handle<promise_type>::from_promise(*this) };
+        }
+        auto initial_suspend() noexcept -> std::suspend_never { return {}; }
+        auto final_suspend() noexcept -> std::suspend_always { return {}; }
+        auto return_void() noexcept -> void {}
+        auto unhandled_exception() noexcept -> void { std::terminate(); }
+    };
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+template<typename R, typename Executor>
+auto receive_one(R &receiver, Executor &executor, std::atomic<int> &finished) -> owned
+{
+    const auto value = co_await receiver.async_receive(executor);
+    if (value.has_value()) { finished.fetch_add(1); }
+}
+
+template<typename R, typename Executor>
+auto sum_all(R &receiver, Executor &executor, std::atomic<long long> &sum, std::atomic<int> &finished) -> detached
+{
+    while (true) {
+        const auto value = co_await receiver.async_receive(executor);
+        if (!value.has_value()) { break; }
+        sum.fetch_add(value.value());
+    }
+    finished.fetch_add(1);
+}
+
+template<typename S, typename Executor>
+auto send_range(S &sender, Executor &executor, int first, int last, std::atomic<int> &finished) -> detached
+{
+    for (int i = first; i < last; i++) {
+        const auto sent = co_await sender.async_send(i, executor);
+        EXPECT_TRUE(sent.has_value());
+    }
+    finished.fetch_add(1);
+}
+
+TEST(Async, ReceiveResumesOnTheRunLoop)
+{
+    using namespace nrws;
+
+    run_loop loop;
+    auto [s, r] = bounded<int>(4U);
+
+    std::atomic<long long> sum{ 0 };
+    std::atomic<int> finished{ 0 };
+    sum_all(r, loop, sum, finished);
+
+    // nothing was sent yet, so the coroutine is suspended without holding a thread
+    EXPECT_EQ(finished.load(), 0);
+
+    std::thread producer([&s]() {
+        for (int i = 1; i <= 100; i++) { EXPECT_TRUE(s.send(i).has_value()); }
+        s.close();
+    });
+
+    while (finished.load() == 0) { loop.poll(); }
+    producer.join();
+
+    EXPECT_EQ(sum.load(), 5050);
+}
+
+TEST(Async, SendWaitsForRoom)
+{
+    using namespace nrws;
+
+    run_loop loop;
+    auto [s, r] = bounded<int, array_channel>(1U);
+
+    std::atomic<int> finished{ 0 };
+    send_range(s, loop, 0, 3, finished);
+    EXPECT_EQ(finished.load(), 0);
+
+    for (int i = 0; i < 3; i++) {
+        while (true) {
+            const auto value = r.try_receive();
+            if (value.has_value()) {
+                EXPECT_EQ(value.value(), i);
+                break;
+            }
+            loop.poll();
+        }
+    }
+
+    while (finished.load() == 0) { loop.poll(); }
+}
+
+TEST(Async, ManyFlowsOnOneThread)
+{
+    using namespace nrws;
+
+    constexpr static int flows = 1000;
+    constexpr static int per_flow = 20;
+
+    run_loop loop;
+    auto [s, r] = bounded<int>(8U);
+
+    // every flow is a coroutine, all of them are driven by this thread alone
+    std::atomic<long long> sum{ 0 };
+    std::atomic<int> senders_finished{ 0 };
+    std::atomic<int> receivers_finished{ 0 };
+    for (int i = 0; i < flows; i++) { send_range(s, loop, 0, per_flow, senders_finished); }
+    for (int i = 0; i < 4; i++) { sum_all(r, loop, sum, receivers_finished); }
+
+    while (senders_finished.load() != flows) { loop.poll(); }
+    s.close();
+    while (receivers_finished.load() != 4) { loop.poll(); }
+
+    EXPECT_EQ(sum.load(), static_cast<long long>(flows) * per_flow * (per_flow - 1) / 2);
+}
+
+TEST(Async, ThreadPool)
+{
+    using namespace nrws;
+
+    constexpr static int producers = 8;
+    constexpr static int per_producer = 2000;
+
+    std::atomic<long long> sum{ 0 };
+    std::atomic<int> senders_finished{ 0 };
+    std::atomic<int> receivers_finished{ 0 };
+
+    auto [bs, br] = bounded<int, array_channel>(4U);
+    {
+        thread_pool pool(4U);
+        for (int i = 0; i < producers; i++) { send_range(bs, pool, 0, per_producer, senders_finished); }
+        for (int i = 0; i < 2; i++) { sum_all(br, pool, sum, receivers_finished); }
+
+        while (senders_finished.load() != producers) { std::this_thread::yield(); }
+        bs.close();
+        while (receivers_finished.load() != 2) { std::this_thread::yield(); }
+    }
+
+    EXPECT_EQ(sum.load(), static_cast<long long>(producers) * per_producer * (per_producer - 1) / 2);
+}
+
+TEST(Async, ClosedChannelResumes)
+{
+    using namespace nrws;
+
+    run_loop loop;
+    auto [s, r] = unbounded<int>();
+
+    std::atomic<long long> sum{ 0 };
+    std::atomic<int> finished{ 0 };
+    sum_all(r, loop, sum, finished);
+
+    s.close();
+    while (finished.load() == 0) { loop.poll(); }
+    EXPECT_EQ(sum.load(), 0);
+}
+
+TEST(Async, DestroyedWhileSuspended)
+{
+    using namespace nrws;
+
+    run_loop loop;
+    auto [s, r] = bounded<int>(4U);
+
+    std::atomic<int> finished{ 0 };
+    auto flow = receive_one(r, loop, finished);
+    EXPECT_FALSE(flow.handle.done());
+
+    // the frame goes away with the coroutine still waiting, the channel must forget about it
+    flow.handle.destroy();
+
+    EXPECT_TRUE(s.send(1).has_value());
+    EXPECT_EQ(loop.poll(), 0U);
+    EXPECT_EQ(finished.load(), 0);
+    EXPECT_EQ(r.try_receive(), 1);
+}
+
+TEST(Async, SendWakesOneCoroutinePerValue)
+{
+    using namespace nrws;
+
+    constexpr static int flows = 1000;
+
+    run_loop loop;
+    auto [s, r] = bounded<int>(8U);
+
+    std::atomic<int> finished{ 0 };
+    std::vector<owned> waiting;
+    for (int i = 0; i < flows; i++) { waiting.push_back(receive_one(r, loop, finished)); }
+
+    // a single value only gets a single attempt posted, not one per waiting coroutine
+    EXPECT_TRUE(s.send(1).has_value());
+    EXPECT_EQ(loop.poll(), 1U);
+    EXPECT_EQ(finished.load(), 1);
+
+    std::array values{ 2, 3, 4 };
+    EXPECT_TRUE(s.send_many(std::span{ values }).has_value());
+    EXPECT_EQ(loop.poll(), 3U);
+    EXPECT_EQ(finished.load(), 4);
+
+    // closing wakes everybody that is left
+    s.close();
+    while (loop.poll() != 0U) {}
+    for (auto &flow : waiting) { flow.handle.destroy(); }
+}
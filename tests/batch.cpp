@@ -0,0 +1,210 @@
+#include "narrows/bounded.hpp"
+#include "narrows/single_bounded.hpp"
+#include "narrows/unbounded.hpp"
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iterator>
+#include <numeric>
+#include <ranges>
+#include <string>
+#include <thread>
+#include <vector>
+
+template<typename Channel>
+class Batch : public ::testing::Test
+{
+};
+
+using BatchChannels = ::testing::Types<nrws::bounded_channel<int>, nrws::array_channel<int>, nrws::_spsc_ring<int>>;
+TYPED_TEST_SUITE(Batch, BatchChannels);
+
+TYPED_TEST(Batch, PushManyPopManyWrapAround)
+{
+    TypeParam ch(5);
+
+    // move the head and tail past the end of the ring first
+    std::vector<int> values{ 1, 2, 3 };
+    EXPECT_EQ(ch.push_many(values.begin(), values.end()), 3U);
+
+    std::vector<int> received;
+    EXPECT_EQ(ch.pop_many(std::back_inserter(received), 8U), 3U);
+    EXPECT_EQ(received, values);
+
+    // this batch is split across the end of the ring
+    values = { 4, 5, 6, 7, 8 };
+    EXPECT_EQ(ch.push_many(values.begin(), values.end()), 5U);
+    EXPECT_TRUE(ch.full());
+
+    received.clear();
+    EXPECT_EQ(ch.pop_many(std::back_inserter(received), 2U), 2U);
+    EXPECT_EQ(ch.pop_many(std::back_inserter(received), 8U), 3U);
+    EXPECT_EQ(received, values);
+}
+
+TYPED_TEST(Batch, PushManyBlocksUntilEverythingIsSent)
+{
+    constexpr static int max = 10000;
+    constexpr static std::size_t batch_size = 64U;
+
+    TypeParam ch(16);
+
+    std::thread producer([&ch]() {
+        std::vector<int> values(max);
+        std::iota(values.begin(), values.end(), 0);
+        EXPECT_EQ(ch.push_many(values.begin(), values.end()), static_cast<std::size_t>(max));
+        ch.close();
+    });
+
+    int expected = 0;
+    for (const auto actual : ch.batched(batch_size)) {
+        EXPECT_EQ(actual, expected);
+        expected++;
+    }
+    EXPECT_EQ(expected, max);
+
+    producer.join();
+}
+
+TYPED_TEST(Batch, PopManyUntilTimesOut)
+{
+    TypeParam ch(4);
+
+    std::vector<int> received;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(10);
+    EXPECT_EQ(ch.pop_many_until(std::back_inserter(received), 4U, deadline), 0U);
+    EXPECT_TRUE(received.empty());
+}
+
+TEST(Batch, UnboundedPushManyPopMany)
+{
+    nrws::channel<std::string> ch;
+
+    const std::vector<std::string> values{ "a", "b", "c" };
+    EXPECT_EQ(ch.push_many(values.begin(), values.end()), 3U);
+    ch.close();
+
+    std::vector<std::string> received;
+    EXPECT_EQ(ch.pop_many(std::back_inserter(received), 2U), 2U);
+    EXPECT_EQ(ch.pop_many(std::back_inserter(received), 2U), 1U);
+    EXPECT_EQ(ch.pop_many(std::back_inserter(received), 2U), 0U);
+    EXPECT_EQ(received, values);
+}
+
+TEST(Batch, SenderReceiver)
+{
+    using namespace nrws;
+
+    constexpr static int max = 10000;
+
+    auto [s, r] = bounded<int, array_channel>(256U);
+
+    std::thread producer([&s]() {
+        std::vector<int> values(max);
+        std::iota(values.begin(), values.end(), 0);
+
+        const auto sent = s.send_many(std::span<int>(values));
+        ASSERT_TRUE(sent.has_value());
+        EXPECT_EQ(sent.value(), static_cast<std::size_t>(max));
+        s.close();
+    });
+
+    std::vector<int> received;
+    while (true) {
+        const auto count = r.receive_many(std::back_inserter(received), 128U);
+        if (!count.has_value()) {
+            EXPECT_EQ(count.error(), receiver_error_t::ChannelClosed);
+            break;
+        }
+        EXPECT_GT(count.value(), 0U);
+        EXPECT_LE(count.value(), 128U);
+    }
+
+    producer.join();
+
+    ASSERT_EQ(received.size(), static_cast<std::size_t>(max));
+    for (int i = 0; i < max; i++) { EXPECT_EQ(received[static_cast<std::size_t>(i)], i); }
+}
+
+TEST(Batch, SenderCopiesUnlessAskedToMove)
+{
+    using namespace nrws;
+
+    auto [s, r] = bounded<std::string>(8U);
+
+    // lvalue containers and views of them are left alone
+    std::vector<std::string> kept{ std::string(64, 'a') };
+    EXPECT_EQ(s.send_many(kept).value(), 1U);
+    EXPECT_EQ(kept[0], std::string(64, 'a'));
+    EXPECT_EQ(s.send_many(std::span<std::string>(kept)).value(), 1U);
+    EXPECT_EQ(kept[0], std::string(64, 'a'));
+
+    const std::vector<std::string> copied{ std::string(64, 'b') };
+    EXPECT_EQ(s.send_many(copied).value(), 1U);
+    EXPECT_EQ(copied[0], std::string(64, 'b'));
+
+    // moving has to be asked for
+    std::vector<std::string> moved{ std::string(64, 'c'), std::string(64, 'd') };
+    EXPECT_EQ(s.send_many(std::make_move_iterator(moved.begin()), std::make_move_iterator(moved.end())).value(), 2U);
+    EXPECT_TRUE(moved[0].empty());
+    EXPECT_EQ(s.send_many(std::vector<std::string>{ std::string(64, 'e') }).value(), 1U);
+    s.close();
+
+    std::vector<std::string> received;
+    for (const auto &value : r.batched(2U)) { received.push_back(value); }
+    EXPECT_EQ(received,
+        (std::vector<std::string>{ std::string(64, 'a'),
+            std::string(64, 'a'),
+            std::string(64, 'b'),
+            std::string(64, 'c'),
+            std::string(64, 'd'),
+            std::string(64, 'e') }));
+
+    const auto status = s.send_many(copied);
+    ASSERT_FALSE(status.has_value());
+    EXPECT_EQ(status.error(), sender_error_t::ChannelClosed);
+}
+
+TEST(Batch, CloseAfterTheLastValueStillSucceeds)
+{
+    using namespace nrws;
+
+    auto [s, r] = bounded<int>(8U);
+
+    // the filter finds the end of this unsized range only after the last value went out, and
+    // closes the channel on the way there
+    const std::vector<int> values{ 1, 2, 3, 0 };
+    auto sent_then_closed = values | std::views::filter([&s](const int value) {
+        if (value == 0) { s.close(); }
+        return value != 0;
+    });
+
+    EXPECT_EQ(s.send_many(sent_then_closed).value(), 3U);
+
+    std::vector<int> received;
+    for (const auto value : r) { received.push_back(value); }
+    EXPECT_EQ(received, (std::vector<int>{ 1, 2, 3 }));
+}
+
+TEST(Batch, ReceiverTimeout)
+{
+    using namespace nrws;
+
+    auto [s, r] = bounded<int>(8U);
+
+    std::vector<int> received;
+    const auto timed_out = r.receive_many(std::back_inserter(received), 8U, std::chrono::milliseconds(10));
+    ASSERT_FALSE(timed_out.has_value());
+    EXPECT_EQ(timed_out.error(), receiver_error_t::Timeout);
+
+    EXPECT_TRUE(s.send(1).has_value());
+    s.close();
+
+    const auto count = r.receive_many(std::back_inserter(received), 8U, std::chrono::milliseconds(10));
+    ASSERT_TRUE(count.has_value());
+    EXPECT_EQ(count.value(), 1U);
+
+    const auto closed = r.receive_many(std::back_inserter(received), 8U, std::chrono::milliseconds(10));
+    ASSERT_FALSE(closed.has_value());
+    EXPECT_EQ(closed.error(), receiver_error_t::ChannelClosed);
+}
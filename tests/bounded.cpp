@@ -1,8 +1,28 @@
 #include "narrows/bounded.hpp"
 #include <gtest/gtest.h>
 
+#include <memory>
 #include <thread>
 
+namespace {
+
+// Counts live instances, and can't be default constructed
+struct tracked
+{
+    static inline int alive{ 0 };
+
+    int value;
+
+    explicit tracked(const int v) : value(v) { alive++; }
+    tracked(const tracked &other) : value(other.value) { alive++; }
+    tracked(tracked &&other) noexcept : value(other.value) { alive++; }
+    tracked &operator=(const tracked &) = default;
+    tracked &operator=(tracked &&) noexcept = default;
+    ~tracked() { alive--; }
+};
+
+}// namespace
+
 TEST(Bounded, IntConstruction)
 {
     using namespace nrws;
@@ -185,3 +205,41 @@ TEST(Bounded, IntIterMulipleReadThreads)
 
     EXPECT_EQ((sum_c_1 + sum_c_2), sum_p);
 }
+
+TEST(Bounded, StorageIsUninitialized)
+{
+    using namespace nrws;
+
+    {
+        bounded_channel<tracked> ch(1000);
+        EXPECT_EQ(tracked::alive, 0);
+
+        ch.emplace(1);
+        ch.emplace(2);
+        ch.emplace(3);
+        EXPECT_EQ(tracked::alive, 3);
+
+        const auto value = ch.pop();
+        ASSERT_TRUE(value.has_value());
+        EXPECT_EQ(value->value, 1);
+        EXPECT_EQ(tracked::alive, 3);
+    }
+
+    // values that were never received are destroyed with the channel
+    EXPECT_EQ(tracked::alive, 0);
+}
+
+TEST(Bounded, MoveOnlyValues)
+{
+    using namespace nrws;
+
+    bounded_channel<std::unique_ptr<int>> ch(2);
+
+    // wrap around the ring a few times
+    for (int i = 0; i < 10; i++) {
+        EXPECT_TRUE(ch.push(std::make_unique<int>(i)));
+        const auto value = ch.pop();
+        ASSERT_TRUE(value.has_value());
+        EXPECT_EQ(**value, i);
+    }
+}
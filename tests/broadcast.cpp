@@ -0,0 +1,210 @@
+#include "narrows/broadcast.hpp"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+TEST(Broadcast, EverySubscriberSeesEverything)
+{
+    using namespace nrws;
+
+    constexpr static int max = 10'000;
+    constexpr static int subscribers = 3;
+
+    auto s = broadcast<int>(64);
+
+    std::vector<broadcast_receiver<int>> receivers;
+    for (int i = 0; i < subscribers; i++) { receivers.push_back(s.subscribe()); }
+    EXPECT_EQ(s.subscribers(), 3U);
+
+    std::vector<long long> sums(subscribers, 0);
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0U; i < receivers.size(); i++) {
+        threads.emplace_back([&receiver = receivers[i], &sum = sums[i]]() {
+            int expected = 0;
+            while (const auto value = receiver.receive()) {
+                // in order, nothing skipped
+                EXPECT_EQ(*value, expected++);
+                sum += *value;
+            }
+            EXPECT_EQ(expected, max);
+        });
+    }
+
+    for (int i = 0; i < max; i++) { EXPECT_TRUE(s.send(i).has_value()); }
+    s.close();
+    for (auto &thread : threads) { thread.join(); }
+
+    for (const auto sum : sums) { EXPECT_EQ(sum, static_cast<long long>(max) * (max - 1) / 2); }
+}
+
+TEST(Broadcast, ManyProducers)
+{
+    using namespace nrws;
+
+    constexpr static int producers = 4;
+    constexpr static int per_producer = 2'000;
+
+    auto s = broadcast<int>(16);
+    auto first = s.subscribe();
+    auto second = s.subscribe();
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([s]() mutable {
+            for (int i = 1; i <= per_producer; i++) { EXPECT_TRUE(s.send(i).has_value()); }
+        });
+    }
+
+    long long sum_first = 0;
+    long long sum_second = 0;
+    std::thread other([&]() {
+        for (int i = 0; i < producers * per_producer; i++) { sum_second += second.receive().value(); }
+    });
+    for (int i = 0; i < producers * per_producer; i++) { sum_first += first.receive().value(); }
+
+    for (auto &thread : threads) { thread.join(); }
+    other.join();
+
+    const auto expected = static_cast<long long>(producers) * per_producer * (per_producer + 1) / 2;
+    EXPECT_EQ(sum_first, expected);
+    EXPECT_EQ(sum_second, expected);
+}
+
+TEST(Broadcast, SlowestSubscriberGatesTheProducer)
+{
+    using namespace nrws;
+
+    auto s = broadcast<std::string>(4);
+
+    // nobody listening, nothing to wait for
+    for (int i = 0; i < 10; i++) { EXPECT_TRUE(s.try_send("dropped").has_value()); }
+
+    auto fast = s.subscribe();
+    auto slow = s.subscribe();
+    for (int i = 0; i < 4; i++) { EXPECT_TRUE(s.try_send(std::to_string(i)).has_value()); }
+    EXPECT_EQ(s.try_send("full").error(), sender_error_t::ChannelFull);
+
+    // the fast subscriber reading doesn't help, the slow one still holds the ring
+    for (int i = 0; i < 4; i++) { EXPECT_EQ(fast.receive().value(), std::to_string(i)); }
+    EXPECT_EQ(fast.try_receive().error(), receiver_error_t::ChannelEmpty);
+    EXPECT_EQ(s.send_for("late", 1ms).error(), sender_error_t::Timeout);
+
+    EXPECT_EQ(slow.receive().value(), "0");
+    EXPECT_TRUE(s.try_send("4").has_value());
+    EXPECT_EQ(fast.receive().value(), "4");
+}
+
+TEST(Broadcast, JoinAndLeaveAtRuntime)
+{
+    using namespace nrws;
+
+    auto s = broadcast<int>(2);
+    auto early = s.subscribe();
+    EXPECT_TRUE(s.send(1).has_value());
+
+    auto late = s.subscribe();
+    EXPECT_TRUE(s.send(2).has_value());
+    EXPECT_EQ(late.receive().value(), 2);
+    EXPECT_EQ(late.try_receive().error(), receiver_error_t::ChannelEmpty);
+
+    // early never reads, so the producer waits until it leaves
+    std::thread producer([s]() mutable { EXPECT_TRUE(s.send(3).has_value()); });
+    std::this_thread::sleep_for(2ms);
+    { auto leaving = std::move(early); }
+    producer.join();
+
+    EXPECT_EQ(s.subscribers(), 1U);
+    EXPECT_EQ(late.receive().value(), 3);
+
+    s.close();
+    EXPECT_EQ(late.receive().error(), receiver_error_t::ChannelClosed);
+}
+
+TEST(Broadcast, LaggingSubscriberIsDropped)
+{
+    using namespace nrws;
+
+    auto s = broadcast<int, lag_policy::drop>(4);
+    auto keeping_up = s.subscribe();
+    auto lagging = s.subscribe();
+
+    for (int i = 0; i < 100; i++) {
+        EXPECT_TRUE(s.try_send(i).has_value());
+        EXPECT_EQ(keeping_up.receive().value(), i);
+    }
+
+    EXPECT_EQ(lagging.receive().error(), receiver_error_t::Lagged);
+    EXPECT_EQ(s.subscribers(), 1U);
+}
+
+TEST(Broadcast, DroppingRacesWithReading)
+{
+    using namespace nrws;
+
+    constexpr static int max = 20'000;
+
+    auto s = broadcast<std::string, lag_policy::drop>(8);
+    auto receiver = s.subscribe();
+
+    std::thread consumer([&receiver]() {
+        int last = -1;
+        while (const auto value = receiver.receive()) {
+            // whatever was read was read whole and in order
+            const auto current = std::stoi(*value);
+            EXPECT_GT(current, last);
+            last = current;
+        }
+        EXPECT_TRUE(receiver.receive().error() == receiver_error_t::Lagged
+                    || receiver.receive().error() == receiver_error_t::ChannelClosed);
+    });
+
+    for (int i = 0; i < max; i++) {
+        EXPECT_TRUE(s.send(std::to_string(i) + " padding past the small string buffer").has_value());
+    }
+    s.close();
+    consumer.join();
+}
+
+namespace {
+
+// copies slowly, so a producer lapping the ring catches a subscriber in the middle of a read
+struct slow_copy
+{
+    explicit slow_copy(const int v) : value(std::to_string(v) + " padding past the small string buffer") {}
+    slow_copy(const slow_copy &other) : value((std::this_thread::sleep_for(std::chrono::milliseconds(50)), other.value))
+    {}
+    slow_copy(slow_copy &&) noexcept = default;
+    slow_copy &operator=(const slow_copy &) = default;
+    slow_copy &operator=(slow_copy &&) noexcept = default;
+
+    std::string value;
+};
+
+}// namespace
+
+TEST(Broadcast, DroppingWaitsForBusySubscriber)
+{
+    using namespace nrws;
+
+    auto s = broadcast<slow_copy, lag_policy::drop>(1);
+    auto receiver = s.subscribe();
+    EXPECT_TRUE(s.send(slow_copy(1)).has_value());
+
+    std::atomic<bool> reading{ false };
+    std::thread consumer([&receiver, &reading]() {
+        reading = true;
+        // the value being copied is never overwritten underneath
+        EXPECT_EQ(receiver.receive().value().value, slow_copy(1).value);
+    });
+    while (!reading) { std::this_thread::yield(); }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    EXPECT_TRUE(s.send(slow_copy(2)).has_value());
+    consumer.join();
+}
@@ -0,0 +1,155 @@
+#include "narrows/conversation.hpp"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+// counts how a value got from the sender to the receiver
+struct packet
+{
+    static inline std::atomic<int> copies{ 0 };
+    static inline std::atomic<int> moves{ 0 };
+
+    int id{ 0 };
+
+    explicit packet(int value) : id(value) {}
+    packet(const packet &other) : id(other.id) { copies++; }
+    packet(packet &&other) noexcept : id(other.id) { moves++; }
+    packet &operator=(const packet &) = delete;
+    packet &operator=(packet &&) = delete;
+};
+
+}// namespace
+
+template<typename Wait>
+class Conversation : public ::testing::Test
+{
+};
+
+using ConversationPolicies = ::testing::Types<nrws::spin_wait, nrws::yield_wait, nrws::park_wait>;
+TYPED_TEST_SUITE(Conversation, ConversationPolicies);
+
+TYPED_TEST(Conversation, SendCompletesOnlyWhenReceived)
+{
+    nrws::conversation<int, TypeParam> conversation;
+
+    std::atomic<bool> sent{ false };
+    std::thread sender([&]() {
+        EXPECT_TRUE(conversation.push(42));
+        sent.store(true);
+    });
+
+    std::this_thread::sleep_for(5ms);
+    EXPECT_FALSE(sent.load());
+
+    EXPECT_EQ(conversation.pop(), 42);
+    sender.join();
+    EXPECT_TRUE(sent.load());
+}
+
+TYPED_TEST(Conversation, ManySendersAndReceivers)
+{
+    constexpr static int senders = 4;
+    constexpr static int receivers = 3;
+    constexpr static int per_sender = 500;
+
+    nrws::conversation<int, TypeParam> conversation;
+
+    std::atomic<long long> sum{ 0 };
+    std::atomic<int> count{ 0 };
+
+    std::vector<std::thread> threads;
+    for (int s = 0; s < senders; s++) {
+        threads.emplace_back([&]() {
+            for (int i = 1; i <= per_sender; i++) { EXPECT_TRUE(conversation.push(i)); }
+        });
+    }
+    for (int r = 0; r < receivers; r++) {
+        threads.emplace_back([&]() {
+            while (const auto value = conversation.pop()) {
+                sum.fetch_add(value.value());
+                count.fetch_add(1);
+            }
+        });
+    }
+
+    for (int s = 0; s < senders; s++) { threads[static_cast<std::size_t>(s)].join(); }
+    conversation.close();
+    for (std::size_t r = senders; r < threads.size(); r++) { threads[r].join(); }
+
+    EXPECT_EQ(count.load(), senders * per_sender);
+    EXPECT_EQ(sum.load(), static_cast<long long>(senders) * per_sender * (per_sender + 1) / 2);
+}
+
+TYPED_TEST(Conversation, Timeouts)
+{
+    using nrws::channel_status;
+
+    nrws::conversation<std::string, TypeParam> conversation;
+
+    // nobody is receiving, so the offer is withdrawn and the value is left alone
+    std::string value = "hello";
+    EXPECT_EQ(conversation.push_until(std::move(value), std::chrono::steady_clock::now() + 2ms), channel_status::timeout);
+    EXPECT_EQ(value, "hello");
+
+    EXPECT_EQ(conversation.pop_until(std::chrono::steady_clock::now() + 2ms).error(), channel_status::timeout);
+    EXPECT_EQ(conversation.try_pop().error(), channel_status::empty);
+}
+
+TYPED_TEST(Conversation, CloseWakesBothSides)
+{
+    nrws::conversation<int, TypeParam> conversation;
+
+    std::thread receiver([&]() { EXPECT_FALSE(conversation.pop().has_value()); });
+    std::this_thread::sleep_for(2ms);
+    conversation.close();
+    receiver.join();
+
+    nrws::conversation<int, TypeParam> other;
+    std::thread sender([&]() { EXPECT_FALSE(other.push(1)); });
+    std::this_thread::sleep_for(2ms);
+    other.close();
+    sender.join();
+
+    EXPECT_EQ(other.try_pop().error(), nrws::channel_status::closed);
+}
+
+TYPED_TEST(Conversation, MoveOnlyValues)
+{
+    nrws::conversation<std::unique_ptr<int>, TypeParam> conversation;
+
+    std::thread sender([&]() { EXPECT_TRUE(conversation.push(std::make_unique<int>(5))); });
+
+    const auto received = conversation.pop();
+    sender.join();
+
+    ASSERT_TRUE(received.has_value());
+    ASSERT_NE(*received, nullptr);
+    EXPECT_EQ(**received, 5);
+}
+
+TEST(Conversation, MovesStraightFromTheSender)
+{
+    nrws::conversation<packet> conversation;
+
+    std::thread sender([&]() { EXPECT_TRUE(conversation.push(packet(7))); });
+
+    packet::copies = 0;
+    packet::moves = 0;
+    const auto received = conversation.pop();
+    sender.join();
+
+    ASSERT_TRUE(received.has_value());
+    EXPECT_EQ(received->id, 7);
+    EXPECT_EQ(packet::copies.load(), 0);
+    // out of the sender's frame, then into the optional
+    EXPECT_LE(packet::moves.load(), 2);
+}
@@ -0,0 +1,128 @@
+#include "narrows/mailbox.hpp"
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+struct message : nrws::mailbox_hook
+{
+    int producer{ 0 };
+    int sequence{ 0 };
+};
+
+template<typename Wait>
+class MailboxTest : public testing::Test
+{
+};
+
+using Waits = testing::Types<nrws::spin_wait, nrws::yield_wait, nrws::park_wait>;
+TYPED_TEST_SUITE(MailboxTest, Waits);
+
+}// namespace
+
+TYPED_TEST(MailboxTest, KeepsOrderAndIdentity)
+{
+    using namespace nrws;
+
+    auto [s, r] = mailbox<message, TypeParam>();
+    EXPECT_EQ(r.try_receive().error(), receiver_error_t::ChannelEmpty);
+
+    std::vector<message> messages(8);
+    for (int i = 0; i < 8; i++) {
+        messages[static_cast<std::size_t>(i)].sequence = i;
+        EXPECT_TRUE(s.send(messages[static_cast<std::size_t>(i)]).has_value());
+    }
+
+    // the mailbox hands back the very objects that were sent
+    for (std::size_t i = 0U; i < 8U; i++) { EXPECT_EQ(r.receive().value(), &messages[i]); }
+    EXPECT_EQ(r.try_receive().error(), receiver_error_t::ChannelEmpty);
+}
+
+TYPED_TEST(MailboxTest, MessagesCanBeSentAgain)
+{
+    using namespace nrws;
+
+    auto [s, r] = mailbox<message, TypeParam>();
+    message only;
+    for (int i = 0; i < 100; i++) {
+        only.sequence = i;
+        EXPECT_TRUE(s.send(&only).has_value());
+        auto *received = r.receive().value();
+        EXPECT_EQ(received, &only);
+        EXPECT_EQ(received->sequence, i);
+    }
+}
+
+TYPED_TEST(MailboxTest, CloseDrainsThenReportsClosed)
+{
+    using namespace nrws;
+
+    auto [s, r] = mailbox<message, TypeParam>();
+    message first;
+    message second;
+    EXPECT_TRUE(s.send(first).has_value());
+    s.close();
+
+    // a message that isn't linked stays with the caller
+    EXPECT_EQ(s.send(second).error(), sender_error_t::ChannelClosed);
+
+    EXPECT_EQ(r.receive().value(), &first);
+    EXPECT_EQ(r.receive().error(), receiver_error_t::ChannelClosed);
+    EXPECT_EQ(r.try_receive().error(), receiver_error_t::ChannelClosed);
+}
+
+TYPED_TEST(MailboxTest, ReceiveForTimesOut)
+{
+    using namespace nrws;
+
+    auto [s, r] = mailbox<message, TypeParam>();
+    EXPECT_EQ(r.receive_for(2ms).error(), receiver_error_t::Timeout);
+
+    message late;
+    std::thread sender([&s, &late]() {
+        std::this_thread::sleep_for(2ms);
+        EXPECT_TRUE(s.send(late).has_value());
+    });
+    EXPECT_EQ(r.receive_for(5s).value(), &late);
+    sender.join();
+}
+
+TYPED_TEST(MailboxTest, ManyProducers)
+{
+    using namespace nrws;
+
+    constexpr int producers = 4;
+    constexpr int count = 10'000;
+
+    auto [s, r] = mailbox<message, TypeParam>();
+    std::vector<std::vector<message>> messages(producers, std::vector<message>(count));
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&messages, sender = s, p]() mutable {
+            for (int i = 0; i < count; i++) {
+                auto &m = messages[static_cast<std::size_t>(p)][static_cast<std::size_t>(i)];
+                m.producer = p;
+                m.sequence = i;
+                EXPECT_TRUE(sender.send(m).has_value());
+            }
+        });
+    }
+
+    // every message arrives once, in the order its producer sent it
+    std::vector<int> next(producers, 0);
+    for (int i = 0; i < producers * count; i++) {
+        auto *m = r.receive().value();
+        EXPECT_EQ(m->sequence, next[static_cast<std::size_t>(m->producer)]++);
+    }
+
+    for (auto &thread : threads) { thread.join(); }
+    s.close();
+    EXPECT_EQ(r.receive().error(), receiver_error_t::ChannelClosed);
+}
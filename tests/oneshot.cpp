@@ -0,0 +1,146 @@
+#include "narrows/oneshot.hpp"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+// counts live instances to catch leaks and double destruction
+struct tracked
+{
+    static inline std::atomic<int> alive{ 0 };
+
+    int id{ 0 };
+
+    explicit tracked(int value) : id(value) { alive++; }
+    tracked(const tracked &other) : id(other.id) { alive++; }
+    tracked(tracked &&other) noexcept : id(other.id) { alive++; }
+    tracked &operator=(const tracked &) = default;
+    tracked &operator=(tracked &&) = default;
+    ~tracked() { alive--; }
+};
+
+}// namespace
+
+TEST(Oneshot, SendThenReceive)
+{
+    using namespace nrws;
+
+    auto [s, r] = oneshot<std::string>();
+    EXPECT_EQ(r.try_receive().error(), receiver_error_t::ChannelEmpty);
+
+    EXPECT_TRUE(s.send("hello").has_value());
+    EXPECT_FALSE(s.is_open());
+    EXPECT_EQ(s.send("again").error(), sender_error_t::ChannelClosed);
+
+    EXPECT_EQ(r.receive().value(), "hello");
+    EXPECT_EQ(r.receive().error(), receiver_error_t::ChannelClosed);
+}
+
+TEST(Oneshot, ReceiveWaitsForTheSender)
+{
+    using namespace nrws;
+
+    auto [s, r] = oneshot<int>();
+    std::thread sender([s = std::move(s)]() mutable {
+        std::this_thread::sleep_for(2ms);
+        EXPECT_TRUE(s.send(42).has_value());
+    });
+
+    EXPECT_EQ(r.receive().value(), 42);
+    sender.join();
+}
+
+TEST(Oneshot, DroppedEnds)
+{
+    using namespace nrws;
+
+    {
+        auto [s, r] = oneshot<int>();
+        { auto dropped = std::move(s); }
+        EXPECT_EQ(r.receive().error(), receiver_error_t::ChannelClosed);
+    }
+    {
+        auto [s, r] = oneshot<int>();
+        { auto dropped = std::move(r); }
+        EXPECT_FALSE(s.is_open());
+        EXPECT_EQ(s.send(1).error(), sender_error_t::ChannelClosed);
+    }
+    {
+        auto [s, r] = oneshot<int>();
+        EXPECT_EQ(r.receive_for(1ms).error(), receiver_error_t::Timeout);
+    }
+}
+
+TEST(Oneshot, NoLeaks)
+{
+    using namespace nrws;
+
+    tracked::alive = 0;
+    {
+        // sent but never received
+        auto [s, r] = oneshot<tracked>();
+        EXPECT_TRUE(s.send(tracked(1)).has_value());
+    }
+    {
+        auto [s, r] = oneshot<tracked>();
+        EXPECT_TRUE(s.send(tracked(2)).has_value());
+        EXPECT_EQ(r.receive()->id, 2);
+    }
+    EXPECT_EQ(tracked::alive.load(), 0);
+
+    // both ends racing to be the last one
+    for (int i = 0; i < 1000; i++) {
+        auto [s, r] = oneshot<tracked>();
+        std::thread sender([s = std::move(s), i]() mutable { static_cast<void>(s.send(tracked(i))); });
+        if (i % 2 == 0) { static_cast<void>(r.receive()); }
+        { auto dropped = std::move(r); }
+        sender.join();
+    }
+    EXPECT_EQ(tracked::alive.load(), 0);
+}
+
+TEST(Oneshot, RequestReply)
+{
+    using namespace nrws;
+
+    auto [s, r] = bounded<request<int, std::string>, array_channel>(16);
+
+    std::thread server([r = std::move(r)]() mutable {
+        while (auto req = r.receive()) {
+            EXPECT_TRUE(req->reply.send(std::to_string(req->value * 2)).has_value());
+        }
+    });
+
+    for (int i = 0; i < 100; i++) {
+        auto reply = send_request(s, i);
+        ASSERT_TRUE(reply.has_value());
+        EXPECT_EQ(reply->receive().value(), std::to_string(i * 2));
+    }
+
+    s.close();
+    server.join();
+
+    EXPECT_EQ(send_request(s, 1).error(), sender_error_t::ChannelClosed);
+}
+
+TEST(Oneshot, UnansweredRequestIsClosed)
+{
+    using namespace nrws;
+
+    auto [s, r] = bounded<request<int, int>>(1);
+
+    auto reply = send_request(s, 7);
+    ASSERT_TRUE(reply.has_value());
+
+    // the server drops the request without answering
+    { auto req = r.receive(); }
+    EXPECT_EQ(reply->receive().error(), receiver_error_t::ChannelClosed);
+}
@@ -0,0 +1,184 @@
+#include "narrows/narrows.hpp"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct quote
+{
+    std::string symbol;
+    int price{ 0 };
+};
+
+using by_symbol = nrws::conflate<decltype([](const quote &q) { return q.symbol; })>;
+
+// counts live instances to catch leaks and double destruction
+struct tracked
+{
+    static inline std::atomic<int> alive{ 0 };
+
+    int id{ 0 };
+
+    explicit tracked(int value) : id(value) { alive++; }
+    tracked(const tracked &other) : id(other.id) { alive++; }
+    tracked(tracked &&other) noexcept : id(other.id) { alive++; }
+    tracked &operator=(const tracked &) = default;
+    tracked &operator=(tracked &&) = default;
+    ~tracked() { alive--; }
+};
+
+}// namespace
+
+TEST(Overflow, BlockIsTheDefault)
+{
+    using namespace nrws;
+
+    bounded_channel<int> ch(2);
+    EXPECT_EQ(ch.try_push(1), channel_status::success);
+    EXPECT_EQ(ch.try_push(2), channel_status::success);
+    EXPECT_EQ(ch.try_push(3), channel_status::full);
+    EXPECT_EQ(ch.dropped(), 0U);
+}
+
+TEST(Overflow, DropNewestKeepsWhatIsQueued)
+{
+    using namespace nrws;
+
+    bounded_channel<int, park_wait, std::allocator<int>, drop_newest> ch(3);
+    for (int i = 0; i < 10; i++) { EXPECT_TRUE(ch.push(i)); }
+    EXPECT_EQ(ch.try_push(10), channel_status::success);
+
+    EXPECT_EQ(ch.size(), 3U);
+    EXPECT_EQ(ch.dropped(), 8U);
+    for (int i = 0; i < 3; i++) { EXPECT_EQ(ch.pop(), i); }
+
+    // room again once received
+    EXPECT_TRUE(ch.push(42));
+    EXPECT_EQ(ch.pop(), 42);
+}
+
+TEST(Overflow, OverwriteOldestKeepsTheLatest)
+{
+    using namespace nrws;
+
+    bounded_channel<int, park_wait, std::allocator<int>, overwrite_oldest> ch(3);
+    for (int i = 0; i < 10; i++) { EXPECT_TRUE(ch.push(i)); }
+
+    EXPECT_EQ(ch.size(), 3U);
+    EXPECT_EQ(ch.dropped(), 7U);
+    for (int i = 7; i < 10; i++) { EXPECT_EQ(ch.pop(), i); }
+    EXPECT_EQ(ch.try_pop().error(), channel_status::empty);
+}
+
+TEST(Overflow, ConflateReplacesInPlace)
+{
+    using namespace nrws;
+
+    bounded_channel<quote, park_wait, std::allocator<quote>, by_symbol> ch(8);
+    EXPECT_TRUE(ch.push(quote{ "ABC", 1 }));
+    EXPECT_TRUE(ch.push(quote{ "XYZ", 10 }));
+    EXPECT_TRUE(ch.push(quote{ "ABC", 2 }));
+    EXPECT_TRUE(ch.push(quote{ "ABC", 3 }));
+
+    // ABC keeps its place in line but carries the latest price
+    EXPECT_EQ(ch.size(), 2U);
+    EXPECT_EQ(ch.conflated(), 2U);
+    EXPECT_EQ(ch.pop()->price, 3);
+    EXPECT_EQ(ch.pop()->price, 10);
+
+    // once received, the key is queued anew
+    EXPECT_TRUE(ch.push(quote{ "ABC", 4 }));
+    EXPECT_TRUE(ch.push(quote{ "ABC", 5 }));
+    EXPECT_EQ(ch.size(), 1U);
+    EXPECT_EQ(ch.pop()->price, 5);
+    EXPECT_EQ(ch.dropped(), 0U);
+}
+
+TEST(Overflow, ConflateEvictsTheOldestForANewKey)
+{
+    using namespace nrws;
+
+    bounded_channel<quote, park_wait, std::allocator<quote>, by_symbol> ch(2);
+    EXPECT_TRUE(ch.push(quote{ "A", 1 }));
+    EXPECT_TRUE(ch.push(quote{ "B", 2 }));
+    EXPECT_TRUE(ch.push(quote{ "C", 3 }));
+    EXPECT_TRUE(ch.push(quote{ "A", 4 }));
+
+    // A was evicted for C, so the second A is new again and evicts B
+    EXPECT_EQ(ch.dropped(), 2U);
+    EXPECT_EQ(ch.conflated(), 0U);
+    EXPECT_EQ(ch.pop()->symbol, "C");
+    EXPECT_EQ(ch.pop()->price, 4);
+}
+
+TEST(Overflow, ConflateWithZeroCopyAndBatches)
+{
+    using namespace nrws;
+
+    bounded_channel<quote, park_wait, std::allocator<quote>, by_symbol> ch(4);
+    {
+        auto slot = ch.reserve();
+        slot.value()->symbol = "ABC";
+        slot.value()->price = 1;
+    }
+    const std::vector<quote> updates{ { "XYZ", 1 }, { "ABC", 2 }, { "XYZ", 3 } };
+    EXPECT_EQ(ch.push_many(updates.begin(), updates.end()), 3U);
+    EXPECT_EQ(ch.conflated(), 2U);
+
+    std::vector<quote> received;
+    EXPECT_EQ(ch.pop_many(std::back_inserter(received), 8U), 2U);
+    EXPECT_EQ(received[0].price, 2);
+    EXPECT_EQ(received[1].price, 3);
+
+    // the batch popped the keys as well
+    EXPECT_TRUE(ch.push(quote{ "ABC", 5 }));
+    EXPECT_EQ(ch.size(), 1U);
+}
+
+TEST(Overflow, EvictedValuesAreDestroyed)
+{
+    using namespace nrws;
+
+    {
+        bounded_channel<tracked, park_wait, std::allocator<tracked>, overwrite_oldest> overwrite(4);
+        bounded_channel<tracked, park_wait, std::allocator<tracked>, drop_newest> drop(4);
+        for (int i = 0; i < 100; i++) {
+            overwrite.emplace(i);
+            drop.emplace(i);
+        }
+        EXPECT_EQ(tracked::alive.load(), 8);
+    }
+    EXPECT_EQ(tracked::alive.load(), 0);
+}
+
+TEST(Overflow, SendersNeverWait)
+{
+    using namespace nrws;
+
+    auto [s, r] = bounded<int, overflow_backend<overwrite_oldest>::type>(16);
+
+    constexpr int count = 100'000;
+    std::thread producer([&s]() {
+        for (int i = 0; i < count; i++) { EXPECT_TRUE(s.send(i).has_value()); }
+        s.close();
+    });
+
+    // values arrive in order, with gaps where the slow receiver missed them
+    std::uint64_t received = 0U;
+    int last = -1;
+    for (const auto value : r) {
+        EXPECT_GT(value, last);
+        last = value;
+        received++;
+    }
+    producer.join();
+
+    EXPECT_EQ(last, count - 1);
+    EXPECT_EQ(received + r.dropped(), static_cast<std::uint64_t>(count));
+    EXPECT_EQ(s.dropped(), r.dropped());
+}
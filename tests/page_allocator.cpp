@@ -0,0 +1,158 @@
+#include "narrows/page_allocator.hpp"
+#include "narrows/single_bounded.hpp"
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+
+struct packet
+{
+    std::uint64_t sequence;
+    char payload[56];
+};
+
+// counts the pages of [ptr, ptr + bytes) that are in memory
+auto resident_pages(const void *ptr, const std::size_t bytes) -> std::size_t
+{
+    const auto page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    const auto pages = (bytes + page - 1U) / page;
+    std::vector<unsigned char> resident(pages);
+    if (::mincore(const_cast<void *>(ptr), bytes, resident.data()) != 0) { return 0U; }
+
+    std::size_t count = 0U;
+    for (const auto flags : resident) { count += flags & 1U; }
+    return count;
+}
+
+}// namespace
+
+template<typename Channel>
+class PageAllocator : public ::testing::Test
+{
+};
+
+using PagedChannels = ::testing::Types<nrws::paged::bounded_channel<packet>, nrws::paged::array_channel<packet>>;
+TYPED_TEST_SUITE(PageAllocator, PagedChannels);
+
+TYPED_TEST(PageAllocator, SendAndReceive)
+{
+    constexpr std::uint64_t count = 100'000U;
+
+    for (const auto huge_pages : { true, false }) {
+        nrws::page_options options;
+        options.huge_pages = huge_pages;
+        options.node = nrws::page_options::local_node;
+
+        // big enough for a huge page
+        TypeParam ch(1U << 16U, nrws::page_allocator<packet>(options));
+
+        std::thread producer([&ch]() {
+            for (std::uint64_t i = 0U; i < count; i++) { ch.push(packet{ i, "data" }); }
+            ch.close();
+        });
+
+        std::uint64_t expected = 0U;
+        for (const auto &p : ch) { EXPECT_EQ(p.sequence, expected++); }
+        EXPECT_EQ(expected, count);
+
+        producer.join();
+    }
+}
+
+TEST(PageAllocator, StripedChannel)
+{
+    // every stripe maps its own ring
+    nrws::paged::striped_channel<packet> ch(1U << 16U, 4U, true, nrws::page_allocator<packet>());
+
+    for (std::uint64_t i = 0U; i < 1000U; i++) { ch.push(packet{ i, "data" }); }
+    for (std::uint64_t i = 0U; i < 1000U; i++) { EXPECT_EQ(ch.pop().value().sequence, i); }
+}
+
+TEST(PageAllocator, Prefaults)
+{
+    constexpr std::size_t count = std::size_t{ 4U } << 20U;
+
+    for (const auto huge_pages : { true, false }) {
+        nrws::page_options options;
+        options.huge_pages = huge_pages;
+
+        nrws::page_allocator<std::byte> alloc(options);
+        auto *memory = alloc.allocate(count);
+        EXPECT_EQ(resident_pages(memory, count), count / static_cast<std::size_t>(::sysconf(_SC_PAGESIZE)));
+        alloc.deallocate(memory, count);
+
+        // without prefaulting nothing is touched yet
+        options.prefault = false;
+        nrws::page_allocator<std::byte> lazy(options);
+        memory = lazy.allocate(count);
+        EXPECT_EQ(resident_pages(memory, count), 0U);
+        lazy.deallocate(memory, count);
+    }
+}
+
+TEST(PageAllocator, HugeAllocationsAreAligned)
+{
+    constexpr std::size_t huge_page = std::size_t{ 2U } << 20U;
+
+    nrws::page_allocator<std::byte> alloc;
+    auto *memory = alloc.allocate(huge_page + 1U);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(memory) % huge_page, 0U);
+
+    // the rounded up tail is usable
+    memory[2U * huge_page - 1U] = std::byte{ 1U };
+    alloc.deallocate(memory, huge_page + 1U);
+}
+
+TEST(PageAllocator, AnyNodeWorks)
+{
+    EXPECT_GE(nrws::current_numa_node(), 0);
+
+    // a node that doesn't exist or can't be expressed only loses the placement
+    for (const auto node : { nrws::page_options::any_node, nrws::page_options::local_node, 0, 63, 1000 }) {
+        nrws::page_options options;
+        options.node = node;
+
+        auto [s, r] = nrws::bounded<int, nrws::paged::array_channel>(1U << 20U, nrws::page_allocator<int>(options));
+        EXPECT_TRUE(s.send(node).has_value());
+        EXPECT_EQ(r.receive().value(), node);
+    }
+}
+
+TEST(PageAllocator, SmallAllocations)
+{
+    // below a page nothing is mapped, so rebound copies can hand out small nodes cheaply
+    nrws::page_allocator<int> alloc;
+    std::vector<int *> values;
+    for (int i = 0; i < 100; i++) {
+        values.push_back(alloc.allocate(1U));
+        *values.back() = i;
+    }
+    for (int i = 0; i < 100; i++) {
+        EXPECT_EQ(*values[static_cast<std::size_t>(i)], i);
+        alloc.deallocate(values[static_cast<std::size_t>(i)], 1U);
+    }
+
+    nrws::paged::bounded_channel<int> ch(4U);
+    ch.push(1);
+    EXPECT_EQ(ch.pop().value(), 1);
+}
+
+TEST(PageAllocator, RebindKeepsOptions)
+{
+    nrws::page_options options;
+    options.huge_pages = false;
+    options.node = 0;
+
+    const nrws::page_allocator<int> alloc(options);
+    const nrws::page_allocator<packet> rebound(alloc);
+    EXPECT_EQ(rebound.options(), options);
+    EXPECT_TRUE(alloc == rebound);
+    EXPECT_FALSE(alloc == nrws::page_allocator<int>());
+}
@@ -0,0 +1,120 @@
+#include "narrows/bounded.hpp"
+#include "narrows/ready_fd.hpp"
+#include "narrows/single_bounded.hpp"
+#include "narrows/unbounded.hpp"
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <thread>
+
+#include <poll.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+namespace {
+
+auto readable(const int fd, const int timeout_ms = 0) -> bool
+{
+    pollfd entry{ fd, POLLIN, 0 };
+    return ::poll(&entry, 1, timeout_ms) == 1 && (entry.revents & POLLIN) != 0;
+}
+
+}// namespace
+
+TEST(ReadyFd, ReadableOnceNonEmpty)
+{
+    using namespace nrws;
+
+    auto [s, r] = bounded<int>(8U);
+    ready_fd ready(r);
+    EXPECT_GE(ready.fd(), 0);
+    EXPECT_FALSE(readable(ready.fd()));
+
+    EXPECT_TRUE(s.send(1).has_value());
+    EXPECT_TRUE(readable(ready.fd()));
+
+    ready.reset();
+    EXPECT_FALSE(readable(ready.fd()));
+    EXPECT_EQ(r.try_receive().value(), 1);
+
+    // draining doesn't signal by itself
+    EXPECT_EQ(r.try_receive().error(), receiver_error_t::ChannelEmpty);
+    EXPECT_FALSE(readable(ready.fd()));
+}
+
+TEST(ReadyFd, BurstIsCoalesced)
+{
+    using namespace nrws;
+
+    auto [s, r] = unbounded<int>();
+    ready_fd ready(r);
+
+    for (int i = 0; i < 100; i++) { EXPECT_TRUE(s.send(i).has_value()); }
+
+    // the eventfd counter shows how many writes there were
+    std::uint64_t writes = 0U;
+    ASSERT_EQ(::read(ready.fd(), &writes, sizeof(writes)), static_cast<ssize_t>(sizeof(writes)));
+    EXPECT_EQ(writes, 1U);
+}
+
+TEST(ReadyFd, ExistingValuesAndClose)
+{
+    using namespace nrws;
+
+    auto [s, r] = bounded<int, array_channel>(8U);
+    EXPECT_TRUE(s.send(1).has_value());
+
+    ready_fd ready(r);
+    EXPECT_TRUE(readable(ready.fd()));
+    ready.reset();
+    EXPECT_EQ(r.try_receive().value(), 1);
+
+    s.close();
+    EXPECT_TRUE(readable(ready.fd()));
+    ready.reset();
+    EXPECT_EQ(r.try_receive().error(), receiver_error_t::ChannelClosed);
+}
+
+TEST(ReadyFd, EpollLoop)
+{
+    using namespace nrws;
+
+    constexpr static int max = 10000;
+
+    auto [s, r] = bounded<int>(64U);
+    ready_fd ready(r);
+
+    const int epoll = ::epoll_create1(EPOLL_CLOEXEC);
+    ASSERT_GE(epoll, 0);
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = ready.fd();
+    ASSERT_EQ(::epoll_ctl(epoll, EPOLL_CTL_ADD, ready.fd(), &event), 0);
+
+    std::thread producer([&s]() {
+        for (int i = 0; i < max; i++) { EXPECT_TRUE(s.send(i).has_value()); }
+        s.close();
+    });
+
+    int expected = 0;
+    auto open = true;
+    while (open) {
+        epoll_event fired{};
+        ASSERT_EQ(::epoll_wait(epoll, &fired, 1, 10000), 1);
+
+        ready.reset();
+        while (true) {
+            const auto value = r.try_receive();
+            if (!value.has_value()) {
+                open = value.error() != receiver_error_t::ChannelClosed;
+                break;
+            }
+            EXPECT_EQ(value.value(), expected);
+            expected++;
+        }
+    }
+    EXPECT_EQ(expected, max);
+
+    producer.join();
+    ::close(epoll);
+}
@@ -0,0 +1,182 @@
+#include "narrows/records.hpp"
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <numeric>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+auto as_bytes(const std::string_view text) -> std::span<const std::byte>
+{
+    return std::as_bytes(std::span<const char>(text.data(), text.size()));
+}
+
+auto as_text(const std::span<const std::byte> bytes) -> std::string_view
+{
+    return { reinterpret_cast<const char *>(bytes.data()), bytes.size() };
+}
+
+// a record of length bytes that carries its sequence number in every byte
+auto frame(const std::size_t sequence, const std::size_t length) -> std::vector<std::byte>
+{
+    return std::vector<std::byte>(length, static_cast<std::byte>(sequence));
+}
+
+template<typename Wait>
+class RecordsTest : public testing::Test
+{
+};
+
+using WaitPolicies = testing::Types<nrws::spin_wait, nrws::yield_wait, nrws::park_wait>;
+TYPED_TEST_SUITE(RecordsTest, WaitPolicies);
+
+}// namespace
+
+TYPED_TEST(RecordsTest, SendAndReceive)
+{
+    auto [s, r] = nrws::records<TypeParam>(256U);
+
+    EXPECT_TRUE(s.send(as_bytes("hello")).has_value());
+    EXPECT_TRUE(s.send(as_bytes("")).has_value());
+    EXPECT_TRUE(s.send(as_bytes("variable length")).has_value());
+
+    EXPECT_EQ(as_text(r.receive()->bytes()), "hello");
+    EXPECT_TRUE(r.receive()->bytes().empty());
+    EXPECT_EQ(as_text(r.receive()->bytes()), "variable length");
+    EXPECT_EQ(r.try_receive().error(), nrws::receiver_error_t::ChannelEmpty);
+}
+
+TYPED_TEST(RecordsTest, WritesInPlace)
+{
+    auto [s, r] = nrws::records<TypeParam>(256U);
+
+    {
+        auto slot = s.reserve(64U).value();
+        EXPECT_EQ(slot.bytes().size(), 64U);
+        std::memcpy(slot.bytes().data(), "short", 5U);
+
+        // only part of what was reserved is sent
+        slot.commit(5U);
+    }
+
+    // committed when the slot is destroyed
+    { std::memcpy(s.reserve(3U)->bytes().data(), "abc", 3U); }
+
+    EXPECT_EQ(as_text(r.receive()->bytes()), "short");
+    EXPECT_EQ(as_text(r.receive()->bytes()), "abc");
+}
+
+TYPED_TEST(RecordsTest, WrapsAroundWithPadding)
+{
+    auto [s, r] = nrws::records<TypeParam>(128U);
+
+    // 48 byte records don't divide the ring, so every other lap ends in a padding record
+    for (std::size_t i = 0U; i < 100U; i++) {
+        const auto sent = frame(i, 40U);
+        ASSERT_TRUE(s.try_send(sent).has_value()) << i;
+
+        auto record = r.try_receive();
+        ASSERT_TRUE(record.has_value()) << i;
+        EXPECT_TRUE(std::ranges::equal(record->bytes(), sent)) << i;
+    }
+}
+
+TYPED_TEST(RecordsTest, FullAndTooLarge)
+{
+    auto [s, r] = nrws::records<TypeParam>(128U);
+    EXPECT_EQ(s.max_record(), 56U);
+
+    EXPECT_EQ(s.try_send(frame(0U, 57U)).error(), nrws::sender_error_t::TooLarge);
+    EXPECT_EQ(s.reserve(1024U).error(), nrws::sender_error_t::TooLarge);
+
+    EXPECT_TRUE(s.try_send(frame(1U, 56U)).has_value());
+    EXPECT_TRUE(s.try_send(frame(2U, 56U)).has_value());
+    EXPECT_EQ(s.try_send(frame(3U, 1U)).error(), nrws::sender_error_t::ChannelFull);
+    EXPECT_EQ(s.reserve_for(1U, 10ms).error(), nrws::sender_error_t::Timeout);
+
+    // a record that doesn't fit before the end waits for the front to be freed
+    EXPECT_EQ(r.receive()->bytes().front(), std::byte{ 1U });
+    EXPECT_TRUE(s.try_send(frame(4U, 8U)).has_value());
+    EXPECT_EQ(s.try_send(frame(5U, 56U)).error(), nrws::sender_error_t::ChannelFull);
+}
+
+TYPED_TEST(RecordsTest, ReceiveMany)
+{
+    auto [s, r] = nrws::records<TypeParam>(1024U);
+    for (std::size_t i = 0U; i < 10U; i++) { EXPECT_TRUE(s.send(frame(i, i)).has_value()); }
+
+    std::vector<std::size_t> lengths;
+    const auto read = [&lengths](const std::span<const std::byte> record) { lengths.push_back(record.size()); };
+    EXPECT_EQ(r.receive_many(read, 4U).value(), 4U);
+    EXPECT_EQ(r.receive_many(read, 100U).value(), 6U);
+
+    std::vector<std::size_t> expected(10U);
+    std::iota(expected.begin(), expected.end(), 0U);
+    EXPECT_EQ(lengths, expected);
+
+    s.close();
+    EXPECT_EQ(r.receive_many(read, 4U).error(), nrws::receiver_error_t::ChannelClosed);
+}
+
+TYPED_TEST(RecordsTest, Close)
+{
+    auto [s, r] = nrws::records<TypeParam>(256U);
+
+    EXPECT_TRUE(s.send(as_bytes("before")).has_value());
+    auto late = s.reserve(5U).value();
+    s.close();
+
+    EXPECT_EQ(s.send(as_bytes("after")).error(), nrws::sender_error_t::ChannelClosed);
+    EXPECT_EQ(s.try_reserve(1U).error(), nrws::sender_error_t::ChannelClosed);
+
+    // records reserved before the close are still received
+    EXPECT_EQ(as_text(r.receive()->bytes()), "before");
+    std::memcpy(late.bytes().data(), "late!", 5U);
+    late.commit();
+    EXPECT_EQ(as_text(r.receive()->bytes()), "late!");
+    EXPECT_EQ(r.receive().error(), nrws::receiver_error_t::ChannelClosed);
+}
+
+TYPED_TEST(RecordsTest, ManyProducers)
+{
+    constexpr std::size_t producers = 4U;
+    constexpr std::size_t count = 1'000U;
+    auto [s, r] = nrws::records<TypeParam>(4096U);
+
+    std::vector<std::thread> threads;
+    for (std::size_t p = 0U; p < producers; p++) {
+        threads.emplace_back([p, &s]() {
+            auto sender = s;
+            for (std::size_t i = 0U; i < count; i++) {
+                // the first byte says who sent it, the length varies from 1 to 300 bytes
+                auto slot = sender.reserve(1U + (i * 37U) % 300U).value();
+                std::ranges::fill(slot.bytes(), static_cast<std::byte>(i));
+                slot.bytes().front() = static_cast<std::byte>(p);
+            }
+        });
+    }
+
+    // records of one producer arrive in the order it sent them
+    std::vector<std::size_t> next(producers, 0U);
+    for (std::size_t received = 0U; received < producers * count; received++) {
+        auto record = r.receive().value();
+        const auto bytes = record.bytes();
+        const auto p = static_cast<std::size_t>(bytes.front());
+        const auto i = next[p]++;
+
+        ASSERT_EQ(bytes.size(), 1U + (i * 37U) % 300U);
+        for (const auto byte : bytes.subspan(1U)) { ASSERT_EQ(byte, static_cast<std::byte>(i)); }
+    }
+    for (auto &thread : threads) { thread.join(); }
+
+    EXPECT_EQ(next, std::vector<std::size_t>(producers, count));
+    EXPECT_EQ(r.try_receive().error(), nrws::receiver_error_t::ChannelEmpty);
+}
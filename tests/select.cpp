@@ -0,0 +1,203 @@
+#include "narrows/bounded.hpp"
+#include "narrows/select.hpp"
+#include "narrows/single_bounded.hpp"
+#include "narrows/unbounded.hpp"
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+TEST(Select, FiresTheReadyCase)
+{
+    using namespace nrws;
+
+    auto [data_s, data_r] = bounded<int>(4U);
+    auto [text_s, text_r] = unbounded<std::string>();
+
+    EXPECT_TRUE(text_s.send("hello").has_value());
+
+    std::string text;
+    const auto fired = select(on_receive(data_r, [](auto) { FAIL() << "data is empty"; }),
+        on_receive(text_r, [&text](auto received) { text = received.value(); }));
+
+    EXPECT_EQ(fired, 1U);
+    EXPECT_EQ(text, "hello");
+}
+
+TEST(Select, BlocksUntilAValueArrives)
+{
+    using namespace nrws;
+
+    auto [data_s, data_r] = bounded<int, array_channel>(4U);
+    auto [control_s, control_r] = unbounded<std::string>();
+
+    std::thread producer([&data_s]() {
+        std::this_thread::sleep_for(5ms);
+        EXPECT_TRUE(data_s.send(42).has_value());
+    });
+
+    int value = 0;
+    const auto fired = select(on_receive(control_r, [](auto) { FAIL() << "control is empty"; }),
+        on_receive(data_r, [&value](auto received) { value = received.value(); }));
+
+    EXPECT_EQ(fired, 1U);
+    EXPECT_EQ(value, 42);
+    producer.join();
+}
+
+TEST(Select, ClosedChannelFires)
+{
+    using namespace nrws;
+
+    auto [s, r] = bounded<int>(4U);
+    std::thread closer([&s]() {
+        std::this_thread::sleep_for(5ms);
+        s.close();
+    });
+
+    auto error = receiver_error_t::Timeout;
+    EXPECT_EQ(select(on_receive(r, [&error](auto received) { error = received.error(); })), 0U);
+    EXPECT_EQ(error, receiver_error_t::ChannelClosed);
+    closer.join();
+}
+
+TEST(Select, SendCaseWaitsForRoom)
+{
+    using namespace nrws;
+
+    auto [s, r] = bounded<int>(1U);
+    EXPECT_TRUE(s.send(1).has_value());
+
+    std::thread consumer([&r]() {
+        std::this_thread::sleep_for(5ms);
+        EXPECT_EQ(r.receive().value(), 1);
+    });
+
+    auto sent = false;
+    EXPECT_EQ(select(on_send(s, 2, [&sent](auto result) { sent = result.has_value(); })), 0U);
+    EXPECT_TRUE(sent);
+    consumer.join();
+    EXPECT_EQ(r.receive().value(), 2);
+}
+
+TEST(Select, Timeout)
+{
+    using namespace nrws;
+
+    auto [s, r] = bounded<int>(4U);
+
+    const auto fired = select_for(5ms, on_receive(r, [](auto) { FAIL() << "nothing was sent"; }));
+    ASSERT_FALSE(fired.has_value());
+    EXPECT_EQ(fired.error(), select_error_t::Timeout);
+}
+
+TEST(Select, SelectorRoundRobinIsFair)
+{
+    using namespace nrws;
+
+    auto [a_s, a_r] = bounded<int>(64U);
+    auto [b_s, b_r] = bounded<int>(64U);
+    for (int i = 0; i < 32; i++) {
+        EXPECT_TRUE(a_s.send(i).has_value());
+        EXPECT_TRUE(b_s.send(i).has_value());
+    }
+
+    int from_a = 0;
+    int from_b = 0;
+    Selector selector;
+    EXPECT_EQ(selector.receive(a_r, [&from_a](auto) { from_a++; }), 0U);
+    EXPECT_EQ(selector.receive(b_r, [&from_b](auto) { from_b++; }), 1U);
+
+    for (int i = 0; i < 32; i++) { EXPECT_EQ(selector.wait().value(), static_cast<std::size_t>(i % 2)); }
+    EXPECT_EQ(from_a, 16);
+    EXPECT_EQ(from_b, 16);
+}
+
+TEST(Select, SelectorInOrderPrefersEarlierCases)
+{
+    using namespace nrws;
+
+    auto [a_s, a_r] = bounded<int>(4U);
+    auto [b_s, b_r] = bounded<int>(4U);
+    EXPECT_TRUE(a_s.send(1).has_value());
+    EXPECT_TRUE(a_s.send(2).has_value());
+    EXPECT_TRUE(b_s.send(3).has_value());
+
+    std::vector<int> received;
+    Selector selector(select_order::in_order);
+    selector.receive(a_r, [&received](auto value) { received.push_back(value.value()); });
+    selector.receive(b_r, [&received](auto value) { received.push_back(value.value()); });
+
+    for (int i = 0; i < 3; i++) { EXPECT_TRUE(selector.wait().has_value()); }
+    EXPECT_EQ(received, (std::vector<int>{ 1, 2, 3 }));
+
+    const auto timed_out = selector.wait_for(1ms);
+    ASSERT_FALSE(timed_out.has_value());
+    EXPECT_EQ(timed_out.error(), select_error_t::Timeout);
+}
+
+TEST(Select, SelectorRemoveAndNoCases)
+{
+    using namespace nrws;
+
+    auto [s, r] = bounded<int>(4U);
+    auto [out_s, out_r] = bounded<int>(4U);
+
+    Selector selector(select_order::random);
+    const auto receive = selector.receive(r, [](auto) {});
+    const auto send = selector.send(out_s, 7, [](auto result) { EXPECT_TRUE(result.has_value()); });
+
+    // the send case only fires once
+    EXPECT_EQ(selector.wait().value(), send);
+    EXPECT_EQ(out_r.receive().value(), 7);
+
+    selector.remove(receive);
+    const auto none = selector.wait();
+    ASSERT_FALSE(none.has_value());
+    EXPECT_EQ(none.error(), select_error_t::NoCases);
+}
+
+TEST(Select, ManyProducersOneSelector)
+{
+    using namespace nrws;
+
+    constexpr static int max = 20000;
+
+    auto [data_s, data_r] = bounded<int, array_channel>(64U);
+    auto [control_s, control_r] = unbounded<int>();
+    auto [shutdown_s, shutdown_r] = bounded<int>(1U);
+
+    std::thread data_producer([&data_s]() {
+        for (int i = 0; i < max; i++) { EXPECT_TRUE(data_s.send(i).has_value()); }
+    });
+    std::thread control_producer([&control_s]() {
+        for (int i = 0; i < max; i++) { EXPECT_TRUE(control_s.send(i).has_value()); }
+    });
+
+    long long data = 0;
+    long long control = 0;
+    int received = 0;
+    auto running = true;
+
+    Selector selector;
+    selector.receive(data_r, [&](auto value) {
+        data += value.value();
+        if (++received == 2 * max) { EXPECT_TRUE(shutdown_s.send(0).has_value()); }
+    });
+    selector.receive(control_r, [&](auto value) {
+        control += value.value();
+        if (++received == 2 * max) { EXPECT_TRUE(shutdown_s.send(0).has_value()); }
+    });
+    selector.receive(shutdown_r, [&running](auto) { running = false; });
+
+    while (running) { ASSERT_TRUE(selector.wait().has_value()); }
+
+    data_producer.join();
+    control_producer.join();
+    EXPECT_EQ(data, static_cast<long long>(max) * (max - 1) / 2);
+    EXPECT_EQ(control, static_cast<long long>(max) * (max - 1) / 2);
+}
@@ -0,0 +1,242 @@
+#include "narrows/shared_memory.hpp"
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+struct packet
+{
+    std::uint64_t sequence;
+    std::uint32_t length;
+    char payload[52];
+};
+
+// segment names are global, keep concurrent test runs apart
+auto segment_name(const std::string &test) -> std::string
+{
+    return "/narrows-test-" + std::to_string(::getpid()) + "-" + test;
+}
+
+// runs body in a child process and returns its exit code
+template<typename Body>
+auto in_child(Body body) -> pid_t
+{
+    const auto pid = ::fork();
+    if (pid == 0) { ::_exit(body()); }
+    return pid;
+}
+
+auto exit_code(const pid_t pid) -> int
+{
+    int status = 0;
+    ::waitpid(pid, &status, 0);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+}// namespace
+
+TEST(SharedMemory, SendAndReceiveInProcess)
+{
+    using namespace nrws;
+
+    const auto name = segment_name("in-process");
+    auto r = shm_receiver<int>(name, 16U);
+    auto s = shm_sender<int>(name);
+
+    std::thread sender([&s]() {
+        for (int i = 0; i < 1000; i++) { EXPECT_TRUE(s.send(i).has_value()); }
+        s.close();
+    });
+
+    int expected = 0;
+    for (const auto value : r) { EXPECT_EQ(value, expected++); }
+    EXPECT_EQ(expected, 1000);
+    EXPECT_FALSE(r.peer_lost());
+
+    sender.join();
+}
+
+TEST(SharedMemory, AcrossProcesses)
+{
+    using namespace nrws;
+
+    constexpr std::uint64_t count = 10'000U;
+    const auto name = segment_name("across");
+    auto r = shm_receiver<packet>(name, 64U);
+
+    const auto child = in_child([&name]() {
+        auto s = shm_sender<packet>(name);
+        for (std::uint64_t i = 0U; i < count; i++) {
+            packet p{ i, 4U, "data" };
+            if (!s.send(p).has_value()) { return 1; }
+        }
+        s.close();
+        return 0;
+    });
+
+    std::uint64_t expected = 0U;
+    while (auto p = r.receive()) {
+        EXPECT_EQ(p->sequence, expected++);
+        EXPECT_STREQ(p->payload, "data");
+    }
+    EXPECT_EQ(expected, count);
+    EXPECT_EQ(r.receive().error(), receiver_error_t::ChannelClosed);
+    EXPECT_FALSE(r.peer_lost());
+
+    EXPECT_EQ(exit_code(child), 0);
+}
+
+TEST(SharedMemory, BatchesAcrossProcesses)
+{
+    using namespace nrws;
+
+    const auto name = segment_name("batches");
+    auto s = shm_sender<int>(name, 32U);
+
+    const auto child = in_child([&name]() {
+        auto r = shm_receiver<int>(name);
+        std::vector<int> received;
+        while (r.receive_many(std::back_inserter(received), 16U).has_value()) {}
+
+        for (std::size_t i = 0U; i < received.size(); i++) {
+            if (received[i] != static_cast<int>(i)) { return 1; }
+        }
+        return received.size() == 1000U ? 0 : 2;
+    });
+
+    std::vector<int> values(1000U);
+    for (std::size_t i = 0U; i < values.size(); i++) { values[i] = static_cast<int>(i); }
+    EXPECT_EQ(s.send_many(std::span<int>(values)).value(), 1000U);
+    s.close();
+
+    EXPECT_EQ(exit_code(child), 0);
+}
+
+TEST(SharedMemory, ReceiverNoticesDeadSender)
+{
+    using namespace nrws;
+
+    const auto name = segment_name("dead-sender");
+    auto r = shm_receiver<int>(name, 16U);
+
+    // the sender is killed while the receiver waits, without a chance to close
+    const auto child = in_child([&name]() {
+        auto s = shm_sender<int>(name);
+        static_cast<void>(s.send(1));
+        while (true) { ::pause(); }
+        return 0;
+    });
+
+    EXPECT_EQ(r.receive().value(), 1);
+    ::kill(child, SIGKILL);
+    EXPECT_EQ(exit_code(child), -1);
+
+    EXPECT_EQ(r.receive().error(), receiver_error_t::ChannelClosed);
+    EXPECT_TRUE(r.peer_lost());
+}
+
+TEST(SharedMemory, SenderNoticesDeadReceiver)
+{
+    using namespace nrws;
+
+    const auto name = segment_name("dead-receiver");
+    auto s = shm_sender<int>(name, 4U);
+
+    const auto child = in_child([&name]() {
+        auto r = shm_receiver<int>(name);
+        return r.receive().value();
+    });
+
+    // fill the channel, the sender then waits for room that never comes
+    auto sent = 0;
+    while (s.send(sent).has_value()) { sent++; }
+    EXPECT_EQ(sent, 5);
+    EXPECT_TRUE(s.peer_lost());
+    EXPECT_EQ(s.try_send(0).error(), sender_error_t::ChannelClosed);
+
+    EXPECT_EQ(exit_code(child), 0);
+}
+
+TEST(SharedMemory, WaitsForTheOtherSide)
+{
+    using namespace nrws;
+
+    const auto name = segment_name("not-there-yet");
+    auto r = shm_receiver<int>(name, 4U);
+
+    // nobody attached as a sender yet, which is not the same as a sender that is gone
+    EXPECT_EQ(r.receive_for(100ms).error(), receiver_error_t::Timeout);
+    EXPECT_EQ(r.try_receive().error(), receiver_error_t::ChannelEmpty);
+    EXPECT_FALSE(r.peer_lost());
+
+    auto s = shm_sender<int>(name);
+    EXPECT_TRUE(s.send(7).has_value());
+    EXPECT_EQ(r.receive_for(100ms).value(), 7);
+}
+
+TEST(SharedMemory, CloseReachesEveryHandle)
+{
+    using namespace nrws;
+
+    const auto name = segment_name("close");
+    auto s = shm_sender<int>(name, 4U);
+    auto r = shm_receiver<int>(name);
+
+    EXPECT_TRUE(s.send(1).has_value());
+    r.close();
+
+    EXPECT_EQ(s.try_send(2).error(), sender_error_t::ChannelClosed);
+    EXPECT_EQ(s.send(2).error(), sender_error_t::ChannelClosed);
+
+    // values sent before the close are still received
+    EXPECT_EQ(r.receive().value(), 1);
+    EXPECT_EQ(r.receive().error(), receiver_error_t::ChannelClosed);
+    EXPECT_FALSE(r.peer_lost());
+
+    // a handle that attaches late sees the close as well
+    auto late = shm_receiver<int>(name);
+    EXPECT_EQ(late.try_receive().error(), receiver_error_t::ChannelClosed);
+}
+
+TEST(SharedMemory, AttachFailures)
+{
+    using namespace nrws;
+
+    EXPECT_THROW(static_cast<void>(shm_receiver<int>(segment_name("missing"))), std::system_error);
+
+    // a segment holding values of another type
+    const auto name = segment_name("mismatch");
+    auto s = shm_sender<int>(name, 4U);
+    EXPECT_THROW(static_cast<void>(shm_receiver<packet>(name)), std::system_error);
+    EXPECT_EQ(shm_receiver<int>(name).try_receive().error(), receiver_error_t::ChannelEmpty);
+}
+
+TEST(SharedMemory, CreatorRemovesTheName)
+{
+    using namespace nrws;
+
+    const auto name = segment_name("unlink");
+    {
+        auto s = shm_sender<int>(name, 4U);
+        auto r = shm_receiver<int>(name);
+        EXPECT_EQ(r.receive_for(10ms).error(), receiver_error_t::Timeout);
+    }
+    EXPECT_THROW(static_cast<void>(shm_sender<int>(name)), std::system_error);
+
+    // a stale segment under the name is replaced by a new creator
+    auto first = shm_sender<int>(name, 4U);
+    auto second = shm_sender<int>(name, 8U);
+    EXPECT_EQ(shm_receiver<int>(name).try_receive().error(), receiver_error_t::ChannelEmpty);
+}
@@ -1,6 +1,7 @@
 #include "narrows/single_bounded.hpp"
 #include <gtest/gtest.h>
 
+#include <string>
 #include <thread>
 
 TEST(SingleBounded, Construction)
@@ -32,16 +33,111 @@ TEST(SingleBounded, SendMultipleInt)
 
     auto [s, r] = bounded<int>(15U);
 
-    for (int i = 0; i < max; i++) {
-        const auto status = s.send(i);
-        EXPECT_TRUE(status.has_value());
+    // the channel holds fewer than max values, so the sends need their own thread
+    std::thread producer([&s]() {
+        for (int i = 0; i < max; i++) {
+            const auto status = s.send(i);
+            EXPECT_TRUE(status.has_value());
+        }
+
+        s.close();
+    });
+
+    int expected = 0;
+    for (const auto actual : r) {
+        EXPECT_EQ(actual, expected);
+        expected++;
     }
+    EXPECT_EQ(expected, max);
 
-    s.close();
+    producer.join();
+}
+
+TEST(SingleBounded, SpscSendOneInt)
+{
+    using namespace nrws;
+
+    auto [s, r] = single::bounded<int>(4U);
+
+    EXPECT_TRUE(s.send(1).has_value());
+
+    const auto value = r.receive();
+    ASSERT_TRUE(value.has_value());
+    EXPECT_EQ(value.value(), 1);
+}
+
+TEST(SingleBounded, SpscTwoThreads)
+{
+    using namespace nrws;
+
+    constexpr int max = 100000;
+
+    auto [s, r] = single::bounded<int>(15U);
+
+    std::thread producer([s = std::move(s)]() mutable {
+        for (int i = 0; i < max; i++) { EXPECT_TRUE(s.send(i).has_value()); }
+    });
 
+    // the sender closes the channel when it goes out of scope in the producer thread
     int expected = 0;
     for (const auto actual : r) {
         EXPECT_EQ(actual, expected);
         expected++;
     }
+    EXPECT_EQ(expected, max);
+
+    producer.join();
+}
+
+TEST(SingleBounded, SpscCloseDrains)
+{
+    using namespace nrws;
+
+    auto [s, r] = single::bounded<int>(4U);
+    EXPECT_TRUE(s.send(1).has_value());
+    EXPECT_TRUE(s.send(2).has_value());
+    s.close();
+
+    EXPECT_FALSE(s.send(3).has_value());
+    EXPECT_EQ(r.receive().value(), 1);
+    EXPECT_EQ(r.receive().value(), 2);
+
+    const auto closed = r.receive();
+    ASSERT_FALSE(closed.has_value());
+    EXPECT_EQ(closed.error(), error_id::channel_disconnected);
+}
+
+TEST(SingleBounded, SpscReceiverDropDisconnects)
+{
+    using namespace nrws;
+
+    auto [s, r] = single::bounded<int>(1U);
+    EXPECT_TRUE(s.send(1).has_value());
+
+    // the sender is blocked on a full channel until the receiver goes away
+    std::thread dropper([r = std::move(r)]() mutable { auto dropped = std::move(r); });
+
+    const auto status = s.send(2);
+    ASSERT_FALSE(status.has_value());
+    EXPECT_EQ(status.error(), error_id::channel_disconnected);
+
+    dropper.join();
+}
+
+TEST(SingleBounded, SpscNonDefaultConstructible)
+{
+    using namespace nrws;
+
+    struct no_default
+    {
+        explicit no_default(std::string v) : value(std::move(v)) {}
+        std::string value;
+    };
+
+    auto [s, r] = single::bounded<no_default>(2U);
+    EXPECT_TRUE(s.send(no_default{ "hello" }).has_value());
+    EXPECT_TRUE(s.send(no_default{ "world" }).has_value());
+
+    EXPECT_EQ(r.receive().value().value, "hello");
+    EXPECT_EQ(r.receive().value().value, "world");
 }
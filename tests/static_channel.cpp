@@ -0,0 +1,125 @@
+#include "narrows/bounded.hpp"
+#include "narrows/single_bounded.hpp"
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// constexpr constructible with a wait policy that has no runtime state
+constinit nrws::static_channel<int, 4, nrws::spin_wait> global_channel;
+
+TEST(StaticChannel, Construction)
+{
+    using namespace nrws;
+
+    static_channel<int, 16> ch;
+    static_assert(static_channel<int, 16>::extent == 16U);
+    static_assert(sizeof(static_channel<int, 16>) >= 16U * sizeof(int));
+    EXPECT_EQ(ch.capacity(), 16U);
+    EXPECT_EQ(ch.size(), 0U);
+    EXPECT_TRUE(ch.empty());
+    EXPECT_FALSE(ch.closed());
+}
+
+TEST(StaticChannel, ConstinitGlobal)
+{
+    EXPECT_TRUE(global_channel.push(1));
+    EXPECT_TRUE(global_channel.push(2));
+    EXPECT_EQ(global_channel.pop(), std::optional<int>(1));
+    EXPECT_EQ(global_channel.pop(), std::optional<int>(2));
+}
+
+TEST(StaticChannel, EmbeddedInParent)
+{
+    struct parent
+    {
+        int id{ 7 };
+        nrws::static_channel<std::string, 2> inbox;
+    };
+
+    auto owner = std::make_unique<parent>();
+    EXPECT_TRUE(owner->inbox.push("a"));
+    EXPECT_TRUE(owner->inbox.push("b"));
+    EXPECT_TRUE(owner->inbox.full());
+    EXPECT_EQ(owner->inbox.pop(), std::optional<std::string>("a"));
+
+    // the value left behind is destroyed with the parent
+    EXPECT_EQ(owner->inbox.size(), 1U);
+}
+
+template<typename Channel>
+class StaticChannelWrap : public ::testing::Test
+{
+};
+
+// power of two extents wrap with a mask, the others with a modulo
+using StaticChannels = ::testing::Types<nrws::static_channel<int, 1>,
+    nrws::static_channel<int, 3>,
+    nrws::static_channel<int, 8>,
+    nrws::static_channel<int, 8, nrws::yield_wait>>;
+TYPED_TEST_SUITE(StaticChannelWrap, StaticChannels);
+
+TYPED_TEST(StaticChannelWrap, WrapsAround)
+{
+    TypeParam ch;
+
+    for (int lap = 0; lap < 5; lap++) {
+        for (std::size_t i = 0; i < ch.capacity(); i++) { EXPECT_TRUE(ch.push(static_cast<int>(i) + lap)); }
+        EXPECT_TRUE(ch.full());
+
+        for (std::size_t i = 0; i < ch.capacity(); i++) {
+            EXPECT_EQ(ch.pop(), std::optional<int>(static_cast<int>(i) + lap));
+        }
+        EXPECT_TRUE(ch.empty());
+    }
+}
+
+TYPED_TEST(StaticChannelWrap, MultipleProducers)
+{
+    constexpr static int producers = 4;
+    constexpr static int max = 2000;
+
+    TypeParam ch;
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&ch]() {
+            for (int i = 1; i <= max; i++) { EXPECT_TRUE(ch.push(i)); }
+        });
+    }
+
+    long long sum = 0;
+    for (int i = 0; i < producers * max; i++) {
+        const auto value = ch.pop();
+        ASSERT_TRUE(value.has_value());
+        sum += value.value();
+    }
+
+    for (auto &thread : threads) { thread.join(); }
+    EXPECT_EQ(sum, static_cast<long long>(producers) * max * (max + 1) / 2);
+}
+
+TEST(StaticChannel, SenderReceiver)
+{
+    using namespace nrws;
+
+    constexpr int max = 1000;
+
+    auto [s, r] = bounded<int, 64>();
+
+    std::thread producer([&s]() {
+        for (int i = 0; i < max; i++) { EXPECT_TRUE(s.send(i).has_value()); }
+        s.close();
+    });
+
+    int expected = 0;
+    for (const auto actual : r) {
+        EXPECT_EQ(actual, expected);
+        expected++;
+    }
+    EXPECT_EQ(expected, max);
+
+    producer.join();
+}
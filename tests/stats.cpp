@@ -0,0 +1,202 @@
+#include "narrows/narrows.hpp"
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iterator>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+template<typename Channel>
+auto make_channel(const std::size_t capacity)
+{
+    if constexpr (requires { Channel(capacity); }) {
+        return std::make_unique<Channel>(capacity);
+    } else {
+        return std::make_unique<Channel>();
+    }
+}
+
+template<typename T>
+concept has_stats = requires(const T &t) { t.stats(); };
+
+template<typename Channel>
+class StatsTest : public testing::Test
+{
+};
+
+using InstrumentedChannels = testing::Types<nrws::bounded_channel<int, nrws::instrumented<>>,
+    nrws::array_channel<int, nrws::instrumented<>>,
+    nrws::static_channel<int, 8, nrws::instrumented<>>,
+    nrws::list_channel<int, nrws::instrumented<>>,
+    nrws::_spsc_ring<int, nrws::instrumented<>>>;
+TYPED_TEST_SUITE(StatsTest, InstrumentedChannels);
+
+}// namespace
+
+TYPED_TEST(StatsTest, CountsTraffic)
+{
+    auto ch = make_channel<TypeParam>(8U);
+
+    for (int i = 0; i < 5; i++) { EXPECT_TRUE(ch->push(i)); }
+    const std::vector<int> batch{ 5, 6 };
+    EXPECT_EQ(ch->push_many(batch.begin(), batch.end()), 2U);
+
+    EXPECT_EQ(ch->pop(), 0);
+    std::vector<int> received;
+    EXPECT_EQ(ch->pop_many(std::back_inserter(received), 3U), 3U);
+
+    const auto stats = ch->stats();
+    EXPECT_EQ(stats.sends, 7U);
+    EXPECT_EQ(stats.receives, 4U);
+    EXPECT_EQ(stats.high_water, 7U);
+    EXPECT_EQ(stats.blocked_sends, 0U);
+    EXPECT_EQ(stats.blocked_receives, 0U);
+    EXPECT_EQ(stats.residency.count(), 4U);
+}
+
+TYPED_TEST(StatsTest, RecordsResidency)
+{
+    auto ch = make_channel<TypeParam>(8U);
+
+    EXPECT_TRUE(ch->push(1));
+    std::this_thread::sleep_for(5ms);
+    EXPECT_EQ(ch->pop(), 1);
+
+    // the histogram is accurate to an eighth of the value
+    const auto stats = ch->stats();
+    EXPECT_EQ(stats.residency.count(), 1U);
+    EXPECT_GE(stats.residency.percentile(0.5), 5ms * 7 / 8);
+    EXPECT_LT(stats.residency.percentile(0.5), 1s);
+}
+
+TYPED_TEST(StatsTest, CountsWaitingReceivers)
+{
+    auto ch = make_channel<TypeParam>(8U);
+
+    std::thread sender([&ch]() {
+        std::this_thread::sleep_for(5ms);
+        EXPECT_TRUE(ch->push(1));
+    });
+    EXPECT_EQ(ch->pop(), 1);
+    sender.join();
+
+    const auto stats = ch->stats();
+    EXPECT_GE(stats.blocked_receives, 1U);
+    EXPECT_GE(stats.parked, 1ms);
+}
+
+TEST(Stats, CountsWaitingSenders)
+{
+    using namespace nrws;
+
+    auto [s, r] = bounded<int, instrumented_backend<array_channel>::type>(2);
+    EXPECT_TRUE(s.send(1).has_value());
+    EXPECT_TRUE(s.send(2).has_value());
+
+    std::thread receiver([&r]() {
+        std::this_thread::sleep_for(5ms);
+        EXPECT_EQ(r.receive().value(), 1);
+    });
+    EXPECT_TRUE(s.send(3).has_value());
+    receiver.join();
+
+    // either end reads the same statistics
+    EXPECT_GE(s.stats().blocked_sends, 1U);
+    EXPECT_EQ(r.stats().sends, 3U);
+    EXPECT_EQ(r.stats().high_water, 2U);
+}
+
+TEST(Stats, SingleProducerEnds)
+{
+    using namespace nrws;
+
+    auto [s, r] = single::bounded<int, instrumented<>>(4U);
+    EXPECT_TRUE(s.send(1).has_value());
+    std::this_thread::sleep_for(5ms);
+    EXPECT_EQ(r.receive().value(), 1);
+
+    EXPECT_EQ(s.stats().sends, 1U);
+    EXPECT_EQ(r.stats().residency.count(), 1U);
+    EXPECT_GE(r.stats().residency.percentile(0.5), 5ms * 7 / 8);
+    static_assert(!has_stats<decltype(single::bounded<int>(4U).first)>);
+}
+
+TEST(Stats, CountsLockContention)
+{
+    using namespace nrws;
+
+    constexpr int producers = 4;
+    constexpr int count = 20'000;
+
+    bounded_channel<int, instrumented<>> ch(64);
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&ch]() {
+            for (int i = 0; i < count; i++) { ch.push(i); }
+        });
+    }
+
+    for (int i = 0; i < producers * count; i++) { static_cast<void>(ch.pop()); }
+    for (auto &thread : threads) { thread.join(); }
+
+    // whether threads ever collide depends on the machine, but every value is accounted for
+    const auto stats = ch.stats();
+    EXPECT_EQ(stats.sends, static_cast<std::uint64_t>(producers * count));
+    EXPECT_EQ(stats.receives, static_cast<std::uint64_t>(producers * count));
+    EXPECT_EQ(stats.residency.count(), static_cast<std::uint64_t>(producers * count));
+    EXPECT_LE(stats.high_water, 64U);
+}
+
+TEST(Stats, StripedChannelCountsTraffic)
+{
+    using namespace nrws;
+
+    striped_channel<int, instrumented<>> ch(64, 4U);
+    for (int i = 0; i < 10; i++) { EXPECT_TRUE(ch.push(i)); }
+    for (int i = 0; i < 10; i++) { static_cast<void>(ch.pop()); }
+
+    const auto stats = ch.stats();
+    EXPECT_EQ(stats.sends, 10U);
+    EXPECT_EQ(stats.receives, 10U);
+}
+
+TEST(Stats, DisabledStatsCompileAway)
+{
+    using namespace nrws;
+
+    static_assert(std::is_empty_v<_no_stats>);
+    static_assert(std::is_empty_v<_no_entry_time>);
+    static_assert(std::is_empty_v<_no_entry_times>);
+    static_assert(!has_stats<bounded_channel<int>>);
+    static_assert(!has_stats<Sender<int, array_channel>>);
+    static_assert(has_stats<Sender<int, instrumented_backend<array_channel>::type>>);
+
+    // an instrumented slot is only bigger by its entry time
+    EXPECT_GT(sizeof(static_channel<int, 8, instrumented<>>), sizeof(static_channel<int, 8>));
+}
+
+TEST(Stats, HistogramBuckets)
+{
+    using namespace nrws;
+
+    // exact below sub_buckets, then within an eighth
+    for (std::uint64_t value = 0U; value < 100'000U; value += 7U) {
+        const auto bucket = residency_histogram::bucket_of(value);
+        EXPECT_LE(residency_histogram::lower_bound(bucket), value);
+        EXPECT_GT(residency_histogram::lower_bound(bucket + 1U), value);
+        EXPECT_LE(value - residency_histogram::lower_bound(bucket), value / residency_histogram::sub_buckets);
+    }
+    EXPECT_EQ(residency_histogram::bucket_of(UINT64_MAX), residency_histogram::buckets - 1U);
+
+    residency_histogram histogram;
+    for (std::uint64_t value = 1U; value <= 1000U; value++) { histogram.counts[residency_histogram::bucket_of(value)]++; }
+    EXPECT_EQ(histogram.count(), 1000U);
+    EXPECT_NEAR(static_cast<double>(histogram.percentile(0.5).count()), 500.0, 500.0 / 8.0);
+    EXPECT_NEAR(static_cast<double>(histogram.percentile(0.99).count()), 990.0, 990.0 / 8.0);
+    EXPECT_GE(histogram.percentile(1.0).count(), 1000);
+}
@@ -0,0 +1,269 @@
+#include "narrows/bounded.hpp"
+#include "narrows/single_bounded.hpp"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+TEST(StripedChannel, Construction)
+{
+    using namespace nrws;
+
+    striped_channel<int> ch(15, 4U);
+    EXPECT_EQ(ch.stripes(), 4U);
+    // stripes of 4, 4, 4 and 3 slots
+    EXPECT_EQ(ch.capacity(), 15U);
+    EXPECT_EQ(ch.size(), 0U);
+    EXPECT_TRUE(ch.empty());
+}
+
+TEST(StripedChannel, DefaultStripesKeepRoom)
+{
+    using namespace nrws;
+
+    // too small to split
+    striped_channel<int> small(20);
+    EXPECT_EQ(small.stripes(), 1U);
+    EXPECT_EQ(small.capacity(), 20U);
+
+    striped_channel<int> large(4096);
+    EXPECT_GE(large.stripes(), 1U);
+    EXPECT_LE(large.stripes(), 4096U / striped_channel<int>::min_stripe_capacity);
+    EXPECT_EQ(large.capacity(), 4096U);
+
+    // never more stripes than slots
+    striped_channel<int> tiny(3, 8U);
+    EXPECT_EQ(tiny.stripes(), 3U);
+    EXPECT_EQ(tiny.capacity(), 3U);
+}
+
+TEST(StripedChannel, HomesArePerChannel)
+{
+    using namespace nrws;
+
+    striped_channel<int> other(8, 2U);
+    striped_channel<int> ch(2, 2U);
+
+    // producers of another channel in between don't push two producers of this one into the same
+    // stripe
+    for (int i = 0; i < 2; i++) {
+        std::thread([&other, i]() { EXPECT_TRUE(other.push(i)); }).join();
+        std::thread([&ch, i]() { EXPECT_EQ(ch.try_push(i), channel_status::success); }).join();
+    }
+    EXPECT_EQ(ch.size(), 2U);
+}
+
+TEST(StripedChannel, ManyShortLivedProducers)
+{
+    using namespace nrws;
+
+    striped_channel<int> ch(4, 2U);
+
+    // more threads than the channel remembers homes for, each one still sends on a stripe of its own
+    for (int i = 0; i < 200; i++) {
+        std::thread([&ch, i]() {
+            EXPECT_EQ(ch.try_push(2 * i), channel_status::success);
+            EXPECT_EQ(ch.try_push(2 * i + 1), channel_status::success);
+        }).join();
+        EXPECT_EQ(ch.pop(), std::optional<int>(2 * i));
+        EXPECT_EQ(ch.pop(), std::optional<int>(2 * i + 1));
+    }
+    EXPECT_TRUE(ch.empty());
+}
+
+TEST(StripedChannel, FullIsPerProducer)
+{
+    using namespace nrws;
+
+    striped_channel<int> ch(4, 2U);
+
+    // one thread only ever fills its own stripe
+    EXPECT_EQ(ch.try_push(1), channel_status::success);
+    EXPECT_EQ(ch.try_push(2), channel_status::success);
+    EXPECT_EQ(ch.try_push(3), channel_status::full);
+    EXPECT_TRUE(ch.full());
+
+    // another producer still has room
+    std::thread other([&ch]() {
+        EXPECT_FALSE(ch.full());
+        EXPECT_EQ(ch.try_push(4), channel_status::success);
+    });
+    other.join();
+
+    EXPECT_EQ(ch.size(), 3U);
+}
+
+TEST(StripedChannel, RoomWakesProducersOfThatStripe)
+{
+    using namespace nrws;
+    using namespace std::chrono_literals;
+
+    striped_channel<int> ch(2, 2U);
+    std::atomic<int> sent{ 0 };
+    std::atomic<int> refused{ 0 };
+
+    // each producer fills its own one slot stripe and then waits for room in it
+    std::vector<std::thread> producers;
+    for (int i = 0; i < 2; i++) {
+        producers.emplace_back([&ch, &sent, &refused, i]() {
+            EXPECT_TRUE(ch.push(10 * i));
+            (ch.push(10 * i + 1) ? sent : refused).fetch_add(1);
+        });
+    }
+    while (ch.size() != 2U) { std::this_thread::yield(); }
+    std::this_thread::sleep_for(20ms);
+    EXPECT_EQ(sent.load(), 0);
+
+    // only the producer homed on the stripe the value came from gets through
+    const auto value = ch.pop();
+    ASSERT_TRUE(value.has_value());
+    for (int i = 0; i < 100 && sent.load() == 0; i++) { std::this_thread::sleep_for(10ms); }
+    std::this_thread::sleep_for(20ms);
+    EXPECT_EQ(sent.load(), 1);
+
+    // and closing still wakes the other one
+    ch.close();
+    for (auto &producer : producers) { producer.join(); }
+    EXPECT_EQ(refused.load(), 1);
+}
+
+TEST(StripedChannel, SpillsWithoutProducerOrder)
+{
+    using namespace nrws;
+
+    striped_channel<std::string> ch(4, 2U, false);
+    for (int i = 0; i < 4; i++) { EXPECT_EQ(ch.try_push(std::to_string(i)), channel_status::success); }
+    EXPECT_EQ(ch.try_push("full"), channel_status::full);
+
+    int count = 0;
+    while (ch.try_pop().has_value()) { count++; }
+    EXPECT_EQ(count, 4);
+}
+
+TEST(StripedChannel, KeepsProducerOrder)
+{
+    using namespace nrws;
+
+    constexpr static int producers = 8;
+    constexpr static int per_producer = 5'000;
+
+    // producer in the high bits, sequence in the low bits
+    auto [s, r] = bounded<int, striped_channel>(256, 4U);
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([s, p]() mutable {
+            for (int i = 0; i < per_producer; i++) { EXPECT_TRUE(s.send((p << 16) | i).has_value()); }
+        });
+    }
+
+    std::vector<int> last(producers, -1);
+    for (int i = 0; i < producers * per_producer; i++) {
+        const auto value = r.receive().value();
+        const auto producer = static_cast<std::size_t>(value >> 16);
+        EXPECT_GT(value & 0xFFFF, last[producer]);
+        last[producer] = value & 0xFFFF;
+    }
+
+    for (auto &thread : threads) { thread.join(); }
+    for (const auto sequence : last) { EXPECT_EQ(sequence, per_producer - 1); }
+}
+
+TEST(StripedChannel, Batches)
+{
+    using namespace nrws;
+
+    // a producer only has its own stripe of 16
+    auto [s, r] = bounded<int, striped_channel>(64, 4U);
+
+    std::vector<int> values(16);
+    for (std::size_t i = 0U; i < values.size(); i++) { values[i] = static_cast<int>(i); }
+    EXPECT_EQ(s.send_many(values).value(), 16U);
+
+    std::vector<int> received;
+    EXPECT_EQ(r.receive_many(std::back_inserter(received), 64U).value(), 16U);
+    EXPECT_EQ(received, values);
+}
+
+TEST(StripedChannel, TimestampDrainFollowsSendOrder)
+{
+    using namespace nrws;
+
+    timestamp_striped_channel<int> ch(64, 4U);
+
+    // each value is pushed from a different thread, so they land in different stripes
+    for (int i = 0; i < 8; i++) {
+        std::thread producer([&ch, i]() { EXPECT_TRUE(ch.push(i)); });
+        producer.join();
+    }
+
+    for (int i = 0; i < 8; i++) { EXPECT_EQ(ch.pop().value(), i); }
+}
+
+TEST(StripedChannel, TimestampDrainManyConsumers)
+{
+    using namespace nrws;
+
+    constexpr static int producers = 4;
+    constexpr static int consumers = 3;
+    constexpr static int per_producer = 5'000;
+
+    // consumers compare the fronts of stripes that other consumers are taking at the same time
+    timestamp_striped_channel<std::string> ch(16, 4U);
+
+    std::atomic<int> count{ 0 };
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&ch]() {
+            for (int i = 0; i < per_producer; i++) { EXPECT_TRUE(ch.push(std::to_string(i))); }
+        });
+    }
+    std::vector<std::thread> receivers;
+    for (int c = 0; c < consumers; c++) {
+        receivers.emplace_back([&ch, &count]() {
+            while (ch.pop()) { count++; }
+        });
+    }
+
+    for (auto &thread : threads) { thread.join(); }
+    ch.close();
+    for (auto &thread : receivers) { thread.join(); }
+
+    EXPECT_EQ(count.load(), producers * per_producer);
+}
+
+TEST(StripedChannel, ManyProducersManyConsumers)
+{
+    using namespace nrws;
+
+    constexpr static int producers = 8;
+    constexpr static int consumers = 3;
+    constexpr static int per_producer = 5'000;
+
+    striped_channel<int> ch(128, 4U);
+
+    std::atomic<long long> sum{ 0 };
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&ch]() {
+            for (int i = 1; i <= per_producer; i++) { EXPECT_TRUE(ch.push(i)); }
+        });
+    }
+    std::vector<std::thread> receivers;
+    for (int c = 0; c < consumers; c++) {
+        receivers.emplace_back([&ch, &sum]() {
+            while (const auto value = ch.pop()) { sum += *value; }
+        });
+    }
+
+    for (auto &thread : threads) { thread.join(); }
+    ch.close();
+    for (auto &thread : receivers) { thread.join(); }
+
+    EXPECT_EQ(sum.load(), static_cast<long long>(producers) * per_producer * (per_producer + 1) / 2);
+}
@@ -0,0 +1,154 @@
+#include "narrows/bounded.hpp"
+#include "narrows/single_bounded.hpp"
+#include "narrows/unbounded.hpp"
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+template<typename Channel>
+class TryOps : public ::testing::Test
+{
+};
+
+using TryOpsChannels = ::testing::Types<nrws::bounded_channel<int>,
+    nrws::array_channel<int>,
+    nrws::array_channel<int, nrws::spin_wait>,
+    nrws::_spsc_ring<int>,
+    nrws::_spsc_ring<int, nrws::yield_wait>>;
+TYPED_TEST_SUITE(TryOps, TryOpsChannels);
+
+TYPED_TEST(TryOps, FullEmptyAndClosed)
+{
+    using nrws::channel_status;
+
+    TypeParam ch(2);
+
+    const auto empty = ch.try_pop();
+    ASSERT_FALSE(empty.has_value());
+    EXPECT_EQ(empty.error(), channel_status::empty);
+
+    EXPECT_EQ(ch.try_push(1), channel_status::success);
+    EXPECT_EQ(ch.try_push(2), channel_status::success);
+    EXPECT_EQ(ch.try_push(3), channel_status::full);
+
+    EXPECT_EQ(ch.try_pop(), 1);
+    EXPECT_EQ(ch.try_push(3), channel_status::success);
+    ch.close();
+
+    // values sent before the close are still received
+    EXPECT_EQ(ch.try_push(4), channel_status::closed);
+    EXPECT_EQ(ch.try_pop(), 2);
+    EXPECT_EQ(ch.try_pop(), 3);
+
+    const auto closed = ch.try_pop();
+    ASSERT_FALSE(closed.has_value());
+    EXPECT_EQ(closed.error(), channel_status::closed);
+}
+
+TYPED_TEST(TryOps, DeadlinesExpire)
+{
+    using nrws::channel_status;
+
+    TypeParam ch(1);
+
+    const auto nothing = ch.pop_until(std::chrono::steady_clock::now() + 5ms);
+    ASSERT_FALSE(nothing.has_value());
+    EXPECT_EQ(nothing.error(), channel_status::timeout);
+
+    EXPECT_EQ(ch.push_until(1, std::chrono::steady_clock::now() + 5ms), channel_status::success);
+    EXPECT_EQ(ch.push_until(2, std::chrono::steady_clock::now() + 5ms), channel_status::timeout);
+
+    EXPECT_EQ(ch.pop_until(std::chrono::steady_clock::now() + 5ms), 1);
+}
+
+TYPED_TEST(TryOps, DeadlineWaitsForTheOtherSide)
+{
+    using nrws::channel_status;
+
+    TypeParam ch(1);
+    EXPECT_EQ(ch.try_push(1), channel_status::success);
+
+    std::thread consumer([&ch]() {
+        std::this_thread::sleep_for(5ms);
+        EXPECT_EQ(ch.pop_until(std::chrono::steady_clock::now() + 10s), 1);
+        EXPECT_EQ(ch.pop_until(std::chrono::steady_clock::now() + 10s), 2);
+    });
+
+    EXPECT_EQ(ch.push_until(2, std::chrono::steady_clock::now() + 10s), channel_status::success);
+    consumer.join();
+}
+
+TEST(TryOps, FailedTryPushKeepsTheValue)
+{
+    nrws::array_channel<std::unique_ptr<int>> ch(1);
+
+    auto first = std::make_unique<int>(1);
+    auto second = std::make_unique<int>(2);
+    EXPECT_EQ(ch.try_push(std::move(first)), nrws::channel_status::success);
+    EXPECT_EQ(ch.try_push(std::move(second)), nrws::channel_status::full);
+    ASSERT_NE(second, nullptr);
+    EXPECT_EQ(*second, 2);
+}
+
+TEST(TryOps, UnboundedNeverFull)
+{
+    using nrws::channel_status;
+
+    nrws::channel<std::string> ch;
+    for (int i = 0; i < 100; i++) { EXPECT_EQ(ch.try_push(std::to_string(i)), channel_status::success); }
+    EXPECT_EQ(ch.push_until("last", std::chrono::steady_clock::now()), channel_status::success);
+
+    for (int i = 0; i < 100; i++) { EXPECT_EQ(ch.try_pop(), std::to_string(i)); }
+    EXPECT_EQ(ch.pop_until(std::chrono::steady_clock::now() + 1ms), "last");
+    EXPECT_EQ(ch.pop_until(std::chrono::steady_clock::now() + 1ms).error(), channel_status::timeout);
+}
+
+TEST(TryOps, SenderReceiver)
+{
+    using namespace nrws;
+
+    auto [s, r] = bounded<int, array_channel>(1U);
+
+    EXPECT_EQ(r.try_receive().error(), receiver_error_t::ChannelEmpty);
+    EXPECT_EQ(r.receive_for(1ms).error(), receiver_error_t::Timeout);
+
+    EXPECT_TRUE(s.try_send(1).has_value());
+    EXPECT_EQ(s.try_send(2).error(), sender_error_t::ChannelFull);
+    EXPECT_EQ(s.send_for(2, 1ms).error(), sender_error_t::Timeout);
+
+    EXPECT_EQ(r.try_receive().value(), 1);
+    EXPECT_TRUE(s.send_until(2, std::chrono::steady_clock::now() + 1ms).has_value());
+    s.close();
+
+    EXPECT_EQ(s.try_send(3).error(), sender_error_t::ChannelClosed);
+    EXPECT_EQ(r.receive_until(std::chrono::steady_clock::now() + 1ms).value(), 2);
+    EXPECT_EQ(r.receive_for(1ms).error(), receiver_error_t::ChannelClosed);
+    EXPECT_EQ(r.try_receive().error(), receiver_error_t::ChannelClosed);
+}
+
+TEST(TryOps, SingleSenderReceiver)
+{
+    using namespace nrws;
+
+    auto [s, r] = single::bounded<int>(1U);
+
+    EXPECT_EQ(r.try_receive().error(), error_id::channel_empty);
+    EXPECT_EQ(r.receive_timeout(1ms).error(), error_id::channel_empty);
+
+    EXPECT_TRUE(s.try_send(1).has_value());
+    EXPECT_EQ(s.try_send(2).error(), error_id::channel_full);
+    EXPECT_EQ(s.send_timeout(2, 1ms).error(), error_id::channel_full);
+
+    EXPECT_EQ(r.try_receive().value(), 1);
+    EXPECT_TRUE(s.send_timeout(2, 1ms).has_value());
+    s.close();
+
+    EXPECT_EQ(s.try_send(3).error(), error_id::channel_disconnected);
+    EXPECT_EQ(r.receive_timeout(1ms).value(), 2);
+    EXPECT_EQ(r.try_receive().error(), error_id::channel_disconnected);
+}
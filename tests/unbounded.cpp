@@ -0,0 +1,233 @@
+#include "narrows/unbounded.hpp"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <iterator>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(Unbounded, IntConstruction)
+{
+    using namespace nrws;
+
+    list_channel<int> ch;
+    EXPECT_EQ(ch.size(), 0);
+    EXPECT_TRUE(ch.empty());
+    EXPECT_FALSE(ch.full());
+    EXPECT_FALSE(ch.closed());
+}
+
+TEST(Unbounded, IntPushPopAcrossBlocks)
+{
+    using namespace nrws;
+
+    constexpr static int max = 1000;
+
+    list_channel<int> ch;
+    for (int i = 0; i < max; i++) { EXPECT_TRUE(ch.push(i)); }
+    EXPECT_EQ(ch.size(), static_cast<std::size_t>(max));
+
+    for (int i = 0; i < max; i++) {
+        const auto value = ch.pop();
+        ASSERT_TRUE(value.has_value());
+        EXPECT_EQ(value.value(), i);
+        EXPECT_EQ(ch.size(), static_cast<std::size_t>(max - i - 1));
+    }
+    EXPECT_TRUE(ch.empty());
+}
+
+TEST(Unbounded, ReservedSlotReadsAsEmpty)
+{
+    using namespace nrws;
+
+    list_channel<int> ch;
+    auto slot = ch.reserve(1);
+    ASSERT_TRUE(slot.has_value());
+
+    // claimed but not written yet
+    EXPECT_TRUE(ch.empty());
+    slot->commit();
+    EXPECT_FALSE(ch.empty());
+
+    EXPECT_EQ(ch.pop(), 1);
+    EXPECT_TRUE(ch.empty());
+}
+
+TEST(Unbounded, TryAndTimedPopsSkipReservedSlot)
+{
+    using namespace nrws;
+    using namespace std::chrono_literals;
+
+    list_channel<int> ch;
+    auto slot = ch.reserve(1);
+    ASSERT_TRUE(slot.has_value());
+
+    // a value pushed behind the held slot isn't reachable until the slot is written
+    ch.push(2);
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto value = ch.try_pop();
+    ASSERT_FALSE(value.has_value());
+    EXPECT_EQ(value.error(), channel_status::empty);
+
+    std::vector<int> out;
+    const auto many = ch.try_pop_many(std::back_inserter(out), 4U);
+    ASSERT_FALSE(many.has_value());
+    EXPECT_EQ(many.error(), channel_status::empty);
+
+    const auto timed = ch.pop_until(std::chrono::steady_clock::now() + 10ms);
+    ASSERT_FALSE(timed.has_value());
+    EXPECT_EQ(timed.error(), channel_status::timeout);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 400ms);
+
+    slot->commit();
+    EXPECT_EQ(ch.try_pop(), 1);
+    EXPECT_EQ(ch.try_pop(), 2);
+}
+
+TEST(Unbounded, EmptyWhileBlocksAreFreed)
+{
+    using namespace nrws;
+
+    constexpr static int producers = 2;
+    constexpr static int consumers = 2;
+    constexpr static int per_producer = 20'000;
+
+    // nothing is pooled, every block read to the end goes back to the allocator
+    list_channel<std::string> ch(0U);
+
+    std::atomic<bool> done{ false };
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&ch]() {
+            for (int i = 0; i < per_producer; i++) { EXPECT_TRUE(ch.push(std::to_string(i) + " padding past the small string buffer")); }
+        });
+    }
+    std::atomic<int> received{ 0 };
+    for (int c = 0; c < consumers; c++) {
+        threads.emplace_back([&ch, &received]() {
+            while (ch.pop().has_value()) { received++; }
+        });
+    }
+    // looks at head slots while the blocks around them are freed
+    std::thread watcher([&ch, &done]() {
+        while (!done) { static_cast<void>(ch.empty()); }
+    });
+
+    for (int p = 0; p < producers; p++) { threads[static_cast<std::size_t>(p)].join(); }
+    ch.close();
+    for (auto &thread : threads) {
+        if (thread.joinable()) { thread.join(); }
+    }
+    done = true;
+    watcher.join();
+
+    EXPECT_EQ(received.load(), producers * per_producer);
+    EXPECT_TRUE(ch.empty());
+}
+
+TEST(Unbounded, IntClose)
+{
+    using namespace nrws;
+
+    list_channel<int> ch;
+    ch.push(1);
+    ch.push(2);
+    ch.close();
+
+    EXPECT_TRUE(ch.closed());
+    EXPECT_FALSE(ch.push(3));
+
+    EXPECT_EQ(ch.pop().value(), 1);
+    EXPECT_EQ(ch.pop().value(), 2);
+    EXPECT_FALSE(ch.pop().has_value());
+}
+
+TEST(Unbounded, StringNotReceivedIsDestroyed)
+{
+    using namespace nrws;
+
+    list_channel<std::string> ch;
+    for (int i = 0; i < 100; i++) { ch.push(std::string(64, 'a')); }
+    for (int i = 0; i < 40; i++) { EXPECT_EQ(ch.pop().value(), std::string(64, 'a')); }
+}
+
+TEST(Unbounded, BatchesAcrossBlocks)
+{
+    using namespace nrws;
+
+    constexpr static int max = 500;
+
+    list_channel<int> ch;
+    std::vector<int> values(max);
+    std::iota(values.begin(), values.end(), 0);
+    EXPECT_EQ(ch.push_many(values.begin(), values.end()), static_cast<std::size_t>(max));
+    ch.close();
+
+    std::vector<int> received;
+    while (ch.pop_many(std::back_inserter(received), 45U) != 0U) {}
+    EXPECT_EQ(received, values);
+}
+
+TEST(Unbounded, IntIterMultipleWriteReadThreads)
+{
+    using namespace nrws;
+
+    constexpr static int max = 20000;
+    constexpr static int producers = 4;
+    constexpr static int consumers = 4;
+
+    list_channel<int> ch;
+    std::atomic<long long> sum{ 0 };
+    std::atomic<int> count{ 0 };
+
+    std::vector<std::thread> producer_threads;
+    for (int p = 0; p < producers; p++) {
+        producer_threads.emplace_back([&ch]() {
+            for (int i = 1; i <= max; i++) { ch.push(i); }
+        });
+    }
+
+    std::vector<std::thread> consumer_threads;
+    for (int c = 0; c < consumers; c++) {
+        consumer_threads.emplace_back([&ch, &sum, &count]() {
+            for (const auto value : ch.batched(64U)) {
+                sum += value;
+                count++;
+            }
+        });
+    }
+
+    for (auto &t : producer_threads) { t.join(); }
+    ch.close();
+    for (auto &t : consumer_threads) { t.join(); }
+
+    EXPECT_EQ(count.load(), producers * max);
+    EXPECT_EQ(sum.load(), static_cast<long long>(producers) * max * (max + 1) / 2);
+}
+
+TEST(Unbounded, SenderReceiver)
+{
+    using namespace nrws;
+
+    constexpr int max = 1000;
+
+    auto [s, r] = unbounded<int>();
+
+    std::thread producer([&s]() {
+        for (int i = 0; i < max; i++) { EXPECT_TRUE(s.send(i).has_value()); }
+        s.close();
+    });
+
+    int expected = 0;
+    for (const auto actual : r) {
+        EXPECT_EQ(actual, expected);
+        expected++;
+    }
+    EXPECT_EQ(expected, max);
+
+    producer.join();
+}
@@ -0,0 +1,102 @@
+#include "narrows/bounded.hpp"
+#include "narrows/single_bounded.hpp"
+#include "narrows/unbounded.hpp"
+#include "narrows/wait.hpp"
+#include <gtest/gtest.h>
+
+#include <thread>
+
+template<typename T>
+using yield_array_channel = nrws::array_channel<T, nrws::yield_wait>;
+
+template<typename Channel>
+class WaitPolicy : public ::testing::Test
+{
+};
+
+using WaitPolicyChannels = ::testing::Types<nrws::bounded_channel<int, nrws::spin_wait>,
+    nrws::bounded_channel<int, nrws::yield_wait>,
+    nrws::bounded_channel<int, nrws::park_wait>,
+    nrws::array_channel<int, nrws::spin_wait>,
+    nrws::array_channel<int, nrws::yield_wait>,
+    nrws::array_channel<int, nrws::park_wait>,
+    nrws::_spsc_ring<int, nrws::spin_wait>,
+    nrws::_spsc_ring<int, nrws::yield_wait>,
+    nrws::_spsc_ring<int, nrws::park_wait>>;
+TYPED_TEST_SUITE(WaitPolicy, WaitPolicyChannels);
+
+TYPED_TEST(WaitPolicy, FullAndEmptyHandoff)
+{
+    // kept small, a spinning thread on a machine with few cores only hands off once per
+    // scheduler tick
+    constexpr static int max = 200;
+
+    // a tiny capacity makes both sides wait constantly
+    TypeParam ch(2);
+
+    std::thread producer([&ch]() {
+        for (int i = 0; i < max; i++) { EXPECT_TRUE(ch.push(i)); }
+        ch.close();
+    });
+
+    int expected = 0;
+    while (const auto value = ch.pop()) {
+        EXPECT_EQ(value.value(), expected);
+        expected++;
+    }
+    EXPECT_EQ(expected, max);
+
+    producer.join();
+}
+
+TYPED_TEST(WaitPolicy, CloseWakesWaitingReceiver)
+{
+    TypeParam ch(2);
+
+    std::thread receiver([&ch]() { EXPECT_FALSE(ch.pop().has_value()); });
+
+    ch.close();
+    receiver.join();
+}
+
+TEST(WaitPolicy, UnboundedPark)
+{
+    constexpr static int max = 20000;
+
+    nrws::channel<int, nrws::park_wait> ch;
+
+    std::thread producer([&ch]() {
+        for (int i = 0; i < max; i++) { ch.push(i); }
+        ch.close();
+    });
+
+    int expected = 0;
+    while (const auto value = ch.pop()) {
+        EXPECT_EQ(value.value(), expected);
+        expected++;
+    }
+    EXPECT_EQ(expected, max);
+
+    producer.join();
+}
+
+TEST(WaitPolicy, SenderReceiverWithPolicy)
+{
+    using namespace nrws;
+
+    auto [s, r] = bounded<int, yield_array_channel>(4U);
+
+    std::thread producer([&s]() {
+        for (int i = 0; i < 100; i++) { EXPECT_TRUE(s.send(i).has_value()); }
+        s.close();
+    });
+
+    int expected = 0;
+    for (const auto actual : r) {
+        EXPECT_EQ(actual, expected);
+        expected++;
+    }
+    EXPECT_EQ(expected, 100);
+
+    producer.join();
+}
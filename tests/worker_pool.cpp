@@ -0,0 +1,171 @@
+#include "narrows/worker_pool.hpp"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+TEST(WorkDeque, OwnerIsLifo)
+{
+    nrws::_work_deque<int> deque(4);
+    EXPECT_EQ(deque.capacity(), 4U);
+
+    for (int i = 0; i < 4; i++) { EXPECT_TRUE(deque.push(i)); }
+    EXPECT_FALSE(deque.push(4));
+    EXPECT_EQ(deque.size(), 4U);
+
+    EXPECT_EQ(deque.pop(), 3);
+    EXPECT_EQ(deque.steal(), 0);
+    EXPECT_EQ(deque.pop(), 2);
+    EXPECT_EQ(deque.pop(), 1);
+    EXPECT_FALSE(deque.pop().has_value());
+    EXPECT_FALSE(deque.steal().has_value());
+}
+
+TEST(WorkDeque, ThievesAndOwnerTakeEverythingOnce)
+{
+    constexpr static int max = 100'000;
+    constexpr static int thieves = 3;
+
+    nrws::_work_deque<std::unique_ptr<int>> deque(64);
+    std::vector<std::atomic<int>> seen(max);
+    std::atomic<bool> done{ false };
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thieves; t++) {
+        threads.emplace_back([&]() {
+            while (!done.load() || !deque.empty()) {
+                if (auto value = deque.steal()) { seen[static_cast<std::size_t>(**value)]++; }
+            }
+        });
+    }
+
+    for (int i = 0; i < max; i++) {
+        while (!deque.push(std::make_unique<int>(i))) {
+            if (auto value = deque.pop()) { seen[static_cast<std::size_t>(**value)]++; }
+        }
+        if (i % 3 == 0) {
+            if (auto value = deque.pop()) { seen[static_cast<std::size_t>(**value)]++; }
+        }
+    }
+    while (auto value = deque.pop()) { seen[static_cast<std::size_t>(**value)]++; }
+
+    done = true;
+    for (auto &thread : threads) { thread.join(); }
+
+    for (const auto &count : seen) { EXPECT_EQ(count.load(), 1); }
+}
+
+TEST(WorkerPool, Submit)
+{
+    constexpr static int max = 20'000;
+
+    std::atomic<long long> sum{ 0 };
+    {
+        nrws::worker_pool<int> pool([&sum](int &&value) { sum += value; }, 4U, 256U);
+        EXPECT_EQ(pool.size(), 4U);
+        for (int i = 1; i <= max; i++) { EXPECT_TRUE(pool.submit(i).has_value()); }
+    }
+
+    EXPECT_EQ(sum.load(), static_cast<long long>(max) * (max + 1) / 2);
+}
+
+TEST(WorkerPool, DrainsAReceiver)
+{
+    using namespace nrws;
+
+    constexpr static int max = 10'000;
+
+    auto [s, r] = bounded<int, array_channel>(128);
+    std::atomic<int> count{ 0 };
+    {
+        worker_pool<int, Receiver<int, array_channel>> pool(r, [&count](int &&) { count++; }, 3U);
+        EXPECT_EQ(pool.submit(1).error(), sender_error_t::ChannelClosed);
+
+        for (int i = 0; i < max; i++) { EXPECT_TRUE(s.send(i).has_value()); }
+        s.close();
+        pool.join();
+    }
+
+    EXPECT_EQ(count.load(), max);
+}
+
+TEST(WorkerPool, IdleWorkersStealBacklog)
+{
+    // one slow batch must not hold up the rest while other workers are free
+    std::atomic<int> handled{ 0 };
+    std::set<std::thread::id> threads;
+    std::mutex threads_mutex;
+
+    {
+        nrws::worker_pool<int> pool(
+            [&](int &&) {
+                std::this_thread::sleep_for(1ms);
+                {
+                    std::lock_guard lock{ threads_mutex };
+                    threads.insert(std::this_thread::get_id());
+                }
+                handled++;
+            },
+            4U,
+            64U,
+            64U);
+
+        for (int i = 0; i < 64; i++) { EXPECT_TRUE(pool.submit(i).has_value()); }
+    }
+
+    EXPECT_EQ(handled.load(), 64);
+    EXPECT_GT(threads.size(), 1U);
+}
+
+TEST(WorkerPool, HandlerSubmitsMoreWork)
+{
+    using namespace nrws;
+
+    // every value below the limit spawns two more, the handler sends while the pool is receiving
+    constexpr static int depth = 10;
+
+    auto [s, r] = bounded<int, bounded_channel>(4096);
+    std::atomic<int> handled{ 0 };
+    std::atomic<int> pending{ 1 };
+    {
+        worker_pool<int, Receiver<int, bounded_channel>> pool(
+            r,
+            [&, sender = s](int &&level) mutable {
+                if (level < depth) {
+                    pending += 2;
+                    EXPECT_TRUE(sender.send(level + 1).has_value());
+                    EXPECT_TRUE(sender.send(level + 1).has_value());
+                }
+                handled++;
+                if (--pending == 0) { sender.close(); }
+            },
+            4U,
+            8U);
+
+        EXPECT_TRUE(s.send(0).has_value());
+        pool.join();
+    }
+
+    EXPECT_EQ(handled.load(), (1 << (depth + 1)) - 1);
+}
+
+TEST(WorkerPool, IdleWorkersPark)
+{
+    nrws::worker_pool<int> pool([](int &&) {}, 8U);
+    EXPECT_TRUE(pool.submit(1).has_value());
+    std::this_thread::sleep_for(20ms);
+
+    // a worker polling the channel would keep waking up while there is nothing to do
+    const auto start = std::clock();
+    std::this_thread::sleep_for(200ms);
+    EXPECT_LT(std::clock() - start, CLOCKS_PER_SEC / 500);
+}
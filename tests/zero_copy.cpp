@@ -0,0 +1,284 @@
+#include "narrows/bounded.hpp"
+#include "narrows/single_bounded.hpp"
+#include "narrows/unbounded.hpp"
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <ctime>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Counts how often it gets copied or moved
+struct packet
+{
+    static inline std::atomic<int> copies{ 0 };
+    static inline std::atomic<int> moves{ 0 };
+
+    int id{ 0 };
+    std::array<std::byte, 1024> payload{};
+
+    packet() = default;
+    explicit packet(const int packet_id) : id(packet_id) {}
+    packet(const packet &other) : id(other.id), payload(other.payload) { copies++; }
+    packet(packet &&other) noexcept : id(other.id), payload(other.payload) { moves++; }
+    packet &operator=(const packet &other)
+    {
+        id = other.id;
+        payload = other.payload;
+        copies++;
+        return *this;
+    }
+    packet &operator=(packet &&other) noexcept
+    {
+        id = other.id;
+        payload = other.payload;
+        moves++;
+        return *this;
+    }
+    ~packet() = default;
+
+    static auto reset() -> void
+    {
+        copies = 0;
+        moves = 0;
+    }
+};
+
+template<typename Channel>
+auto make_channel() -> Channel
+{
+    if constexpr (std::constructible_from<Channel, std::size_t>) {
+        return Channel(4U);
+    } else {
+        return Channel();
+    }
+}
+
+}// namespace
+
+template<typename Channel>
+class ZeroCopy : public ::testing::Test
+{
+};
+
+using ZeroCopyChannels = ::testing::Types<nrws::bounded_channel<packet>,
+    nrws::array_channel<packet>,
+    nrws::_spsc_ring<packet>,
+    nrws::list_channel<packet>>;
+TYPED_TEST_SUITE(ZeroCopy, ZeroCopyChannels);
+
+TYPED_TEST(ZeroCopy, EmplaceAndPopRefNeverCopy)
+{
+    auto ch = make_channel<TypeParam>();
+    packet::reset();
+
+    EXPECT_TRUE(ch.emplace(7));
+    {
+        auto ref = ch.pop_ref();
+        ASSERT_TRUE(ref.has_value());
+        EXPECT_EQ((*ref)->id, 7);
+    }
+
+    EXPECT_EQ(packet::copies.load(), 0);
+    EXPECT_EQ(packet::moves.load(), 0);
+    EXPECT_TRUE(ch.empty());
+}
+
+TYPED_TEST(ZeroCopy, ReserveCommit)
+{
+    auto ch = make_channel<TypeParam>();
+
+    {
+        auto slot = ch.reserve(1);
+        ASSERT_TRUE(slot.has_value());
+        (*slot)->payload[0] = std::byte{ 42 };
+        slot->commit();
+    }
+    EXPECT_FALSE(ch.empty());
+
+    // a slot that goes away is committed as well
+    {
+        auto slot = ch.reserve(2);
+        ASSERT_TRUE(slot.has_value());
+    }
+
+    auto first = ch.pop();
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(first->id, 1);
+    EXPECT_EQ(first->payload[0], std::byte{ 42 });
+
+    auto second = ch.pop_ref();
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ((*second)->id, 2);
+    second->release();
+    EXPECT_TRUE(ch.empty());
+}
+
+TYPED_TEST(ZeroCopy, ClosedChannel)
+{
+    auto ch = make_channel<TypeParam>();
+    EXPECT_TRUE(ch.emplace(1));
+    ch.close();
+
+    EXPECT_FALSE(ch.reserve(2).has_value());
+    EXPECT_FALSE(ch.emplace(2));
+
+    EXPECT_EQ((*ch.pop_ref())->id, 1);
+    EXPECT_FALSE(ch.pop_ref().has_value());
+}
+
+TYPED_TEST(ZeroCopy, ReserveAndPopRefThreads)
+{
+    constexpr static int max = 2000;
+
+    auto ch = make_channel<TypeParam>();
+
+    std::thread producer([&ch]() {
+        for (int i = 0; i < max; i++) {
+            auto slot = ch.reserve(i);
+            ASSERT_TRUE(slot.has_value());
+            (*slot)->payload[1] = static_cast<std::byte>(i & 0xff);
+        }
+        ch.close();
+    });
+
+    int expected = 0;
+    while (auto ref = ch.pop_ref()) {
+        EXPECT_EQ((*ref)->id, expected);
+        EXPECT_EQ((*ref)->payload[1], static_cast<std::byte>(expected & 0xff));
+        expected++;
+    }
+    EXPECT_EQ(expected, max);
+
+    producer.join();
+}
+
+TEST(ZeroCopy, SenderReceiver)
+{
+    using namespace nrws;
+
+    auto [s, r] = bounded<packet, array_channel>(4U);
+    packet::reset();
+
+    EXPECT_TRUE(s.emplace(1).has_value());
+    {
+        auto slot = s.reserve(2);
+        ASSERT_TRUE(slot.has_value());
+        (*slot)->payload[0] = std::byte{ 9 };
+    }
+
+    {
+        auto ref = r.receive_ref();
+        ASSERT_TRUE(ref.has_value());
+        EXPECT_EQ((*ref)->id, 1);
+    }
+    {
+        auto ref = r.receive_ref();
+        ASSERT_TRUE(ref.has_value());
+        EXPECT_EQ((*ref)->id, 2);
+        EXPECT_EQ((*ref)->payload[0], std::byte{ 9 });
+    }
+    EXPECT_EQ(packet::copies.load(), 0);
+    EXPECT_EQ(packet::moves.load(), 0);
+
+    s.close();
+    const auto closed = r.receive_ref();
+    ASSERT_FALSE(closed.has_value());
+    EXPECT_EQ(closed.error(), receiver_error_t::ChannelClosed);
+
+    const auto status = s.reserve(3);
+    ASSERT_FALSE(status.has_value());
+    EXPECT_EQ(status.error(), sender_error_t::ChannelClosed);
+}
+
+template<typename Channel>
+class HeldGuard : public ::testing::Test
+{
+};
+
+using HeldGuardChannels = ::testing::Types<nrws::bounded_channel<int, nrws::instrumented<>>,
+    nrws::array_channel<int, nrws::instrumented<>>,
+    nrws::_spsc_ring<int, nrws::instrumented<>>,
+    nrws::list_channel<int, nrws::instrumented<>>>;
+TYPED_TEST_SUITE(HeldGuard, HeldGuardChannels);
+
+TYPED_TEST(HeldGuard, ReservedSlotKeepsReceiverParked)
+{
+    auto ch = make_channel<TypeParam>();
+
+    auto slot = ch.reserve(1);
+    ASSERT_TRUE(slot.has_value());
+
+    const auto start = std::clock();
+    std::thread receiver([&ch]() { EXPECT_EQ(ch.pop(), 1); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    // a receiver spinning on the uncommitted slot would burn the whole time, and count a wait
+    // per round when it spins through the waiter set
+    EXPECT_LT(std::clock() - start, CLOCKS_PER_SEC / 40);
+    EXPECT_LE(ch.stats().blocked_receives, 2U);
+
+    slot->commit();
+    receiver.join();
+}
+
+TYPED_TEST(HeldGuard, ValuesBehindReservedSlotWakeEveryReceiver)
+{
+    // only lock-free channels with several producers let others send while a slot is reserved
+    if constexpr (std::same_as<TypeParam, nrws::array_channel<int, nrws::instrumented<>>>
+                  || std::same_as<TypeParam, nrws::list_channel<int, nrws::instrumented<>>>) {
+        auto ch = make_channel<TypeParam>();
+
+        auto slot = ch.reserve(1);
+        ASSERT_TRUE(slot.has_value());
+
+        std::atomic<int> received{ 0 };
+        std::vector<std::thread> receivers;
+        for (int i = 0; i < 2; i++) {
+            receivers.emplace_back([&ch, &received]() {
+                if (ch.pop().has_value()) { received++; }
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+        // wakes a receiver for a value it can't get to yet
+        std::thread([&ch]() { EXPECT_TRUE(ch.push(2)); }).join();
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+        slot->commit();
+        for (int i = 0; i < 100 && received < 2; i++) { std::this_thread::sleep_for(std::chrono::milliseconds(10)); }
+        EXPECT_EQ(received.load(), 2);
+
+        ch.close();
+        for (auto &receiver : receivers) { receiver.join(); }
+    }
+}
+
+TYPED_TEST(HeldGuard, ReadSlotKeepsSenderParked)
+{
+    auto ch = make_channel<TypeParam>();
+
+    // only a bounded channel makes senders wait
+    if constexpr (requires { ch.capacity(); }) {
+        for (int i = 0; i < 4; i++) { EXPECT_TRUE(ch.push(i)); }
+
+        auto ref = ch.pop_ref();
+        ASSERT_TRUE(ref.has_value());
+
+        const auto start = std::clock();
+        std::thread sender([&ch]() { EXPECT_TRUE(ch.push(4)); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+        EXPECT_LT(std::clock() - start, CLOCKS_PER_SEC / 40);
+        EXPECT_LE(ch.stats().blocked_sends, 2U);
+
+        ref->release();
+        sender.join();
+    }
+}